@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Arena allocation of temporaries
+//
+// An arena hands out memory by bumping an offset through large 64-byte
+// aligned blocks and never frees a single allocation: an arena_scope records
+// the position on entry and rewinds to it on exit, and reset() empties the
+// whole arena. Blocks are kept when rewinding, and reset() merges them into
+// a single block of their total size, so once an arena has served its
+// largest pass it does not touch the heap any more. Nothing is destroyed on
+// rewind, so only trivially destructible elements can live in an arena.
+//
+// dyn_vec and dyn_mat, the dyn products and the factorizations of
+// 01_corr_matvec_solve accept an arena for their storage; such objects must
+// not outlive the scope they were created in (a plain copy of them goes back
+// to the heap).
+//
+// The dense storage of the library (dyn_vec / dyn_mat, batches, the GEMM
+// packing buffers) and the arenas, blocks and block list, take their memory
+// from detail::heap_allocate, which counts allocations per thread:
+// count_allocations(f) reports those made while f runs. Sparse matrices, file
+// I/O and thread_pool use the standard allocator and are not counted.
+
+// Heap allocations made by the current thread
+struct allocation_stats {
+	std::size_t allocations = 0;
+	std::size_t bytes = 0;
+};
+
+namespace detail {
+
+inline constexpr std::size_t storage_alignment = 64;
+
+constexpr std::size_t pad_to(std::size_t x, std::size_t r) {
+	return (x + r - 1) / r * r;
+}
+
+inline thread_local allocation_stats heap_stats;
+
+// bytes bytes, 64-byte aligned, counted in heap_stats
+inline void* heap_allocate(std::size_t bytes) {
+	++heap_stats.allocations;
+	heap_stats.bytes += bytes;
+	return ::operator new(bytes, std::align_val_t{storage_alignment});
+}
+
+inline void heap_release(void* p) {
+	::operator delete(p, std::align_val_t{storage_alignment});
+}
+
+// Standard allocator over heap_allocate, for the containers of the library
+template <typename T> struct heap_allocator {
+	using value_type = T;
+
+	heap_allocator() = default;
+	template <typename U> heap_allocator(const heap_allocator<U>&) {}
+
+	T* allocate(std::size_t count) { return static_cast<T*>(heap_allocate(count * sizeof(T))); }
+	void deallocate(T* p, std::size_t) { heap_release(p); }
+
+	template <typename U> bool operator==(const heap_allocator<U>&) const { return true; }
+};
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// Allocation counters
+//------------------------------------------------------------------------------
+
+// Allocations made by this thread since construction
+class allocation_counter {
+	public:
+	allocation_counter() : start(detail::heap_stats) {}
+
+	allocation_stats stats() const {
+		return {detail::heap_stats.allocations - start.allocations, detail::heap_stats.bytes - start.bytes};
+	}
+
+	private:
+	allocation_stats start;
+};
+
+// Allocations made by f()
+template <typename F> allocation_stats count_allocations(F&& f) {
+	const allocation_counter counter;
+	std::forward<F>(f)();
+	return counter.stats();
+}
+
+//------------------------------------------------------------------------------
+// arena
+//------------------------------------------------------------------------------
+
+class arena {
+	public:
+	// Position to rewind to
+	struct marker {
+		std::size_t block = 0;
+		std::size_t offset = 0;
+	};
+
+	// Smallest block taken from the heap
+	static constexpr std::size_t min_block = 64 * 1024;
+
+	arena() = default;
+
+	// Reserves a first block of at least bytes bytes
+	explicit arena(std::size_t bytes) { add_block(bytes); }
+
+	arena(const arena&) = delete;
+	arena& operator=(const arena&) = delete;
+
+	arena(arena&& other) noexcept
+		: blocks_(std::move(other.blocks_)), current_(std::exchange(other.current_, 0)),
+		  offset_(std::exchange(other.offset_, 0)) {
+		other.blocks_.clear();
+	}
+
+	arena& operator=(arena&& other) noexcept {
+		std::swap(blocks_, other.blocks_);
+		std::swap(current_, other.current_);
+		std::swap(offset_, other.offset_);
+		return *this;
+	}
+
+	~arena() { release(); }
+
+	//--------------------------------------------------------------------------
+	// Allocation
+	//--------------------------------------------------------------------------
+
+	// bytes bytes aligned on alignment (a power of two, at most 64)
+	void* allocate_bytes(std::size_t bytes, std::size_t alignment = detail::storage_alignment) {
+		assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && alignment <= detail::storage_alignment
+		       && "arena alignment");
+		for (; current_ < blocks_.size(); ++current_, offset_ = 0) {
+			const std::size_t start = detail::pad_to(offset_, alignment);
+			if (start + bytes <= blocks_[current_].size) {
+				offset_ = start + bytes;
+				return blocks_[current_].data + start;
+			}
+		}
+		add_block(std::max(bytes, blocks_.empty() ? 0 : 2 * blocks_.back().size));
+		current_ = blocks_.size() - 1;
+		offset_ = bytes;
+		return blocks_.back().data;
+	}
+
+	// count value-initialized elements, 64-byte aligned
+	template <typename T> T* allocate(std::size_t count) {
+		static_assert(std::is_trivially_destructible_v<T>, "arena elements are never destroyed");
+		if (count == 0) {
+			return nullptr;
+		}
+		T* p = static_cast<T*>(allocate_bytes(count * sizeof(T)));
+		std::uninitialized_value_construct_n(p, count);
+		return p;
+	}
+
+	//--------------------------------------------------------------------------
+	// Rewinding
+	//--------------------------------------------------------------------------
+
+	marker mark() const { return {current_, offset_}; }
+
+	// Frees everything allocated since m was taken
+	void rewind(marker m) {
+		assert((m.block < current_ || (m.block == current_ && m.offset <= offset_)) && "rewind past the top");
+		current_ = m.block;
+		offset_ = m.offset;
+	}
+
+	// Frees everything, and merges the blocks so that the next pass of the
+	// same size fits in one
+	void reset() {
+		if (blocks_.size() > 1) {
+			const std::size_t total = capacity();
+			release();
+			add_block(total);
+		}
+		current_ = 0;
+		offset_ = 0;
+	}
+
+	//--------------------------------------------------------------------------
+	// Statistics
+	//--------------------------------------------------------------------------
+
+	// Bytes up to the current position, alignment and skipped block ends included
+	std::size_t used() const {
+		std::size_t total = offset_;
+		for (std::size_t b = 0; b < current_ && b < blocks_.size(); ++b) {
+			total += blocks_[b].size;
+		}
+		return total;
+	}
+
+	std::size_t capacity() const {
+		std::size_t total = 0;
+		for (const block& b : blocks_) {
+			total += b.size;
+		}
+		return total;
+	}
+
+	std::size_t blocks() const { return blocks_.size(); }
+
+	private:
+	struct block {
+		std::byte* data;
+		std::size_t size;
+	};
+
+	void add_block(std::size_t bytes) {
+		const std::size_t size = detail::pad_to(std::max(bytes, min_block), detail::storage_alignment);
+		blocks_.push_back({static_cast<std::byte*>(detail::heap_allocate(size)), size});
+	}
+
+	void release() {
+		for (const block& b : blocks_) {
+			detail::heap_release(b.data);
+		}
+		blocks_.clear();
+	}
+
+	std::vector<block, detail::heap_allocator<block>> blocks_;
+	std::size_t current_ = 0;
+	std::size_t offset_ = 0;
+};
+
+// Rewinds an arena to its position at construction
+class arena_scope {
+	public:
+	explicit arena_scope(arena& a) : ws(a), start(a.mark()) {}
+	~arena_scope() { ws.rewind(start); }
+
+	arena_scope(const arena_scope&) = delete;
+	arena_scope& operator=(const arena_scope&) = delete;
+
+	private:
+	arena& ws;
+	arena::marker start;
+};
+
+namespace detail {
+
+// Per-thread arena for the internal temporaries of the library routines
+inline arena& scratch_arena() {
+	thread_local arena ws;
+	return ws;
+}
+
+// Value-initialized, 64-byte aligned array of T, owned or borrowed from an arena
+template <typename T> class aligned_buffer {
+	public:
+	aligned_buffer() = default;
+
+	explicit aligned_buffer(std::size_t count) : size_(count), owned_(count != 0) {
+		if (count != 0) {
+			data_ = static_cast<T*>(heap_allocate(count * sizeof(T)));
+			std::uninitialized_value_construct_n(data_, count);
+		}
+	}
+
+	// Released with the arena, not by the destructor
+	aligned_buffer(std::size_t count, arena& ws) : data_(ws.allocate<T>(count)), size_(count) {}
+
+	aligned_buffer(const aligned_buffer& other) : aligned_buffer(other.size_) {
+		std::copy_n(other.data_, size_, data_);
+	}
+
+	aligned_buffer(aligned_buffer&& other) noexcept
+		: data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+		  owned_(std::exchange(other.owned_, false)) {}
+
+	aligned_buffer& operator=(aligned_buffer other) noexcept {
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+		std::swap(owned_, other.owned_);
+		return *this;
+	}
+
+	~aligned_buffer() {
+		if (owned_) {
+			std::destroy_n(data_, size_);
+			heap_release(data_);
+		}
+	}
+
+	T* data() { return data_; }
+	const T* data() const { return data_; }
+	std::size_t size() const { return size_; }
+
+	private:
+	T* data_ = nullptr;
+	std::size_t size_ = 0;
+	bool owned_ = false;
+};
+
+} // namespace detail
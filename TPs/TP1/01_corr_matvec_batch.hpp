@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+#include "01_corr_matvec_simd.hpp"
+
+// Batched small-matrix operations
+//
+// mat_batch<T, M, N> holds count matrices in structure-of-arrays layout:
+// element (i, j) of every matrix is stored contiguously, in lane(i, j). A
+// batched operation then applies the scalar formula once per element, with
+// one SIMD register covering W different matrices, instead of one call (and
+// a few partially filled registers) per matrix. Lane arrays are padded to a
+// full cache line so the kernels never need a scalar tail; padding lanes
+// hold zeros and their results are ignored.
+
+namespace detail {
+
+// Number of matrices processed per pass, so that the lanes touched by one
+// pass of a 4x4 kernel stay in L1
+inline constexpr std::size_t batch_chunk = 256;
+
+// W matrices' worth of one element, with arithmetic operators forwarding to
+// simd::reg (or to plain T on the scalar fallback)
+template <typename T> struct lane_pack {
+	using reg = simd::reg_or_scalar<T>;
+	static constexpr std::size_t width = reg::width;
+
+	static lane_pack set1(T x) { return {reg::set1(x)}; }
+	static lane_pack load(const T* p) { return {reg::load(p)}; }
+	void store(T* p) const { reg::store(p, v); }
+
+	friend lane_pack operator+(lane_pack a, lane_pack b) { return {reg::add(a.v, b.v)}; }
+	friend lane_pack operator-(lane_pack a, lane_pack b) { return {reg::sub(a.v, b.v)}; }
+	friend lane_pack operator*(lane_pack a, lane_pack b) { return {reg::mul(a.v, b.v)}; }
+	friend lane_pack operator/(lane_pack a, lane_pack b) { return {reg::div(a.v, b.v)}; }
+	friend lane_pack fma(lane_pack a, lane_pack b, lane_pack c) { return {reg::fma(a.v, b.v, c.v)}; }
+
+	typename reg::type v;
+};
+
+// x broadcast to a scalar type or to a lane_pack
+template <typename V, typename T> V splat(T x) {
+	if constexpr (std::is_arithmetic_v<V>) {
+		return static_cast<V>(x);
+	} else {
+		return V::set1(x);
+	}
+}
+
+// Closed-form inverse of an N x N matrix (N = 2, 3, 4) stored row-major in
+// a, written to b. V is either a scalar type or a lane_pack, so the same
+// cofactor expansion serves single matrices and whole batches.
+template <std::size_t N, typename V> void small_inverse(const V* a, V* b) {
+	static_assert(N >= 2 && N <= 4, "closed-form inverse only for 2x2, 3x3 and 4x4");
+	if constexpr (N == 2) {
+		const V inv = splat<V>(1) / (a[0] * a[3] - a[1] * a[2]);
+		const V neg = splat<V>(0) - inv;
+		b[0] = a[3] * inv;
+		b[1] = a[1] * neg;
+		b[2] = a[2] * neg;
+		b[3] = a[0] * inv;
+	} else if constexpr (N == 3) {
+		const V c00 = a[4] * a[8] - a[5] * a[7];
+		const V c01 = a[5] * a[6] - a[3] * a[8];
+		const V c02 = a[3] * a[7] - a[4] * a[6];
+		const V inv = splat<V>(1) / (a[0] * c00 + a[1] * c01 + a[2] * c02);
+		b[0] = c00 * inv;
+		b[1] = (a[2] * a[7] - a[1] * a[8]) * inv;
+		b[2] = (a[1] * a[5] - a[2] * a[4]) * inv;
+		b[3] = c01 * inv;
+		b[4] = (a[0] * a[8] - a[2] * a[6]) * inv;
+		b[5] = (a[2] * a[3] - a[0] * a[5]) * inv;
+		b[6] = c02 * inv;
+		b[7] = (a[1] * a[6] - a[0] * a[7]) * inv;
+		b[8] = (a[0] * a[4] - a[1] * a[3]) * inv;
+	} else {
+		// 2x2 minors of the top two rows (s) and of the bottom two rows (c)
+		const V s0 = a[0] * a[5] - a[4] * a[1];
+		const V s1 = a[0] * a[6] - a[4] * a[2];
+		const V s2 = a[0] * a[7] - a[4] * a[3];
+		const V s3 = a[1] * a[6] - a[5] * a[2];
+		const V s4 = a[1] * a[7] - a[5] * a[3];
+		const V s5 = a[2] * a[7] - a[6] * a[3];
+		const V c5 = a[10] * a[15] - a[14] * a[11];
+		const V c4 = a[9] * a[15] - a[13] * a[11];
+		const V c3 = a[9] * a[14] - a[13] * a[10];
+		const V c2 = a[8] * a[15] - a[12] * a[11];
+		const V c1 = a[8] * a[14] - a[12] * a[10];
+		const V c0 = a[8] * a[13] - a[12] * a[9];
+		const V inv = splat<V>(1) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+		b[0] = (a[5] * c5 - a[6] * c4 + a[7] * c3) * inv;
+		b[1] = (a[2] * c4 - a[1] * c5 - a[3] * c3) * inv;
+		b[2] = (a[13] * s5 - a[14] * s4 + a[15] * s3) * inv;
+		b[3] = (a[10] * s4 - a[9] * s5 - a[11] * s3) * inv;
+		b[4] = (a[6] * c2 - a[4] * c5 - a[7] * c1) * inv;
+		b[5] = (a[0] * c5 - a[2] * c2 + a[3] * c1) * inv;
+		b[6] = (a[14] * s2 - a[12] * s5 - a[15] * s1) * inv;
+		b[7] = (a[8] * s5 - a[10] * s2 + a[11] * s1) * inv;
+		b[8] = (a[4] * c4 - a[5] * c2 + a[7] * c0) * inv;
+		b[9] = (a[1] * c2 - a[0] * c4 - a[3] * c0) * inv;
+		b[10] = (a[12] * s4 - a[13] * s2 + a[15] * s0) * inv;
+		b[11] = (a[9] * s2 - a[8] * s4 - a[11] * s0) * inv;
+		b[12] = (a[5] * c1 - a[4] * c3 - a[6] * c0) * inv;
+		b[13] = (a[0] * c3 - a[1] * c1 + a[2] * c0) * inv;
+		b[14] = (a[13] * s1 - a[12] * s3 - a[14] * s0) * inv;
+		b[15] = (a[8] * s3 - a[9] * s1 + a[10] * s0) * inv;
+	}
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// mat_batch / vec_batch
+//------------------------------------------------------------------------------
+
+template <typename T, std::size_t M, std::size_t N> class mat_batch {
+	public:
+	using value_type = T;
+
+	static constexpr std::size_t m() { return M; }
+	static constexpr std::size_t n() { return N; }
+
+	explicit mat_batch(std::size_t count)
+		: count_(count), stride_(detail::pad_to(count, detail::aligned_elements<T>)), storage(M * N * stride_) {}
+
+	// Scatters the matrices into SoA layout
+	explicit mat_batch(std::span<const mat<T, M, N>> ms) : mat_batch(ms.size()) {
+		for (std::size_t b = 0; b < count_; ++b) {
+			for (std::size_t k = 0; k < M * N; ++k) {
+				storage.data()[k * stride_ + b] = ms[b].data[k];
+			}
+		}
+	}
+
+	std::size_t size() const { return count_; }
+	std::size_t stride() const { return stride_; }
+
+	// Element (i, j) of every matrix, stride() entries of which size() are used
+	T* lane(std::size_t i, std::size_t j) { return storage.data() + (i * N + j) * stride_; }
+	const T* lane(std::size_t i, std::size_t j) const { return storage.data() + (i * N + j) * stride_; }
+
+	T& operator()(std::size_t b, std::size_t i, std::size_t j) { return lane(i, j)[b]; }
+	T operator()(std::size_t b, std::size_t i, std::size_t j) const { return lane(i, j)[b]; }
+
+	mat<T, M, N> get(std::size_t b) const {
+		assert(b < count_ && "mat_batch index out of range");
+		mat<T, M, N> result;
+		for (std::size_t k = 0; k < M * N; ++k) {
+			result.data[k] = storage.data()[k * stride_ + b];
+		}
+		return result;
+	}
+
+	void set(std::size_t b, const mat<T, M, N>& A) {
+		assert(b < count_ && "mat_batch index out of range");
+		for (std::size_t k = 0; k < M * N; ++k) {
+			storage.data()[k * stride_ + b] = A.data[k];
+		}
+	}
+
+	// Gathers the matrices back into array-of-structures layout
+	void unpack(std::span<mat<T, M, N>> out) const {
+		assert(out.size() == count_ && "mat_batch size mismatch");
+		for (std::size_t b = 0; b < count_; ++b) {
+			out[b] = get(b);
+		}
+	}
+
+	private:
+	std::size_t count_;
+	std::size_t stride_;
+	detail::aligned_buffer<T> storage;
+};
+
+template <typename T, std::size_t N> class vec_batch {
+	public:
+	using value_type = T;
+
+	static constexpr std::size_t dim() { return N; }
+
+	explicit vec_batch(std::size_t count)
+		: count_(count), stride_(detail::pad_to(count, detail::aligned_elements<T>)), storage(N * stride_) {}
+
+	explicit vec_batch(std::span<const vec<T, N>> vs) : vec_batch(vs.size()) {
+		for (std::size_t b = 0; b < count_; ++b) {
+			for (std::size_t i = 0; i < N; ++i) {
+				storage.data()[i * stride_ + b] = vs[b][i];
+			}
+		}
+	}
+
+	std::size_t size() const { return count_; }
+	std::size_t stride() const { return stride_; }
+
+	// Component i of every vector
+	T* lane(std::size_t i) { return storage.data() + i * stride_; }
+	const T* lane(std::size_t i) const { return storage.data() + i * stride_; }
+
+	T& operator()(std::size_t b, std::size_t i) { return lane(i)[b]; }
+	T operator()(std::size_t b, std::size_t i) const { return lane(i)[b]; }
+
+	vec<T, N> get(std::size_t b) const {
+		assert(b < count_ && "vec_batch index out of range");
+		vec<T, N> result;
+		for (std::size_t i = 0; i < N; ++i) {
+			result[i] = storage.data()[i * stride_ + b];
+		}
+		return result;
+	}
+
+	void set(std::size_t b, const vec<T, N>& x) {
+		assert(b < count_ && "vec_batch index out of range");
+		for (std::size_t i = 0; i < N; ++i) {
+			storage.data()[i * stride_ + b] = x[i];
+		}
+	}
+
+	void unpack(std::span<vec<T, N>> out) const {
+		assert(out.size() == count_ && "vec_batch size mismatch");
+		for (std::size_t b = 0; b < count_; ++b) {
+			out[b] = get(b);
+		}
+	}
+
+	private:
+	std::size_t count_;
+	std::size_t stride_;
+	detail::aligned_buffer<T> storage;
+};
+
+//------------------------------------------------------------------------------
+// Batched operations
+//
+// The output-parameter forms reuse the caller's storage, so a per-frame
+// update does not allocate. Outputs must not alias inputs.
+//------------------------------------------------------------------------------
+
+// y[b] = A[b] * x[b]
+template <typename T, std::size_t M, std::size_t N>
+void multiply(const mat_batch<T, M, N>& A, const vec_batch<T, N>& x, vec_batch<T, M>& y) {
+	assert(A.size() == x.size() && A.size() == y.size() && "batch size mismatch");
+	using P = detail::lane_pack<T>;
+	const T* a[M * N];
+	const T* xs[N];
+	T* ys[M];
+	for (std::size_t i = 0; i < M; ++i) {
+		ys[i] = y.lane(i);
+		for (std::size_t j = 0; j < N; ++j) {
+			a[i * N + j] = A.lane(i, j);
+		}
+	}
+	for (std::size_t j = 0; j < N; ++j) {
+		xs[j] = x.lane(j);
+	}
+
+	// One register of x per component, reused across the M rows
+	for (std::size_t b = 0; b < A.stride(); b += P::width) {
+		P xb[N];
+		#pragma GCC unroll 4
+		for (std::size_t j = 0; j < N; ++j) {
+			xb[j] = P::load(xs[j] + b);
+		}
+		#pragma GCC unroll 4
+		for (std::size_t i = 0; i < M; ++i) {
+			P acc = P::load(a[i * N] + b) * xb[0];
+			#pragma GCC unroll 4
+			for (std::size_t j = 1; j < N; ++j) {
+				acc = fma(P::load(a[i * N + j] + b), xb[j], acc);
+			}
+			acc.store(ys[i] + b);
+		}
+	}
+}
+
+// C[b] = A[b] * B[b]
+template <typename T, std::size_t M, std::size_t N, std::size_t K>
+void multiply(const mat_batch<T, M, N>& A, const mat_batch<T, N, K>& B, mat_batch<T, M, K>& C) {
+	assert(A.size() == B.size() && A.size() == C.size() && "batch size mismatch");
+	using P = detail::lane_pack<T>;
+	const std::size_t count = A.stride();
+	for (std::size_t b0 = 0; b0 < count; b0 += detail::batch_chunk) {
+		const std::size_t b1 = std::min(count, b0 + detail::batch_chunk);
+		for (std::size_t i = 0; i < M; ++i) {
+			for (std::size_t j = 0; j < K; ++j) {
+				for (std::size_t b = b0; b < b1; b += P::width) {
+					P acc = P::load(A.lane(i, 0) + b) * P::load(B.lane(0, j) + b);
+					#pragma GCC unroll 4
+					for (std::size_t k = 1; k < N; ++k) {
+						acc = fma(P::load(A.lane(i, k) + b), P::load(B.lane(k, j) + b), acc);
+					}
+					acc.store(C.lane(i, j) + b);
+				}
+			}
+		}
+	}
+}
+
+// out[b] = A[b]^-1, by cofactors. Singular matrices give inf/nan entries.
+template <typename T, std::size_t N>
+void inverse(const mat_batch<T, N, N>& A, mat_batch<T, N, N>& out) {
+	static_assert(std::is_floating_point_v<T>, "batched inverse needs a floating-point type");
+	assert(A.size() == out.size() && "batch size mismatch");
+	using P = detail::lane_pack<T>;
+	for (std::size_t b = 0; b < A.stride(); b += P::width) {
+		P a[N * N];
+		P r[N * N];
+		for (std::size_t k = 0; k < N * N; ++k) {
+			a[k] = P::load(A.lane(k / N, k % N) + b);
+		}
+		detail::small_inverse<N>(a, r);
+		for (std::size_t k = 0; k < N * N; ++k) {
+			r[k].store(out.lane(k / N, k % N) + b);
+		}
+	}
+}
+
+template <typename T, std::size_t M, std::size_t N>
+vec_batch<T, M> operator*(const mat_batch<T, M, N>& A, const vec_batch<T, N>& x) {
+	vec_batch<T, M> y(A.size());
+	multiply(A, x, y);
+	return y;
+}
+
+template <typename T, std::size_t M, std::size_t N, std::size_t K>
+mat_batch<T, M, K> operator*(const mat_batch<T, M, N>& A, const mat_batch<T, N, K>& B) {
+	mat_batch<T, M, K> C(A.size());
+	multiply(A, B, C);
+	return C;
+}
+
+template <typename T, std::size_t N> mat_batch<T, N, N> inverse(const mat_batch<T, N, N>& A) {
+	mat_batch<T, N, N> out(A.size());
+	inverse(A, out);
+	return out;
+}
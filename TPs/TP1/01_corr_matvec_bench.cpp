@@ -0,0 +1,503 @@
+// Benchmark of the matvec kernels
+//
+// Sweeps sizes and element types for dot, AXPY, mat-vec, vec-mat, mat-mat
+// and transpose, and reports for each run the time, GFLOP/s, GB/s and the
+// percentage of the roofline bound min(peak GFLOP/s, intensity * peak GB/s).
+// Both peaks are measured before and after the kernels, keeping the best (a
+// register-only FMA loop, and streaming loops at each level of the memory
+// hierarchy), so the percentages are relative to this machine and this build.
+// Strassen-Winograd rows count the 2 n^3 flops of the classical product, so
+// their GFLOP/s compare directly with the matmat rows (and can go past 100 %).
+// Any other row above the bound is reported as a measurement error instead of
+// a percentage.
+// q15 rows (fixed-point dot and mat-vec) count integer multiply-adds as flops
+// and are compared with the float peak.
+//
+// Usage: 01_corr_matvec_bench [--quick] [--json <file>]
+//
+// Build: g++ -std=c++20 -O3 -march=native -pthread 01_corr_matvec_bench.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+#include "01_corr_matvec_fixed.hpp"
+#include "01_corr_matvec_strassen.hpp"
+#include "01_corr_matvec_transpose.hpp"
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Timing
+//------------------------------------------------------------------------------
+
+// Keeps the compiler from discarding or hoisting the benchmarked work
+template <typename T> void keep(const T& value) {
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Best time of one call to f, over batches of calls lasting at least min_time
+double seconds_per_call(auto&& f, double min_time) {
+	using clock = std::chrono::steady_clock;
+	f();
+	std::size_t calls = 1;
+	double best = 1e300;
+	for (int trial = 0; trial < 3; ++trial) {
+		for (;;) {
+			const auto start = clock::now();
+			for (std::size_t c = 0; c < calls; ++c) {
+				f();
+			}
+			const double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+			if (elapsed >= min_time) {
+				best = std::min(best, elapsed / static_cast<double>(calls));
+				break;
+			}
+			calls *= 2;
+		}
+	}
+	return best;
+}
+
+//------------------------------------------------------------------------------
+// Machine peaks
+//------------------------------------------------------------------------------
+
+// Independent FMA chains on full registers, no memory traffic. The chains are
+// named locals rather than an array so that they all stay in registers, and
+// start from different values so that the compiler cannot merge them; the
+// only barrier is after the loop.
+template <typename T> double measure_peak_gflops(double min_time) {
+	using R = simd::reg_or_scalar<T>;
+	constexpr std::size_t chains = 12;
+	constexpr std::size_t steps = 4096;
+	const double t = seconds_per_call([] {
+		auto a0 = R::set1(T(1.00)), a1 = R::set1(T(1.01)), a2 = R::set1(T(1.02)), a3 = R::set1(T(1.03));
+		auto a4 = R::set1(T(1.04)), a5 = R::set1(T(1.05)), a6 = R::set1(T(1.06)), a7 = R::set1(T(1.07));
+		auto a8 = R::set1(T(1.08)), a9 = R::set1(T(1.09)), a10 = R::set1(T(1.10)), a11 = R::set1(T(1.11));
+		const auto m = R::set1(T(0.999));
+		const auto c = R::set1(T(0.001));
+		for (std::size_t s = 0; s < steps; ++s) {
+			a0 = R::fma(a0, m, c);
+			a1 = R::fma(a1, m, c);
+			a2 = R::fma(a2, m, c);
+			a3 = R::fma(a3, m, c);
+			a4 = R::fma(a4, m, c);
+			a5 = R::fma(a5, m, c);
+			a6 = R::fma(a6, m, c);
+			a7 = R::fma(a7, m, c);
+			a8 = R::fma(a8, m, c);
+			a9 = R::fma(a9, m, c);
+			a10 = R::fma(a10, m, c);
+			a11 = R::fma(a11, m, c);
+		}
+		asm volatile("" : "+v"(a0), "+v"(a1), "+v"(a2), "+v"(a3), "+v"(a4), "+v"(a5), "+v"(a6), "+v"(a7), "+v"(a8),
+		                  "+v"(a9), "+v"(a10), "+v"(a11));
+	}, min_time);
+	return 2.0 * chains * steps * R::width / t * 1e-9;
+}
+
+// STREAM triad a = b + s * c on n doubles per array
+double measure_triad_gbps(std::size_t n, double min_time) {
+	dyn_vec<double> a(n), b(n, 1.0), c(n, 2.0);
+	const double t = seconds_per_call([&] {
+		double* pa = a.data();
+		const double* pb = b.data();
+		const double* pc = c.data();
+		for (std::size_t i = 0; i < n; ++i) {
+			pa[i] = pb[i] + 0.5 * pc[i];
+		}
+		keep(a);
+	}, min_time);
+	return 3.0 * sizeof(double) * n / t * 1e-9;
+}
+
+// Read-only streaming: two arrays of n doubles reduced by simd::dot
+double measure_read_gbps(std::size_t n, double min_time) {
+	dyn_vec<double> a(n, 1.0), b(n, 2.0);
+	const double t = seconds_per_call([&] {
+		double r = simd::dot(a.data(), b.data(), n);
+		keep(r);
+	}, min_time);
+	return 2.0 * sizeof(double) * n / t * 1e-9;
+}
+
+// In-place update y += s * x by simd::axpy on n doubles per array, counted
+// like the AXPY rows (two reads and a write per element)
+double measure_update_gbps(std::size_t n, double min_time) {
+	dyn_vec<double> x(n, 1.0), y(n, 2.0);
+	const double t = seconds_per_call([&] {
+		simd::axpy(n, 1e-3, x.data(), y.data());
+		keep(y);
+	}, min_time);
+	return 3.0 * sizeof(double) * n / t * 1e-9;
+}
+
+// Bandwidth of each level of the hierarchy: the best of a triad, a read-only
+// stream and an in-place update. A kernel is compared to the level its own footprint fits
+// in, so cache-resident runs are not scored against DRAM. Each level is
+// measured at the smallest footprint it covers, where it is fastest, so that
+// its bandwidth bounds every footprint it covers.
+struct bandwidth_level {
+	const char* name;
+	std::size_t max_bytes;
+	double gbps;
+};
+
+// Cache size reported by the system, or fallback when unavailable. Virtual
+// machines may report the whole host cache (hundreds of MB for the L3), so
+// the sizes are capped at max_bytes.
+std::size_t cache_bytes([[maybe_unused]] int name, std::size_t fallback, std::size_t max_bytes) {
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+	const long bytes = sysconf(name);
+	if (bytes > 0) {
+		return std::min(static_cast<std::size_t>(bytes), max_bytes);
+	}
+#endif
+	return fallback;
+}
+
+std::vector<bandwidth_level> measure_bandwidth(double min_time) {
+	constexpr std::size_t KiB = 1024, MiB = 1024 * KiB;
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+	const std::size_t l1 = cache_bytes(_SC_LEVEL1_DCACHE_SIZE, 32 * KiB, 1 * MiB);
+	const std::size_t l2 = std::max(cache_bytes(_SC_LEVEL2_CACHE_SIZE, 1 * MiB, 32 * MiB), 4 * l1);
+	const std::size_t l3 = std::max(cache_bytes(_SC_LEVEL3_CACHE_SIZE, 16 * MiB, 128 * MiB), 4 * l2);
+#else
+	const std::size_t l1 = 32 * KiB, l2 = 1 * MiB, l3 = 16 * MiB;
+#endif
+	std::vector<bandwidth_level> levels = {
+		{"L1", l1, 0.0},
+		{"L2", l2, 0.0},
+		{"L3", l3, 0.0},
+		{"memory", SIZE_MAX, 0.0},
+	};
+	// Half of the L1, then just past the level below (see level_for)
+	const std::size_t footprints[] = {l1 / 2, l1 + l1 / 8, l2 + l2 / 8, l3 + l3 / 8};
+	for (std::size_t k = 0; k < levels.size(); ++k) {
+		levels[k].gbps = std::max({measure_triad_gbps(footprints[k] / (3 * sizeof(double)), min_time),
+		                           measure_read_gbps(footprints[k] / (2 * sizeof(double)), min_time),
+		                           measure_update_gbps(footprints[k] / (2 * sizeof(double)), min_time)});
+	}
+	// A level is never slower than the ones above it
+	for (std::size_t k = levels.size() - 1; k-- > 0;) {
+		levels[k].gbps = std::max(levels[k].gbps, levels[k + 1].gbps);
+	}
+	return levels;
+}
+
+//------------------------------------------------------------------------------
+// Results
+//------------------------------------------------------------------------------
+
+struct result {
+	std::string kernel;
+	std::string type;
+	std::string size;
+	double seconds;
+	double flops;
+	double bytes;
+};
+
+struct machine {
+	double gflops_float;
+	double gflops_double;
+	std::vector<bandwidth_level> bandwidth;
+
+	// A cache still serves most of a footprint slightly larger than itself, so
+	// a level covers up to 1/8 more than its size
+	const bandwidth_level& level_for(double bytes) const {
+		for (const bandwidth_level& l : bandwidth) {
+			if (bytes <= 1.125 * static_cast<double>(l.max_bytes)) {
+				return l;
+			}
+		}
+		return bandwidth.back();
+	}
+
+	// Keeps the best of two measurements of each peak
+	void merge(const machine& other) {
+		gflops_float = std::max(gflops_float, other.gflops_float);
+		gflops_double = std::max(gflops_double, other.gflops_double);
+		for (std::size_t k = 0; k < bandwidth.size(); ++k) {
+			bandwidth[k].gbps = std::max(bandwidth[k].gbps, other.bandwidth[k].gbps);
+		}
+	}
+};
+
+machine measure_machine(double min_time) {
+	return {measure_peak_gflops<float>(min_time), measure_peak_gflops<double>(min_time), measure_bandwidth(min_time)};
+}
+
+// Achieved performance over the roofline bound. Kernels without flops
+// (transpose) are bounded by bandwidth alone.
+double roofline_percent(const result& r, const machine& peak) {
+	const double gbps = peak.level_for(r.bytes).gbps;
+	if (r.flops == 0.0) {
+		return 100.0 * (r.bytes / r.seconds * 1e-9) / gbps;
+	}
+	const double gflops = r.type == "double" ? peak.gflops_double : peak.gflops_float;
+	const double bound = std::min(gflops, r.flops / r.bytes * gbps);
+	return 100.0 * (r.flops / r.seconds * 1e-9) / bound;
+}
+
+// Only Strassen-Winograd, which does fewer flops than it is credited with, may
+// beat the roofline; any other row above it means a peak was underestimated
+bool above_roofline(const result& r, const machine& peak) {
+	return r.kernel != "strassen" && roofline_percent(r, peak) > 100.0;
+}
+
+void print(const result& r, const machine& peak) {
+	std::printf("%-10s %-7s %-12s %12.3f us %9.2f GFLOP/s %9.2f GB/s ", r.kernel.c_str(), r.type.c_str(),
+	            r.size.c_str(), r.seconds * 1e6, r.flops / r.seconds * 1e-9, r.bytes / r.seconds * 1e-9);
+	if (above_roofline(r, peak)) {
+		std::printf("measurement error: above the %s roofline\n", peak.level_for(r.bytes).name);
+	} else {
+		std::printf("%6.1f %% (%s)\n", roofline_percent(r, peak), peak.level_for(r.bytes).name);
+	}
+}
+
+void write_json(const char* path, const std::vector<result>& results, const machine& peak) {
+	FILE* out = std::fopen(path, "w");
+	if (!out) {
+		std::perror(path);
+		return;
+	}
+	std::fprintf(out, "{\n  \"peak\": {\"gflops_float\": %.3f, \"gflops_double\": %.3f, \"gbps\": {",
+	             peak.gflops_float, peak.gflops_double);
+	for (std::size_t k = 0; k < peak.bandwidth.size(); ++k) {
+		std::fprintf(out, "%s\"%s\": %.3f", k ? ", " : "", peak.bandwidth[k].name, peak.bandwidth[k].gbps);
+	}
+	std::fprintf(out, "}},\n");
+	std::fprintf(out, "  \"results\": [\n");
+	for (std::size_t k = 0; k < results.size(); ++k) {
+		const result& r = results[k];
+		std::fprintf(out,
+		             "    {\"kernel\": \"%s\", \"type\": \"%s\", \"size\": \"%s\", \"seconds\": %.9g, "
+		             "\"gflops\": %.4f, \"gbps\": %.4f, \"level\": \"%s\", ",
+		             r.kernel.c_str(), r.type.c_str(), r.size.c_str(), r.seconds, r.flops / r.seconds * 1e-9,
+		             r.bytes / r.seconds * 1e-9, peak.level_for(r.bytes).name);
+		// Rows above the roofline are measurement errors, not percentages
+		if (above_roofline(r, peak)) {
+			std::fprintf(out, "\"roofline_percent\": null, \"error\": \"above roofline\"}%s\n",
+			             k + 1 < results.size() ? "," : "");
+		} else {
+			std::fprintf(out, "\"roofline_percent\": %.2f}%s\n", roofline_percent(r, peak),
+			             k + 1 < results.size() ? "," : "");
+		}
+	}
+	std::fprintf(out, "  ]\n}\n");
+	std::fclose(out);
+}
+
+//------------------------------------------------------------------------------
+// Kernels
+//------------------------------------------------------------------------------
+
+template <typename T> const char* type_name() {
+	return sizeof(T) == 4 ? "float" : "double";
+}
+
+template <typename T> dyn_vec<T> make_vec(std::size_t n) {
+	dyn_vec<T> v(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		v[i] = static_cast<T>(i % 17) * T(0.125);
+	}
+	return v;
+}
+
+template <typename T> dyn_mat<T> make_mat(std::size_t m, std::size_t n) {
+	dyn_mat<T> A(m, n);
+	for (std::size_t i = 0; i < m; ++i) {
+		for (std::size_t j = 0; j < n; ++j) {
+			A(i, j) = static_cast<T>((i + 3 * j) % 11) * T(0.25);
+		}
+	}
+	return A;
+}
+
+template <typename T> void bench_dot(std::vector<result>& out, std::size_t n, double min_time) {
+	const dyn_vec<T> u = make_vec<T>(n), v = make_vec<T>(n);
+	const double t = seconds_per_call([&] {
+		T r = dot(u, v);
+		keep(r);
+	}, min_time);
+	out.push_back({"dot", type_name<T>(), std::to_string(n), t, 2.0 * n, 2.0 * n * sizeof(T)});
+}
+
+// AXPY through the lazy vec expressions, y += alpha * x
+template <typename T, std::size_t N> void bench_axpy(std::vector<result>& out, double min_time) {
+	auto x = std::make_unique<vec<T, N>>();
+	auto y = std::make_unique<vec<T, N>>();
+	for (std::size_t i = 0; i < N; ++i) {
+		(*x)[i] = static_cast<T>(i % 7);
+	}
+	const T alpha = T(1e-3);
+	const double t = seconds_per_call([&] {
+		*y += alpha * *x;
+		keep(*y);
+	}, min_time);
+	out.push_back({"axpy", type_name<T>(), std::to_string(N), t, 2.0 * N, 3.0 * N * sizeof(T)});
+}
+
+template <typename T> void bench_gemv(std::vector<result>& out, std::size_t n, double min_time) {
+	const dyn_mat<T> A = make_mat<T>(n, n);
+	const dyn_vec<T> x = make_vec<T>(n);
+	const std::string size = std::to_string(n) + "x" + std::to_string(n);
+	const double bytes = (double(n) * n + 2.0 * n) * sizeof(T);
+
+	double t = seconds_per_call([&] {
+		dyn_vec<T> y = A * x;
+		keep(y);
+	}, min_time);
+	out.push_back({"matvec", type_name<T>(), size, t, 2.0 * n * n, bytes});
+
+	t = seconds_per_call([&] {
+		dyn_vec<T> y = x * A;
+		keep(y);
+	}, min_time);
+	out.push_back({"vecmat", type_name<T>(), size, t, 2.0 * n * n, bytes});
+}
+
+template <typename T> void bench_gemm(std::vector<result>& out, std::size_t n, double min_time) {
+	const dyn_mat<T> A = make_mat<T>(n, n), B = make_mat<T>(n, n);
+	const double t = seconds_per_call([&] {
+		dyn_mat<T> C = A * B;
+		keep(C);
+	}, min_time);
+	out.push_back({"matmat", type_name<T>(), std::to_string(n) + "x" + std::to_string(n), t, 2.0 * n * n * n,
+	               3.0 * n * n * sizeof(T)});
+}
+
+template <typename T> void bench_strassen(std::vector<result>& out, std::size_t n, double min_time) {
+	const dyn_mat<T> A = make_mat<T>(n, n), B = make_mat<T>(n, n);
+	strassen_workspace<T> ws;
+	const double t = seconds_per_call([&] {
+		dyn_mat<T> C = multiply_strassen(A, B, ws);
+		keep(C);
+	}, min_time);
+	out.push_back({"strassen", type_name<T>(), std::to_string(n) + "x" + std::to_string(n), t, 2.0 * n * n * n,
+	               3.0 * n * n * sizeof(T)});
+}
+
+// Fixed-point dot and mat-vec on q15 samples
+void bench_fixed(std::vector<result>& out, std::size_t n, double min_time) {
+	dyn_mat<q15> A(n, n);
+	dyn_vec<q15> x(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		for (std::size_t j = 0; j < n; ++j) {
+			A(i, j) = q15::from_raw(static_cast<std::int16_t>((i * 7919 + j * 104729) % 65536 - 32768));
+		}
+		x[i] = q15::from_raw(static_cast<std::int16_t>((i * 40503) % 65536 - 32768));
+	}
+	const std::string size = std::to_string(n) + "x" + std::to_string(n);
+
+	double t = seconds_per_call([&] {
+		q15 r = dot(x, x);
+		keep(r);
+	}, min_time);
+	out.push_back({"dot", "q15", std::to_string(n), t, 2.0 * n, 2.0 * n * sizeof(q15)});
+
+	t = seconds_per_call([&] {
+		dyn_vec<q15> y = A * x;
+		keep(y);
+	}, min_time);
+	out.push_back({"matvec", "q15", size, t, 2.0 * n * n, (double(n) * n + 2.0 * n) * sizeof(q15)});
+}
+
+// Transpose moves data only; its "flops" are counted as zero and the
+// roofline bound is the bandwidth
+template <typename T> void bench_transpose(std::vector<result>& out, std::size_t m, std::size_t n, double min_time) {
+	const dyn_mat<T> A = make_mat<T>(m, n);
+	const double t = seconds_per_call([&] {
+		dyn_mat<T> At = transposed(A);
+		keep(At);
+	}, min_time);
+	out.push_back({"transpose", type_name<T>(), std::to_string(m) + "x" + std::to_string(n), t, 0.0,
+	               2.0 * m * n * sizeof(T)});
+}
+
+template <typename T>
+void bench_type(std::vector<result>& out, bool quick, double min_time) {
+	const std::vector<std::size_t> vec_sizes = quick ? std::vector<std::size_t>{4096, 1 << 20}
+	                                                 : std::vector<std::size_t>{1024, 16384, 262144, 1 << 22};
+	const std::vector<std::size_t> mat_sizes = quick ? std::vector<std::size_t>{64, 512}
+	                                                 : std::vector<std::size_t>{32, 128, 512, 2048};
+
+	for (std::size_t n : vec_sizes) {
+		bench_dot<T>(out, n, min_time);
+	}
+	bench_axpy<T, 4096>(out, min_time);
+	if (!quick) {
+		bench_axpy<T, 262144>(out, min_time);
+	}
+	bench_axpy<T, 1 << 20>(out, min_time);
+	for (std::size_t n : mat_sizes) {
+		bench_gemv<T>(out, n, min_time);
+	}
+	for (std::size_t n : mat_sizes) {
+		bench_gemm<T>(out, n, min_time);
+		if (n > strassen_options{}.cutoff) {
+			bench_strassen<T>(out, n, min_time);
+		}
+	}
+	for (std::size_t n : mat_sizes) {
+		bench_transpose<T>(out, n, n, min_time);
+		bench_transpose<T>(out, n + 3, 2 * n - 1, min_time);
+	}
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	bool quick = false;
+	const char* json = nullptr;
+	for (int k = 1; k < argc; ++k) {
+		if (std::strcmp(argv[k], "--quick") == 0) {
+			quick = true;
+		} else if (std::strcmp(argv[k], "--json") == 0 && k + 1 < argc) {
+			json = argv[++k];
+		} else {
+			std::fprintf(stderr, "usage: %s [--quick] [--json <file>]\n", argv[0]);
+			return 1;
+		}
+	}
+	const double min_time = quick ? 0.02 : 0.1;
+
+	// The peaks bound every row, so they get longer runs than the kernels and
+	// are measured before and after them, in case the machine was busy
+	const double peak_time = 5 * min_time;
+	machine peak = measure_machine(peak_time);
+
+	std::vector<result> results;
+	bench_type<float>(results, quick, min_time);
+	bench_type<double>(results, quick, min_time);
+	for (std::size_t n : quick ? std::vector<std::size_t>{64, 512} : std::vector<std::size_t>{32, 128, 512, 2048}) {
+		bench_fixed(results, n, min_time);
+	}
+
+	peak.merge(measure_machine(peak_time));
+	std::printf("peak: %.2f GFLOP/s float, %.2f GFLOP/s double\n", peak.gflops_float, peak.gflops_double);
+	for (const bandwidth_level& l : peak.bandwidth) {
+		std::printf("      %.2f GB/s %s\n", l.gbps, l.name);
+	}
+	std::printf("\n");
+
+	for (const result& r : results) {
+		print(r, peak);
+	}
+	if (json) {
+		write_json(json, results, peak);
+	}
+	return 0;
+}
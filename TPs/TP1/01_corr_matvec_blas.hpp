@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+#include "01_corr_matvec_simd.hpp"
+
+// Fused BLAS-style updates
+//
+//   axpy(alpha, x, y)             y = alpha * x + y
+//   gemv(alpha, A, x, beta, y)    y = alpha * A * x + beta * y
+//   gemm(alpha, A, B, beta, C)    C = alpha * A * B + beta * C
+//   ger(alpha, x, y, A)           A = alpha * x * y^T + A
+//
+// The output is updated in place, without temporaries: gemv scales each
+// row result as it is stored, gemm folds alpha into the packing of A and
+// accumulates straight into C, ger runs one axpy per row (or column). As in
+// BLAS, beta == 0 overwrites the output without reading it, and the output
+// must not alias the inputs.
+
+namespace detail {
+
+// p[0 .. n) *= beta, with beta == 0 clearing (NaN/inf in p are dropped)
+template <typename T> void scale_in_place(T* p, std::size_t n, T beta) {
+	if (beta == T{}) {
+		std::fill_n(p, n, T{});
+	} else if (beta != T(1)) {
+		simd::scale(p, beta, p, n);
+	}
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// axpy
+//------------------------------------------------------------------------------
+
+template <typename T, std::size_t N> void axpy(T alpha, const vec<T, N>& x, vec<T, N>& y) {
+	simd::axpy(N, alpha, x.data.data(), y.data.data());
+}
+
+template <typename T> void axpy(T alpha, const dyn_vec<T>& x, dyn_vec<T>& y) {
+	assert(x.size() == y.size() && "axpy size mismatch");
+	simd::axpy(x.size(), alpha, x.data(), y.data());
+}
+
+//------------------------------------------------------------------------------
+// gemv
+//------------------------------------------------------------------------------
+
+template <typename T, std::size_t M, std::size_t N, typename L>
+void gemv(T alpha, const mat<T, M, N, L>& A, const vec<T, N>& x, T beta, vec<T, M>& y) {
+	if constexpr (std::is_same_v<L, row_major>) {
+		simd::gemv(M, N, alpha, A.data.data(), N, x.data.data(), beta, y.data.data());
+	} else {
+		// Column-major: y accumulates alpha * x[j] * column j
+		detail::scale_in_place(y.data.data(), M, beta);
+		for (std::size_t j = 0; j < N; ++j) {
+			simd::axpy(M, alpha * x[j], A.data.data() + j * M, y.data.data());
+		}
+	}
+}
+
+template <typename T>
+void gemv(T alpha, const dyn_mat<T>& A, const dyn_vec<T>& x, T beta, dyn_vec<T>& y) {
+	assert(A.n() == x.size() && A.m() == y.size() && "gemv size mismatch");
+	simd::gemv(A.m(), A.n(), alpha, A.data(), A.ld(), x.data(), beta, y.data());
+}
+
+//------------------------------------------------------------------------------
+// gemm
+//------------------------------------------------------------------------------
+
+template <typename T, std::size_t M, std::size_t N, std::size_t P, typename LA, typename LB, typename LC>
+void gemm(T alpha, const mat<T, M, N, LA>& A, const mat<T, N, P, LB>& B, T beta, mat<T, M, P, LC>& C) {
+	detail::scale_in_place(C.data.data(), M * P, beta);
+	if constexpr (detail::gemm_use_blocked<T, M, N, P>) {
+		detail::gemm_blocked<T, detail::gemm_tiles<T, M, N, P>>(
+			M, P, N, A.data.data(), A.row_stride(), A.col_stride(), B.data.data(), B.row_stride(), B.col_stride(),
+			C.data.data(), C.row_stride(), C.col_stride(), alpha);
+	} else {
+		for (std::size_t i = 0; i < M; ++i) {
+			for (std::size_t j = 0; j < P; ++j) {
+				T sum{};
+				for (std::size_t k = 0; k < N; ++k) {
+					sum += A(i, k) * B(k, j);
+				}
+				C(i, j) += alpha * sum;
+			}
+		}
+	}
+}
+
+template <typename T>
+void gemm(T alpha, const dyn_mat<T>& A, const dyn_mat<T>& B, T beta, dyn_mat<T>& C) {
+	assert(A.n() == B.m() && A.m() == C.m() && B.n() == C.n() && "gemm size mismatch");
+	for (std::size_t i = 0; i < C.m(); ++i) {
+		detail::scale_in_place(C.row_data(i), C.n(), beta);
+	}
+	if (detail::gemm_worth_blocking<T>(A.m(), B.n(), A.n())) {
+		detail::gemm_blocked<T, detail::gemm_blocking<T>>(A.m(), B.n(), A.n(), A.data(), A.ld(), 1, B.data(),
+		                                                  B.ld(), 1, C.data(), C.ld(), 1, alpha);
+		return;
+	}
+	for (std::size_t i = 0; i < A.m(); ++i) {
+		for (std::size_t k = 0; k < A.n(); ++k) {
+			simd::axpy(B.n(), alpha * A(i, k), B.row_data(k), C.row_data(i));
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// ger (rank-1 update)
+//------------------------------------------------------------------------------
+
+template <typename T, std::size_t M, std::size_t N, typename L>
+void ger(T alpha, const vec<T, M>& x, const vec<T, N>& y, mat<T, M, N, L>& A) {
+	if constexpr (std::is_same_v<L, row_major>) {
+		for (std::size_t i = 0; i < M; ++i) {
+			simd::axpy(N, alpha * x[i], y.data.data(), A.data.data() + i * N);
+		}
+	} else {
+		for (std::size_t j = 0; j < N; ++j) {
+			simd::axpy(M, alpha * y[j], x.data.data(), A.data.data() + j * M);
+		}
+	}
+}
+
+template <typename T> void ger(T alpha, const dyn_vec<T>& x, const dyn_vec<T>& y, dyn_mat<T>& A) {
+	assert(A.m() == x.size() && A.n() == y.size() && "ger size mismatch");
+	for (std::size_t i = 0; i < A.m(); ++i) {
+		simd::axpy(A.n(), alpha * x[i], y.data(), A.row_data(i));
+	}
+}
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_arena.hpp"
+
+// Types dyn_vec / dyn_mat
+//
+// Same interface as vec and mat, but the dimensions are runtime values and
+// the elements live on the heap. Storage is 64-byte aligned and every row of
+// a dyn_mat starts on a 64-byte boundary: the leading dimension ld() is n()
+// rounded up to a full cache line, and the padding is kept at zero.
+// Storage comes from the heap, or from an arena when one is passed to the
+// constructor (see 01_corr_matvec_arena).
+
+namespace detail {
+
+// Number of elements of T per aligned block (at least one)
+template <typename T>
+inline constexpr std::size_t aligned_elements =
+	sizeof(T) < storage_alignment ? storage_alignment / sizeof(T) : 1;
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// dyn_vec
+//------------------------------------------------------------------------------
+
+template <typename T> struct dyn_vec {
+	//--------------------------------------------------------------------------
+	// Constructors
+	//--------------------------------------------------------------------------
+
+	// Empty vector
+	dyn_vec() = default;
+
+	// n zero-initialized elements
+	explicit dyn_vec(std::size_t n)
+		: storage(detail::pad_to(n, detail::aligned_elements<T>)), count(n) {}
+
+	// n zero-initialized elements taken from ws
+	dyn_vec(std::size_t n, arena& ws)
+		: storage(detail::pad_to(n, detail::aligned_elements<T>), ws), count(n) {}
+
+	// Copy of v taken from ws
+	dyn_vec(const dyn_vec& v, arena& ws) : dyn_vec(v.size(), ws) {
+		std::copy_n(v.data(), count, storage.data());
+	}
+
+	// n elements filled with the same value
+	dyn_vec(std::size_t n, const T& value) : dyn_vec(n) {
+		std::fill_n(storage.data(), n, value);
+	}
+
+	// Copy from a fixed-size vec
+	template <std::size_t N>
+	explicit dyn_vec(const vec<T, N>& v) : dyn_vec(N) {
+		std::copy_n(v.data.data(), N, storage.data());
+	}
+
+	// Copy to a fixed-size vec (sizes must match)
+	template <std::size_t N>
+	explicit operator vec<T, N>() const {
+		assert(count == N && "dyn_vec -> vec size mismatch");
+		vec<T, N> result;
+		std::copy_n(storage.data(), N, result.data.data());
+		return result;
+	}
+
+	//--------------------------------------------------------------------------
+	// Element access
+	//--------------------------------------------------------------------------
+
+	T& operator[](std::size_t i) { return storage.data()[i]; }
+	const T& operator[](std::size_t i) const { return storage.data()[i]; }
+
+	T* data() { return storage.data(); }
+	const T* data() const { return storage.data(); }
+
+	//--------------------------------------------------------------------------
+	// Size
+	//--------------------------------------------------------------------------
+
+	std::size_t size() const { return count; }
+
+	private:
+	detail::aligned_buffer<T> storage;
+	std::size_t count = 0;
+};
+
+//------------------------------------------------------------------------------
+// dyn_mat
+//------------------------------------------------------------------------------
+
+template <typename T> struct dyn_mat {
+	//--------------------------------------------------------------------------
+	// Constructors
+	//--------------------------------------------------------------------------
+
+	// Empty matrix
+	dyn_mat() = default;
+
+	// rows x cols zero-initialized matrix
+	dyn_mat(std::size_t rows, std::size_t cols)
+		: stride(detail::pad_to(cols, detail::aligned_elements<T>)),
+		  storage(rows * stride), rows_(rows), cols_(cols) {}
+
+	// rows x cols zero-initialized matrix taken from ws
+	dyn_mat(std::size_t rows, std::size_t cols, arena& ws)
+		: stride(detail::pad_to(cols, detail::aligned_elements<T>)),
+		  storage(rows * stride, ws), rows_(rows), cols_(cols) {}
+
+	// Copy of A taken from ws
+	dyn_mat(const dyn_mat& A, arena& ws) : dyn_mat(A.m(), A.n(), ws) {
+		std::copy_n(A.data(), rows_ * stride, storage.data());
+	}
+
+	// Fill all entries with a single value
+	dyn_mat(std::size_t rows, std::size_t cols, const T& value) : dyn_mat(rows, cols) {
+		for (std::size_t i = 0; i < rows_; ++i) {
+			std::fill_n(row_data(i), cols_, value);
+		}
+	}
+
+	// Copy from a fixed-size mat
+	template <std::size_t M, std::size_t N>
+	explicit dyn_mat(const mat<T, M, N>& A) : dyn_mat(M, N) {
+		for (std::size_t i = 0; i < M; ++i) {
+			std::copy_n(A.data.data() + i * N, N, row_data(i));
+		}
+	}
+
+	// Copy to a fixed-size mat (dimensions must match)
+	template <std::size_t M, std::size_t N>
+	explicit operator mat<T, M, N>() const {
+		assert(rows_ == M && cols_ == N && "dyn_mat -> mat size mismatch");
+		mat<T, M, N> result;
+		for (std::size_t i = 0; i < M; ++i) {
+			std::copy_n(row_data(i), N, result.data.data() + i * N);
+		}
+		return result;
+	}
+
+	//--------------------------------------------------------------------------
+	// Dimensions
+	//--------------------------------------------------------------------------
+
+	std::size_t m() const { return rows_; }
+	std::size_t n() const { return cols_; }
+
+	// Distance, in elements, between two consecutive rows
+	std::size_t ld() const { return stride; }
+
+	//--------------------------------------------------------------------------
+	// Element access
+	//--------------------------------------------------------------------------
+
+	T& operator()(std::size_t i, std::size_t j) { return storage.data()[i * stride + j]; }
+	const T& operator()(std::size_t i, std::size_t j) const { return storage.data()[i * stride + j]; }
+
+	T* data() { return storage.data(); }
+	const T* data() const { return storage.data(); }
+
+	T* row_data(std::size_t i) { return storage.data() + i * stride; }
+	const T* row_data(std::size_t i) const { return storage.data() + i * stride; }
+
+	//--------------------------------------------------------------------------
+	// Extract a full column / row
+	//--------------------------------------------------------------------------
+
+	dyn_vec<T> col(std::size_t j) const {
+		dyn_vec<T> result(rows_);
+		for (std::size_t i = 0; i < rows_; ++i) {
+			result[i] = (*this)(i, j);
+		}
+		return result;
+	}
+
+	dyn_vec<T> row(std::size_t i) const {
+		dyn_vec<T> result(cols_);
+		std::copy_n(row_data(i), cols_, result.data());
+		return result;
+	}
+
+	private:
+	std::size_t stride = 0;
+	detail::aligned_buffer<T> storage;
+	std::size_t rows_ = 0;
+	std::size_t cols_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// Products, with the same semantics as their fixed-size counterparts
+//------------------------------------------------------------------------------
+
+// Dot product
+template <typename T> T dot(const dyn_vec<T>& u, const dyn_vec<T>& v) {
+	assert(u.size() == v.size() && "dot size mismatch");
+	return simd::dot(u.data(), v.data(), u.size());
+}
+
+// Dyadic product
+template <typename T> dyn_mat<T> operator*(const dyn_vec<T>& u, const dyn_vec<T>& v) {
+	dyn_mat<T> result(u.size(), v.size());
+	for (std::size_t i = 0; i < u.size(); ++i) {
+		simd::scale(v.data(), u[i], result.row_data(i), v.size());
+	}
+	return result;
+}
+
+// Scaling
+template <typename T> dyn_vec<T> operator*(const dyn_vec<T>& u, const T& alpha) {
+	dyn_vec<T> result(u.size());
+	simd::scale(u.data(), alpha, result.data(), u.size());
+	return result;
+}
+
+template <typename T> dyn_vec<T> operator*(const T& alpha, const dyn_vec<T>& u) {
+	return u * alpha;
+}
+
+namespace detail {
+
+// y += x * A, accumulated row by row to stay on contiguous memory
+template <typename T> void vec_mat_accumulate(const dyn_vec<T>& x, const dyn_mat<T>& A, T* y) {
+	for (std::size_t i = 0; i < A.m(); ++i) {
+		const T* a = A.row_data(i);
+		const T xi = x[i];
+		for (std::size_t j = 0; j < A.n(); ++j) {
+			y[j] += xi * a[j];
+		}
+	}
+}
+
+// C += A * B
+template <typename T> void mat_mat_accumulate(const dyn_mat<T>& A, const dyn_mat<T>& B, dyn_mat<T>& C) {
+	if (gemm_worth_blocking<T>(A.m(), B.n(), A.n())) {
+		gemm_blocked<T, gemm_blocking<T>>(A.m(), B.n(), A.n(), A.data(), A.ld(), B.data(), B.ld(), C.data(), C.ld());
+		return;
+	}
+	for (std::size_t i = 0; i < A.m(); ++i) {
+		T* c = C.row_data(i);
+		for (std::size_t k = 0; k < A.n(); ++k) {
+			const T aik = A(i, k);
+			const T* b = B.row_data(k);
+			for (std::size_t j = 0; j < B.n(); ++j) {
+				c[j] += aik * b[j];
+			}
+		}
+	}
+}
+
+} // namespace detail
+
+// Matrix/vector
+template <typename T> dyn_vec<T> operator*(const dyn_mat<T>& A, const dyn_vec<T>& x) {
+	assert(A.n() == x.size() && "A*x size mismatch");
+	dyn_vec<T> result(A.m());
+	simd::gemv(A.m(), A.n(), A.data(), A.ld(), x.data(), result.data());
+	return result;
+}
+
+// Vector/matrix
+template <typename T> dyn_vec<T> operator*(const dyn_vec<T>& x, const dyn_mat<T>& A) {
+	assert(x.size() == A.m() && "x*A size mismatch");
+	dyn_vec<T> result(A.n());
+	detail::vec_mat_accumulate(x, A, result.data());
+	return result;
+}
+
+// Matrix/matrix
+template <typename T> dyn_mat<T> operator*(const dyn_mat<T>& A, const dyn_mat<T>& B) {
+	assert(A.n() == B.m() && "A*B size mismatch");
+	dyn_mat<T> result(A.m(), B.n());
+	detail::mat_mat_accumulate(A, B, result);
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// Same products with the result taken from an arena
+//------------------------------------------------------------------------------
+
+template <typename T> dyn_vec<T> multiply(const dyn_mat<T>& A, const dyn_vec<T>& x, arena& ws) {
+	assert(A.n() == x.size() && "A*x size mismatch");
+	dyn_vec<T> result(A.m(), ws);
+	simd::gemv(A.m(), A.n(), A.data(), A.ld(), x.data(), result.data());
+	return result;
+}
+
+template <typename T> dyn_vec<T> multiply(const dyn_vec<T>& x, const dyn_mat<T>& A, arena& ws) {
+	assert(x.size() == A.m() && "x*A size mismatch");
+	dyn_vec<T> result(A.n(), ws);
+	detail::vec_mat_accumulate(x, A, result.data());
+	return result;
+}
+
+template <typename T> dyn_mat<T> multiply(const dyn_mat<T>& A, const dyn_mat<T>& B, arena& ws) {
+	assert(A.n() == B.m() && "A*B size mismatch");
+	dyn_mat<T> result(A.m(), B.n(), ws);
+	detail::mat_mat_accumulate(A, B, result);
+	return result;
+}
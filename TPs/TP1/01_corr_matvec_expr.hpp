@@ -0,0 +1,139 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Lazy expression templates for vec/mat arithmetic
+//
+// Same design as the et::terminal / et::node pair of the TP note: a node
+// stores an Op and a tuple of children, and evaluating the node evaluates
+// its children then applies Op to the results. Here the "arguments" of the
+// evaluation are a single flat element index, so a whole chain such as
+// a * x + y - z is computed in one loop, element by element, when it is
+// assigned to a vec or a mat, without any intermediate storage.
+
+namespace et {
+
+//------------------------------------------------------------------------------
+// The expr concept: T::is_expr() exists and is convertible to bool
+//------------------------------------------------------------------------------
+
+template <typename T>
+concept expr = requires {
+	{ T::is_expr() } -> std::convertible_to<bool>;
+};
+
+// Number of elements of a vec-like or mat-like result type
+template <typename R> constexpr std::size_t flat_size() {
+	if constexpr (requires { R::m(); }) {
+		return R::m() * R::n();
+	} else {
+		return R::size();
+	}
+}
+
+//------------------------------------------------------------------------------
+// terminal<V, R>: leaf wrapping a vec, a mat or a view
+//
+// V is a const reference for lvalue operands and a plain value for
+// temporaries, so an expression never outlives the data it reads. R is the
+// type the expression evaluates to.
+//------------------------------------------------------------------------------
+
+template <typename V, typename R> struct terminal {
+	using result_type = R;
+	using value_type = typename R::value_type;
+
+	static constexpr bool is_expr() { return true; }
+	static constexpr std::size_t size() { return flat_size<R>(); }
+
+	constexpr value_type operator()(std::size_t k) const {
+		if constexpr (requires { operand.data[k]; }) {
+			return operand.data[k];
+		} else {
+			return operand[k];
+		}
+	}
+
+	V operand;
+};
+
+//------------------------------------------------------------------------------
+// scalar<T>: leaf returning the same value for every index
+//------------------------------------------------------------------------------
+
+template <typename T> struct scalar {
+	constexpr T operator()(std::size_t) const { return value; }
+
+	T value;
+};
+
+// Result type of the first non-scalar child of a node
+template <typename... Children> struct first_result;
+
+template <typename C, typename... Children> struct first_result<C, Children...> {
+	using type = typename C::result_type;
+};
+
+template <typename T, typename... Children> struct first_result<scalar<T>, Children...> {
+	using type = typename first_result<Children...>::type;
+};
+
+//------------------------------------------------------------------------------
+// node<Op, Children...>
+//------------------------------------------------------------------------------
+
+template <typename Op, typename... Children> struct node {
+	using result_type = typename first_result<Children...>::type;
+	using value_type = typename result_type::value_type;
+
+	static constexpr bool is_expr() { return true; }
+	static constexpr std::size_t size() { return flat_size<result_type>(); }
+
+	constexpr node(Op o, Children... c) : op(o), children(std::move(c)...) {}
+
+	// Evaluates element k: every child is evaluated at k, then Op is applied
+	constexpr value_type operator()(std::size_t k) const {
+		return std::apply([&](auto const&... ch) { return static_cast<value_type>(op(ch(k)...)); }, children);
+	}
+
+	// vec-like and mat-like access to the same elements
+	constexpr value_type operator[](std::size_t k) const { return (*this)(k); }
+
+	// Element (i, j) sits at the flat index given by the result's layout
+	constexpr value_type operator()(std::size_t i, std::size_t j) const
+		requires requires { result_type::n(); } {
+		return (*this)(i * result_type::row_stride() + j * result_type::col_stride());
+	}
+
+	// Forces evaluation into a vec or a mat
+	constexpr result_type eval() const { return result_type(*this); }
+
+	Op op;
+	std::tuple<Children...> children;
+};
+
+//------------------------------------------------------------------------------
+// Element-wise operations
+//------------------------------------------------------------------------------
+
+struct add_ {
+	constexpr auto operator()(auto a, auto b) const { return a + b; }
+};
+
+struct sub_ {
+	constexpr auto operator()(auto a, auto b) const { return a - b; }
+};
+
+struct mul_ {
+	constexpr auto operator()(auto a, auto b) const { return a * b; }
+};
+
+struct fma_ {
+	constexpr auto operator()(auto a, auto b, auto c) const { return a * b + c; }
+};
+
+} // namespace et
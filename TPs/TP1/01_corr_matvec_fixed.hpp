@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+#include "01_corr_matvec_simd.hpp"
+
+// Fixed-point numbers and saturating integer arithmetic
+//
+// fixed<F, Rep> is a signed Q number with F fraction bits: the integer Rep
+// (int16 or int32) holds the value times 2^F. q15 = fixed<15> spans [-1, 1)
+// in steps of 2^-15, q7_8 = fixed<8> spans [-128, 128) in steps of 2^-8.
+// Every operation rounds to nearest and saturates to the range of Rep
+// instead of wrapping, like the fractional arithmetic of DSPs.
+//
+// dot() and the mat-vec products of fixed vectors and matrices are computed
+// differently from a chain of saturating + and *: the exact products are
+// summed in int64, then rounded and saturated once. This is more accurate,
+// and for int16 formats it runs on the raw values with pmaddwd
+// (simd::dot_i64). int32 formats round each product to F bits before
+// adding it to a saturating int64 sum.
+//
+// add_sat, sub_sat and mul_sat are the saturating operations on plain
+// integers (the C++26 functions of the same names).
+
+//------------------------------------------------------------------------------
+// Saturating integer arithmetic
+//------------------------------------------------------------------------------
+
+template <std::integral T> constexpr T add_sat(T a, T b) {
+	T r;
+	if (!__builtin_add_overflow(a, b, &r)) {
+		return r;
+	}
+	return std::is_signed_v<T> && b < T{} ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+}
+
+template <std::integral T> constexpr T sub_sat(T a, T b) {
+	T r;
+	if (!__builtin_sub_overflow(a, b, &r)) {
+		return r;
+	}
+	return std::is_signed_v<T> && b < T{} ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+}
+
+template <std::integral T> constexpr T mul_sat(T a, T b) {
+	T r;
+	if (!__builtin_mul_overflow(a, b, &r)) {
+		return r;
+	}
+	return (a < T{}) != (b < T{}) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+}
+
+namespace detail {
+
+// x clamped to the range of T
+template <typename T, typename W> constexpr T saturate(W x) {
+	if (x < static_cast<W>(std::numeric_limits<T>::min())) {
+		return std::numeric_limits<T>::min();
+	}
+	if (x > static_cast<W>(std::numeric_limits<T>::max())) {
+		return std::numeric_limits<T>::max();
+	}
+	return static_cast<T>(x);
+}
+
+// x / 2^F rounded to nearest (ties toward +inf)
+template <int F, typename W> constexpr W round_shift(W x) {
+	if constexpr (F == 0) {
+		return x;
+	} else {
+		return (x + (W(1) << (F - 1))) >> F;
+	}
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// fixed<F, Rep>
+//------------------------------------------------------------------------------
+
+template <int F, typename Rep = std::int16_t> struct fixed {
+	static_assert(std::is_same_v<Rep, std::int16_t> || std::is_same_v<Rep, std::int32_t>,
+	              "fixed needs an int16 or int32 representation");
+	static_assert(F >= 0 && F <= std::numeric_limits<Rep>::digits, "fixed: fraction bits out of range");
+
+	using rep = Rep;
+	// Holds the product of two raw values
+	using wide = std::conditional_t<sizeof(Rep) == 2, std::int32_t, std::int64_t>;
+	static constexpr int frac_bits = F;
+
+	Rep raw = 0;
+
+	//--------------------------------------------------------------------------
+	// Construction and conversion
+	//--------------------------------------------------------------------------
+
+	constexpr fixed() = default;
+
+	// Nearest representable value (ties away from zero), saturated; NaN gives 0
+	constexpr explicit fixed(double x) : raw(from_double(x)) {}
+
+	static constexpr fixed from_raw(Rep r) {
+		fixed result;
+		result.raw = r;
+		return result;
+	}
+
+	static constexpr fixed max() { return from_raw(std::numeric_limits<Rep>::max()); }
+	static constexpr fixed lowest() { return from_raw(std::numeric_limits<Rep>::min()); }
+	static constexpr fixed epsilon() { return from_raw(1); }
+
+	constexpr explicit operator double() const { return static_cast<double>(raw) / scale; }
+	constexpr explicit operator float() const { return static_cast<float>(static_cast<double>(*this)); }
+
+	//--------------------------------------------------------------------------
+	// Saturating arithmetic
+	//--------------------------------------------------------------------------
+
+	friend constexpr fixed operator+(fixed a, fixed b) {
+		return from_raw(detail::saturate<Rep>(static_cast<wide>(a.raw) + b.raw));
+	}
+
+	friend constexpr fixed operator-(fixed a, fixed b) {
+		return from_raw(detail::saturate<Rep>(static_cast<wide>(a.raw) - b.raw));
+	}
+
+	friend constexpr fixed operator-(fixed a) { return from_raw(detail::saturate<Rep>(-static_cast<wide>(a.raw))); }
+
+	friend constexpr fixed operator*(fixed a, fixed b) {
+		return from_raw(detail::saturate<Rep>(detail::round_shift<F>(static_cast<wide>(a.raw) * b.raw)));
+	}
+
+	friend constexpr fixed operator/(fixed a, fixed b) {
+		assert(b.raw != 0 && "fixed division by zero");
+		const wide n = static_cast<wide>(a.raw) * (wide(1) << F);
+		wide q = n / b.raw;
+		const wide r = n % b.raw;
+		if (2 * (r < 0 ? -r : r) >= (b.raw < 0 ? -static_cast<wide>(b.raw) : b.raw)) {
+			q += (n < 0) != (b.raw < 0) ? -1 : 1;
+		}
+		return from_raw(detail::saturate<Rep>(q));
+	}
+
+	constexpr fixed& operator+=(fixed b) { return *this = *this + b; }
+	constexpr fixed& operator-=(fixed b) { return *this = *this - b; }
+	constexpr fixed& operator*=(fixed b) { return *this = *this * b; }
+	constexpr fixed& operator/=(fixed b) { return *this = *this / b; }
+
+	friend constexpr bool operator==(const fixed&, const fixed&) = default;
+	friend constexpr auto operator<=>(const fixed&, const fixed&) = default;
+
+	private:
+	static constexpr double scale = static_cast<double>(std::int64_t{1} << F);
+
+	static constexpr Rep from_double(double x) {
+		const double y = x * scale;
+		if (!(y == y)) {
+			return 0;
+		}
+		if (y >= static_cast<double>(std::numeric_limits<Rep>::max())) {
+			return std::numeric_limits<Rep>::max();
+		}
+		if (y <= static_cast<double>(std::numeric_limits<Rep>::min())) {
+			return std::numeric_limits<Rep>::min();
+		}
+		return static_cast<Rep>(y >= 0 ? y + 0.5 : y - 0.5);
+	}
+};
+
+// Qm.n names count the integer bits without the sign bit
+using q15 = fixed<15>;
+using q7_8 = fixed<8>;
+using q31 = fixed<31, std::int32_t>;
+using q15_16 = fixed<16, std::int32_t>;
+
+namespace detail {
+
+// Raw values of contiguous fixed elements
+template <int F, typename Rep> const Rep* raw_data(const fixed<F, Rep>* p) {
+	static_assert(sizeof(fixed<F, Rep>) == sizeof(Rep) && std::is_standard_layout_v<fixed<F, Rep>>);
+	return reinterpret_cast<const Rep*>(p);
+}
+
+// Sum of a[i] * b[i], rounded and saturated once
+template <int F, typename Rep>
+constexpr fixed<F, Rep> dot_fixed(const fixed<F, Rep>* a, const fixed<F, Rep>* b, std::size_t n) {
+	std::int64_t acc = 0;
+	if constexpr (sizeof(Rep) == 2) {
+		if (std::is_constant_evaluated()) {
+			for (std::size_t i = 0; i < n; ++i) {
+				acc += std::int64_t{a[i].raw} * b[i].raw;
+			}
+		} else {
+			acc = simd::dot_i64(raw_data(a), raw_data(b), n);
+		}
+		return fixed<F, Rep>::from_raw(saturate<Rep>(round_shift<F>(acc)));
+	} else {
+		for (std::size_t i = 0; i < n; ++i) {
+			acc = add_sat(acc, round_shift<F>(std::int64_t{a[i].raw} * b[i].raw));
+		}
+		return fixed<F, Rep>::from_raw(saturate<Rep>(acc));
+	}
+}
+
+// y[i] = sum_j a[i * lda + j] * x[j], each row rounded and saturated once
+template <int F, typename Rep>
+constexpr void gemv_fixed(std::size_t m, std::size_t n, const fixed<F, Rep>* a, std::size_t lda,
+                          const fixed<F, Rep>* x, fixed<F, Rep>* y) {
+	for (std::size_t i = 0; i < m; ++i) {
+		y[i] = dot_fixed(a + i * lda, x, n);
+	}
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// Products with a single rounding
+//------------------------------------------------------------------------------
+
+template <int F, typename Rep, std::size_t N>
+constexpr fixed<F, Rep> dot(const vec<fixed<F, Rep>, N>& u, const vec<fixed<F, Rep>, N>& v) {
+	return detail::dot_fixed(u.data.data(), v.data.data(), N);
+}
+
+template <int F, typename Rep, std::size_t M, std::size_t N>
+constexpr vec<fixed<F, Rep>, M> operator*(const mat<fixed<F, Rep>, M, N>& A, const vec<fixed<F, Rep>, N>& x) {
+	vec<fixed<F, Rep>, M> result;
+	detail::gemv_fixed(M, N, A.data.data(), N, x.data.data(), result.data.data());
+	return result;
+}
+
+template <int F, typename Rep> fixed<F, Rep> dot(const dyn_vec<fixed<F, Rep>>& u, const dyn_vec<fixed<F, Rep>>& v) {
+	assert(u.size() == v.size() && "dot size mismatch");
+	return detail::dot_fixed(u.data(), v.data(), u.size());
+}
+
+template <int F, typename Rep>
+dyn_vec<fixed<F, Rep>> operator*(const dyn_mat<fixed<F, Rep>>& A, const dyn_vec<fixed<F, Rep>>& x) {
+	assert(A.n() == x.size() && "A*x size mismatch");
+	dyn_vec<fixed<F, Rep>> result(A.m());
+	detail::gemv_fixed(A.m(), A.n(), A.data(), A.ld(), x.data(), result.data());
+	return result;
+}
@@ -1,7 +1,51 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "01_corr_matvec_arena.hpp"
+#include "01_corr_matvec_expr.hpp"
+#include "01_corr_matvec_simd.hpp"
+
+//------------------------------------------------------------------------------
+// Fully unrolled kernels for small fixed sizes
+//
+// Up to unroll_max elements per dimension, dot products, element-wise
+// evaluation and the mat-vec / mat-mat products expand a fold expression
+// over a std::index_sequence instead of running a loop: every element is a
+// separate statement with constant indices, which the compiler keeps in
+// registers and vectorizes across statements, without relying on its loop
+// unrolling heuristics. The folds are constexpr and sum left to right, in
+// the same order as the loops they replace.
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+inline constexpr std::size_t unroll_max = 8;
+
+template <std::size_t... Ns>
+inline constexpr bool unrolled = ((Ns <= unroll_max) && ...);
+
+// f(std::integral_constant<std::size_t, I>{}) for I = 0 .. N - 1
+template <std::size_t N, typename F> constexpr void static_for(F&& f) {
+	[&]<std::size_t... I>(std::index_sequence<I...>) {
+		(f(std::integral_constant<std::size_t, I>{}), ...);
+	}(std::make_index_sequence<N>{});
+}
+
+// R{} + f(0) + ... + f(N - 1)
+template <typename R, std::size_t N, typename F> constexpr R static_sum(F&& f) {
+	return [&]<std::size_t... I>(std::index_sequence<I...>) {
+		return (R{} + ... + static_cast<R>(f(std::integral_constant<std::size_t, I>{})));
+	}(std::make_index_sequence<N>{});
+}
+
+} // namespace detail
 
 // Type vec(tor)
 
@@ -12,6 +56,8 @@
 // et un membre size().
 
 template <typename T, std::size_t N> struct vec {
+	using value_type = T;
+
 	// Storage
 	std::array<T, N> data;
 
@@ -27,6 +73,26 @@ template <typename T, std::size_t N> struct vec {
 		data.fill(value);
 	}
 
+	// Evaluates a lazy expression (see 01_corr_matvec_expr.hpp) in one pass
+	template <et::expr E>
+		requires std::is_same_v<typename E::result_type, vec>
+	constexpr vec(const E& e) {
+		*this = e;
+	}
+
+	template <et::expr E>
+		requires std::is_same_v<typename E::result_type, vec>
+	constexpr vec& operator=(const E& e) {
+		if constexpr (detail::unrolled<N>) {
+			detail::static_for<N>([&](auto i) { data[i] = e(i); });
+		} else {
+			for (std::size_t i = 0; i < N; ++i) {
+				data[i] = e(i);
+			}
+		}
+		return *this;
+	}
+
 	//--------------------------------------------------------------------------
 	// Element access
 	//--------------------------------------------------------------------------
@@ -50,6 +116,145 @@ template <typename T, std::size_t N> struct vec {
 	}
 };
 
+//------------------------------------------------------------------------------
+// Storage layouts
+//
+// A layout maps (i, j) to i * row_stride + j * col_stride in an M x N matrix.
+//------------------------------------------------------------------------------
+
+struct row_major {
+	static constexpr std::size_t row_stride(std::size_t, std::size_t n) { return n; }
+	static constexpr std::size_t col_stride(std::size_t, std::size_t) { return 1; }
+};
+
+struct col_major {
+	static constexpr std::size_t row_stride(std::size_t, std::size_t) { return 1; }
+	static constexpr std::size_t col_stride(std::size_t m, std::size_t) { return m; }
+};
+
+//------------------------------------------------------------------------------
+// Views
+//
+// Non-owning, strided windows into a matrix. row(i), col(j) and block() return
+// views instead of copies: reading them costs nothing, writing through them
+// (operator[], operator=, operator*=) modifies the parent matrix. A view must
+// not outlive the matrix it was taken from.
+//------------------------------------------------------------------------------
+
+// Anything indexable with a compile-time size: vec and the views below
+template <typename V>
+concept vector_like = requires(const V& v, std::size_t i) {
+	typename V::value_type;
+	{ V::size() } -> std::convertible_to<std::size_t>;
+	v[i];
+};
+
+// N elements of T, Stride elements apart. T is const for read-only views.
+template <typename T, std::size_t N, std::size_t Stride> struct strided_view {
+	using value_type = std::remove_const_t<T>;
+
+	constexpr explicit strided_view(T* first) : ptr(first) {}
+	constexpr strided_view(const strided_view&) = default;
+
+	// Assigning a view writes through to the parent, it never rebinds
+	constexpr strided_view& operator=(const strided_view& other)
+		requires(!std::is_const_v<T>) {
+		return assign(other);
+	}
+
+	template <vector_like V>
+		requires(!std::is_const_v<T> && V::size() == N)
+	constexpr strided_view& operator=(const V& other) {
+		return assign(other);
+	}
+
+	constexpr strided_view& operator*=(const value_type& alpha)
+		requires(!std::is_const_v<T>) {
+		for (std::size_t i = 0; i < N; ++i) {
+			(*this)[i] *= alpha;
+		}
+		return *this;
+	}
+
+	// Element access
+	constexpr T& operator[](std::size_t i) const {
+		return ptr[i * Stride];
+	}
+
+	constexpr T* data() const { return ptr; }
+
+	static constexpr std::size_t size() { return N; }
+	static constexpr std::size_t stride() { return Stride; }
+
+	// Materialize into an owning vec
+	constexpr operator vec<value_type, N>() const {
+		vec<value_type, N> result;
+		for (std::size_t i = 0; i < N; ++i) {
+			result[i] = (*this)[i];
+		}
+		return result;
+	}
+
+	private:
+	template <typename V> constexpr strided_view& assign(const V& other) {
+		for (std::size_t i = 0; i < N; ++i) {
+			(*this)[i] = other[i];
+		}
+		return *this;
+	}
+
+	T* ptr;
+};
+
+// A row is contiguous, a column of an M x N row-major matrix has stride N
+template <typename T, std::size_t N> using row_view = strided_view<T, N, 1>;
+template <typename T, std::size_t M, std::size_t N> using col_view = strided_view<T, M, N>;
+
+// R x C sub-matrix (or transposed matrix) whose element (i, j) lives at
+// i * RS + j * CS from the first one
+template <typename T, std::size_t R, std::size_t C, std::size_t RS, std::size_t CS = 1> struct block_view {
+	using value_type = std::remove_const_t<T>;
+
+	constexpr explicit block_view(T* first) : ptr(first) {}
+	constexpr block_view(const block_view&) = default;
+
+	// Assigning a block copies the elements into the parent
+	constexpr block_view& operator=(const block_view& other)
+		requires(!std::is_const_v<T>) {
+		for (std::size_t i = 0; i < R; ++i) {
+			row(i) = other.row(i);
+		}
+		return *this;
+	}
+
+	static constexpr std::size_t m() { return R; }
+	static constexpr std::size_t n() { return C; }
+	static constexpr std::size_t row_stride() { return RS; }
+	static constexpr std::size_t col_stride() { return CS; }
+
+	constexpr T& operator()(std::size_t i, std::size_t j) const {
+		return ptr[i * RS + j * CS];
+	}
+
+	constexpr T* data() const { return ptr; }
+
+	constexpr strided_view<T, C, CS> row(std::size_t i) const {
+		return strided_view<T, C, CS>(ptr + i * RS);
+	}
+
+	constexpr strided_view<T, R, RS> col(std::size_t j) const {
+		return strided_view<T, R, RS>(ptr + j * CS);
+	}
+
+	// O(1) transpose: same elements, strides swapped
+	constexpr block_view<T, C, R, CS, RS> transpose() const {
+		return block_view<T, C, R, CS, RS>(ptr);
+	}
+
+	private:
+	T* ptr;
+};
+
 // Sur le meme modele, implementez mat qui est un type matrice.
 // Elle doit fournir un constructeur par valeur pour initialiser le contenu,
 // des membres m() et n() pour acceder aux dimensions (respectivement hauteur
@@ -58,7 +263,12 @@ template <typename T, std::size_t N> struct vec {
 // row(std::size_t), qui permettent d'extraire respectivement une colonne ou une
 // ligne de la matrice.
 
-template <typename T, std::size_t M, std::size_t N> struct mat {
+// Layout selects row-major (default) or column-major storage.
+
+template <typename T, std::size_t M, std::size_t N, typename Layout = row_major> struct mat {
+	using value_type = T;
+	using layout_type = Layout;
+
 	// We store M*N elements contiguously
 	std::array<T, M * N> data;
 
@@ -74,6 +284,38 @@ template <typename T, std::size_t M, std::size_t N> struct mat {
 		data.fill(value);
 	}
 
+	// Copies any matrix of the same shape: other layout, block or transpose view
+	template <typename A>
+		requires(!std::is_same_v<A, mat> && requires(const A& a) { a(0, 0); }
+		         && A::m() == M && A::n() == N)
+	constexpr explicit mat(const A& a) {
+		for (std::size_t i = 0; i < M; ++i) {
+			for (std::size_t j = 0; j < N; ++j) {
+				(*this)(i, j) = a(i, j);
+			}
+		}
+	}
+
+	// Evaluates a lazy expression (see 01_corr_matvec_expr.hpp) in one pass
+	template <et::expr E>
+		requires std::is_same_v<typename E::result_type, mat>
+	constexpr mat(const E& e) {
+		*this = e;
+	}
+
+	template <et::expr E>
+		requires std::is_same_v<typename E::result_type, mat>
+	constexpr mat& operator=(const E& e) {
+		if constexpr (detail::unrolled<M, N>) {
+			detail::static_for<M * N>([&](auto k) { data[k] = e(k); });
+		} else {
+			for (std::size_t k = 0; k < M * N; ++k) {
+				data[k] = e(k);
+			}
+		}
+		return *this;
+	}
+
 	//--------------------------------------------------------------------------
 	// Dimensions
 	//--------------------------------------------------------------------------
@@ -81,52 +323,141 @@ template <typename T, std::size_t M, std::size_t N> struct mat {
 	static constexpr std::size_t m() { return M; }
 	static constexpr std::size_t n() { return N; }
 
+	// Distance between (i, j) and (i + 1, j), resp. (i, j + 1)
+	static constexpr std::size_t row_stride() { return Layout::row_stride(M, N); }
+	static constexpr std::size_t col_stride() { return Layout::col_stride(M, N); }
+
 	//--------------------------------------------------------------------------
 	// Element access
 	//--------------------------------------------------------------------------
 	
 	// Non-const element access (i = row, j = column)
 	constexpr T& operator()(std::size_t i, std::size_t j) {
-		return data[i * N + j];
+		return data[i * row_stride() + j * col_stride()];
 	}
 
 	// Const element access
 	constexpr const T& operator()(std::size_t i, std::size_t j) const {
-		return data[i * N + j];
+		return data[i * row_stride() + j * col_stride()];
 	}
 
 	//--------------------------------------------------------------------------
-	// Extract a full column as a vec<T,M>
+	// Column / row / sub-matrix views (no copy, write-through when non-const)
 	//--------------------------------------------------------------------------
 	
-	constexpr vec<T, M> col(std::size_t j) const {
-		vec<T, M> result;
-		for (std::size_t i = 0; i < M; ++i) {
-			result[i] = (*this)(i, j);
-		}
-		return result;
+	constexpr strided_view<const T, M, row_stride()> col(std::size_t j) const {
+		return strided_view<const T, M, row_stride()>(data.data() + j * col_stride());
+	}
+
+	constexpr strided_view<T, M, row_stride()> col(std::size_t j) {
+		return strided_view<T, M, row_stride()>(data.data() + j * col_stride());
+	}
+
+	constexpr strided_view<const T, N, col_stride()> row(std::size_t i) const {
+		return strided_view<const T, N, col_stride()>(data.data() + i * row_stride());
+	}
+
+	constexpr strided_view<T, N, col_stride()> row(std::size_t i) {
+		return strided_view<T, N, col_stride()>(data.data() + i * row_stride());
+	}
+
+	// R x C block whose top-left corner is (i, j)
+	template <std::size_t R, std::size_t C>
+	constexpr block_view<const T, R, C, row_stride(), col_stride()> block(std::size_t i, std::size_t j) const {
+		static_assert(R <= M && C <= N, "block larger than the matrix");
+		return block_view<const T, R, C, row_stride(), col_stride()>(data.data() + i * row_stride() + j * col_stride());
+	}
+
+	template <std::size_t R, std::size_t C>
+	constexpr block_view<T, R, C, row_stride(), col_stride()> block(std::size_t i, std::size_t j) {
+		static_assert(R <= M && C <= N, "block larger than the matrix");
+		return block_view<T, R, C, row_stride(), col_stride()>(data.data() + i * row_stride() + j * col_stride());
 	}
 
 	//--------------------------------------------------------------------------
-	// Extract a full row as a vec<T,N>
+	// O(1) transpose: a view with the strides swapped, no data is moved
 	//--------------------------------------------------------------------------
-	
-	constexpr vec<T, N> row(std::size_t i) const {
-		vec<T, N> result;
-		for (std::size_t j = 0; j < N; ++j) {
-			result[j] = (*this)(i, j);
-		}
-		return result;
+
+	constexpr block_view<const T, N, M, col_stride(), row_stride()> transpose() const {
+		return block_view<const T, N, M, col_stride(), row_stride()>(data.data());
+	}
+
+	constexpr block_view<T, N, M, col_stride(), row_stride()> transpose() {
+		return block_view<T, N, M, col_stride(), row_stride()>(data.data());
 	}
 };
 
 // Implementez dot(vec, vec) qui effectue un produit scalaire
 // entre deux vecteurs
 
-template <typename T, std::size_t N> constexpr T dot(const vec<T, N>& u, const vec<T, N>& v){
-	T result {};
+// Vectors of at least one SIMD register go through the explicit SIMD kernels
+// at runtime; the loops below remain the constexpr/scalar path.
+namespace detail {
+template <typename T, std::size_t N>
+inline constexpr bool use_simd = simd::vectorized<T> && N >= simd::lanes<T>();
+} // namespace detail
+
+// Type in which reductions over T accumulate. Narrow integers are widened
+// so that dot products of 8/16-bit data do not overflow; other types
+// accumulate in themselves. Specialize it to change the default.
+template <typename T> struct accumulator {
+	using type = T;
+};
+
+template <> struct accumulator<std::int8_t> {
+	using type = std::int32_t;
+};
+
+template <> struct accumulator<std::uint8_t> {
+	using type = std::int32_t;
+};
+
+template <> struct accumulator<std::int16_t> {
+	using type = std::int32_t;
+};
+
+template <> struct accumulator<std::uint16_t> {
+	using type = std::int64_t;
+};
+
+template <typename T> using accumulator_t = typename accumulator<T>::type;
+
+namespace detail {
+
+// Acc as given to dot<Acc>() / multiply<Acc>(), void selecting the default
+template <typename Acc, typename T>
+using accumulate_t = std::conditional_t<std::is_void_v<Acc>, accumulator_t<T>, Acc>;
+
+// Runtime kernel for a reduction of n contiguous T into R, if there is one
+template <typename R, typename T>
+inline constexpr bool has_dot_kernel = (std::is_same_v<R, T> && simd::vectorized<T>)
+	|| (std::is_same_v<R, std::int32_t> && simd::widened<T>);
+
+template <typename R, typename T> R dot_kernel(const T* a, const T* b, std::size_t n) {
+	if constexpr (std::is_same_v<R, T>) {
+		return simd::dot(a, b, n);
+	} else {
+		return simd::dot_i32(a, b, n);
+	}
+}
+
+} // namespace detail
+
+// dot<Acc>(u, v) accumulates in Acc (default: accumulator_t<T>)
+template <typename Acc = void, typename T, std::size_t N>
+constexpr detail::accumulate_t<Acc, T> dot(const vec<T, N>& u, const vec<T, N>& v){
+	using R = detail::accumulate_t<Acc, T>;
+	if constexpr (detail::unrolled<N>) {
+		return detail::static_sum<R, N>([&](auto i) { return static_cast<R>(u[i]) * static_cast<R>(v[i]); });
+	}
+	if constexpr (detail::has_dot_kernel<R, T> && N >= simd::lanes<T>()) {
+		if (!std::is_constant_evaluated()) {
+			return detail::dot_kernel<R>(u.data.data(), v.data.data(), N);
+		}
+	}
+	R result {};
 	for (std::size_t i = 0; i < N; ++i){
-		result += u[i] * v[i];
+		result += static_cast<R>(u[i]) * static_cast<R>(v[i]);
 	}
 	return result;
 }
@@ -147,68 +478,615 @@ constexpr mat<T, M, N> operator*(const vec<T, M>& u, const vec<T, N>& v){
 	return result;
 }
 
+//------------------------------------------------------------------------------
+// Lazy element-wise arithmetic
+//
+// Scaling, +, - and fma on vec, mat and views return et::node expressions.
+// Nothing is computed until the expression is assigned to a vec or a mat,
+// and then the whole chain runs as a single fused loop.
+//------------------------------------------------------------------------------
+
+namespace et {
+
+// Maps an operand type to the vec/mat type it evaluates to
+template <typename V> struct operand_traits {};
+
+template <typename T, std::size_t N> struct operand_traits<vec<T, N>> {
+	using result_type = vec<T, N>;
+};
+
+template <typename T, std::size_t M, std::size_t N, typename L> struct operand_traits<mat<T, M, N, L>> {
+	using result_type = mat<T, M, N, L>;
+};
+
+template <typename T, std::size_t N, std::size_t S> struct operand_traits<strided_view<T, N, S>> {
+	using result_type = vec<std::remove_const_t<T>, N>;
+};
+
+template <expr E> struct operand_traits<E> {
+	using result_type = typename E::result_type;
+};
+
+template <typename V>
+concept operand = requires { typename operand_traits<std::remove_cvref_t<V>>::result_type; };
+
+template <typename V>
+using result_of = typename operand_traits<std::remove_cvref_t<V>>::result_type;
+
+// Wraps an operand as an expression child: lvalues by reference, temporaries
+// by value, expressions as they are and arithmetic values as scalars
+template <typename V> constexpr auto leaf(V&& v) {
+	using D = std::remove_cvref_t<V>;
+	if constexpr (std::is_arithmetic_v<D>) {
+		return scalar<D>{v};
+	} else if constexpr (expr<D>) {
+		return D(std::forward<V>(v));
+	} else if constexpr (std::is_lvalue_reference_v<V>) {
+		return terminal<const D&, result_of<D>>{v};
+	} else {
+		return terminal<D, result_of<D>>{std::move(v)};
+	}
+}
+
+template <typename V>
+concept operand_or_scalar = operand<V> || std::is_arithmetic_v<std::remove_cvref_t<V>>;
+
+} // namespace et
+
+template <et::operand L, et::operand R>
+	requires std::is_same_v<et::result_of<L>, et::result_of<R>>
+constexpr auto operator+(L&& l, R&& r) {
+	return et::node{et::add_{}, et::leaf(std::forward<L>(l)), et::leaf(std::forward<R>(r))};
+}
+
+template <et::operand L, et::operand R>
+	requires std::is_same_v<et::result_of<L>, et::result_of<R>>
+constexpr auto operator-(L&& l, R&& r) {
+	return et::node{et::sub_{}, et::leaf(std::forward<L>(l)), et::leaf(std::forward<R>(r))};
+}
+
 // Implementez un operator* qui multiplie les valeurs de u par n
 // (en faisant une copie ou transfert du vector)
 
-template <typename T, std::size_t N>
-constexpr vec<T, N> operator*(const vec<T, N>& u, const T& n) {
-	vec<T, N> result;
-	for (std::size_t i = 0; i < N; ++i) {
-		result[i] = u[i] * n;
-	}
-	return result;
+// The scalar type is deduced and must be the element type, as with the eager
+// operator*: vec<int, N>{} * 0.5 does not compile instead of truncating 0.5
+
+template <et::operand L, typename S>
+	requires std::same_as<S, typename et::result_of<L>::value_type>
+constexpr auto operator*(L&& u, const S& n) {
+	return et::node{et::mul_{}, et::leaf(std::forward<L>(u)), et::leaf(n)};
 }
 
 // Produit inverse (facultatif)
 
+template <typename S, et::operand R>
+	requires std::same_as<S, typename et::result_of<R>::value_type>
+constexpr auto operator*(const S& alpha, R&& u) {
+	return et::node{et::mul_{}, et::leaf(alpha), et::leaf(std::forward<R>(u))};
+}
+
+// Element-wise a * b + c; any argument may be a scalar, at least one is not
+template <et::operand_or_scalar A, et::operand_or_scalar B, et::operand_or_scalar C>
+	requires(et::operand<A> || et::operand<B> || et::operand<C>)
+constexpr auto fma(A&& a, B&& b, C&& c) {
+	return et::node{et::fma_{}, et::leaf(std::forward<A>(a)), et::leaf(std::forward<B>(b)),
+	                et::leaf(std::forward<C>(c))};
+}
+
+// In-place updates, evaluated in a single pass as well
+template <typename T, std::size_t N, et::operand R>
+	requires std::is_same_v<et::result_of<R>, vec<T, N>>
+constexpr vec<T, N>& operator+=(vec<T, N>& y, R&& r) {
+	return y = y + std::forward<R>(r);
+}
+
+template <typename T, std::size_t N, et::operand R>
+	requires std::is_same_v<et::result_of<R>, vec<T, N>>
+constexpr vec<T, N>& operator-=(vec<T, N>& y, R&& r) {
+	return y = y - std::forward<R>(r);
+}
+
 template <typename T, std::size_t N>
-constexpr vec<T, N> operator*(const T& alpha, const vec<T, N>& u) {
-	return u * alpha;
+constexpr vec<T, N>& operator*=(vec<T, N>& y, const T& alpha) {
+	return y = y * alpha;
 }
 
-// Implementez un produit matrice/vecteur via l'operator*
+template <typename T, std::size_t M, std::size_t N, typename L, et::operand R>
+	requires std::is_same_v<et::result_of<R>, mat<T, M, N, L>>
+constexpr mat<T, M, N, L>& operator+=(mat<T, M, N, L>& y, R&& r) {
+	return y = y + std::forward<R>(r);
+}
 
-template <typename T, std::size_t M, std::size_t N>
-constexpr vec<T, M> operator*(const mat<T, M, N>& A, const vec<T, N>& x) {
-	vec<T, M> result;
-	for (std::size_t i = 0; i < M; ++i) {
-		T sum{};
-		for (std::size_t j = 0; j < N; ++j) {
-			sum += A(i, j) * x[j];
+template <typename T, std::size_t M, std::size_t N, typename L, et::operand R>
+	requires std::is_same_v<et::result_of<R>, mat<T, M, N, L>>
+constexpr mat<T, M, N, L>& operator-=(mat<T, M, N, L>& y, R&& r) {
+	return y = y - std::forward<R>(r);
+}
+
+template <typename T, std::size_t M, std::size_t N, typename L>
+constexpr mat<T, M, N, L>& operator*=(mat<T, M, N, L>& y, const T& alpha) {
+	return y = y * alpha;
+}
+
+//------------------------------------------------------------------------------
+// Products on views and layouts
+//
+// The products below accept any mix of vec, views, and matrices of either
+// layout (including transpose() views). Each one picks the loop order that
+// walks memory contiguously for the layouts at hand, and contiguous operands
+// go through the SIMD kernels.
+//------------------------------------------------------------------------------
+
+// mat and block_view: compile-time shape and strides, (i, j) access
+template <typename A>
+concept matrix_like = requires(const A& a, std::size_t i) {
+	typename A::value_type;
+	{ A::m() } -> std::convertible_to<std::size_t>;
+	{ A::n() } -> std::convertible_to<std::size_t>;
+	{ A::row_stride() } -> std::convertible_to<std::size_t>;
+	{ A::col_stride() } -> std::convertible_to<std::size_t>;
+	a(i, i);
+};
+
+namespace detail {
+
+template <typename V> constexpr auto* contiguous_data(const V& v) {
+	if constexpr (requires { v.data.data(); }) {
+		return v.data.data();
+	} else {
+		return v.data();
+	}
+}
+
+template <typename V> constexpr bool contiguous() {
+	if constexpr (requires { V::stride(); }) {
+		return V::stride() == 1;
+	} else {
+		return requires(const V& v) { v.data.data(); };
+	}
+}
+
+template <typename V>
+inline constexpr bool use_simd_on = contiguous<V>() && use_simd<typename V::value_type, V::size()>;
+
+} // namespace detail
+
+template <typename Acc = void, vector_like U, vector_like V>
+	requires(U::size() == V::size() && std::is_same_v<typename U::value_type, typename V::value_type>)
+constexpr detail::accumulate_t<Acc, typename U::value_type> dot(const U& u, const V& v) {
+	using T = typename U::value_type;
+	using R = detail::accumulate_t<Acc, T>;
+	if constexpr (detail::unrolled<U::size()>) {
+		return detail::static_sum<R, U::size()>(
+			[&](auto i) { return static_cast<R>(u[i]) * static_cast<R>(v[i]); });
+	}
+	if constexpr (detail::contiguous<U>() && detail::contiguous<V>() && detail::has_dot_kernel<R, T>
+	              && U::size() >= simd::lanes<T>()) {
+		if (!std::is_constant_evaluated()) {
+			return detail::dot_kernel<R>(detail::contiguous_data(u), detail::contiguous_data(v), U::size());
 		}
-		result[i] = sum;
+	}
+	R result{};
+	for (std::size_t i = 0; i < U::size(); ++i) {
+		result += static_cast<R>(u[i]) * static_cast<R>(v[i]);
 	}
 	return result;
 }
 
+// Implementez un produit matrice/vecteur via l'operator*
+
+// Contiguous rows: one dot product per row (SIMD gemv).
+// Contiguous columns: y accumulates x[j] * column j.
+template <matrix_like A, vector_like V>
+	requires(V::size() == A::n() && std::is_same_v<typename V::value_type, typename A::value_type>)
+constexpr vec<typename A::value_type, A::m()> operator*(const A& a, const V& x) {
+	using T = typename A::value_type;
+	constexpr std::size_t M = A::m();
+	constexpr std::size_t N = A::n();
+
+	// A lazy x would be re-evaluated for every row
+	if constexpr (et::expr<V>) {
+		return a * x.eval();
+	} else {
+		vec<T, M> result;
+		if constexpr (detail::unrolled<M, N>) {
+			detail::static_for<M>([&](auto i) {
+				result[i] = detail::static_sum<T, N>([&](auto j) { return a(i, j) * x[j]; });
+			});
+			return result;
+		}
+		if constexpr (A::col_stride() == 1 && detail::use_simd_on<V>) {
+			if (!std::is_constant_evaluated()) {
+				simd::gemv<T>(M, N, detail::contiguous_data(a), A::row_stride(), detail::contiguous_data(x),
+				              result.data.data());
+				return result;
+			}
+		}
+		if constexpr (A::row_stride() == 1 && A::col_stride() != 1) {
+			for (std::size_t j = 0; j < N; ++j) {
+				const T xj = x[j];
+				for (std::size_t i = 0; i < M; ++i) {
+					result[i] += a(i, j) * xj;
+				}
+			}
+		} else {
+			for (std::size_t i = 0; i < M; ++i) {
+				result[i] = dot(a.row(i), x);
+			}
+		}
+		return result;
+	}
+}
+
 // Implementez un produit vecteur/matrice via l'operator*
 
-template <typename T, std::size_t M, std::size_t N>
-constexpr vec<T, N> operator*(const vec<T, M>& x, const mat<T, M, N>& A) {
-	vec<T, N> result;
-	for (std::size_t j = 0; j < N; ++j) {
-		T sum{};
-		for (std::size_t i = 0; i < M; ++i) {
-			sum += x[i] * A(i, j);
+// Contiguous columns: one dot product per column.
+// Contiguous rows: y accumulates x[i] * row i, instead of walking columns.
+template <vector_like V, matrix_like A>
+	requires(V::size() == A::m() && std::is_same_v<typename V::value_type, typename A::value_type>)
+constexpr vec<typename A::value_type, A::n()> operator*(const V& x, const A& a) {
+	using T = typename A::value_type;
+	constexpr std::size_t M = A::m();
+	constexpr std::size_t N = A::n();
+
+	if constexpr (et::expr<V>) {
+		return x.eval() * a;
+	} else {
+		vec<T, N> result;
+		if constexpr (detail::unrolled<M, N>) {
+			detail::static_for<N>([&](auto j) {
+				result[j] = detail::static_sum<T, M>([&](auto i) { return x[i] * a(i, j); });
+			});
+			return result;
 		}
-		result[j] = sum;
+		if constexpr (A::row_stride() == 1 && A::col_stride() != 1) {
+			for (std::size_t j = 0; j < N; ++j) {
+				result[j] = dot(x, a.col(j));
+			}
+		} else {
+			for (std::size_t i = 0; i < M; ++i) {
+				const T xi = x[i];
+				for (std::size_t j = 0; j < N; ++j) {
+					result[j] += xi * a(i, j);
+				}
+			}
+		}
+		return result;
 	}
-	return result;
 }
 
-// Implementez un produit matrice/matrice via l'operator*
+//------------------------------------------------------------------------------
+// Blocked GEMM kernel
+//
+// The naive i-j-k loop walks B column-wise and thrashes L1 as soon as the
+// operands stop fitting in cache. Large products go through a GotoBLAS-style
+// kernel instead: A and B are packed into contiguous panels sized for the
+// cache hierarchy, and a micro-kernel accumulates an MR x NR tile of C in
+// registers. The micro-kernel loops have fixed trip counts so the compiler
+// turns them into vector code.
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+// Width (in bytes) of the widest vector registers we compile for
+#if defined(__AVX512F__)
+inline constexpr std::size_t simd_bytes = 64;
+#elif defined(__AVX__)
+inline constexpr std::size_t simd_bytes = 32;
+#else
+inline constexpr std::size_t simd_bytes = 16;
+#endif
+
+// Register and cache tile sizes for the blocked product.
+// mr x nr is the register tile (12 vector accumulators), kc x nr panels of B
+// stay in L1, mc x kc blocks of A stay in L2 and kc x nc panels of B in L3.
+template <typename T>
+struct gemm_blocking {
+	static constexpr std::size_t round_up(std::size_t x, std::size_t r) {
+		return (x + r - 1) / r * r;
+	}
+
+	static constexpr std::size_t mr = 6;
+	static constexpr std::size_t nr = 2 * std::max<std::size_t>(simd_bytes / sizeof(T), 1);
+	static constexpr std::size_t kc = (16 * 1024) / (nr * sizeof(T));
+	static constexpr std::size_t mc = round_up((128 * 1024) / (kc * sizeof(T)), mr);
+	static constexpr std::size_t nc = round_up((2 * 1024 * 1024) / (kc * sizeof(T)), nr);
+};
+
+// Tile sizes for a C(MxP) = A(MxN) * B(NxP) product with dimensions known at
+// compile time. Cache tiles are clamped to the (rounded-up) problem size so
+// small operands don't pay for oversized packing buffers.
+template <typename T, std::size_t M, std::size_t N, std::size_t P>
+struct gemm_tiles : gemm_blocking<T> {
+	using base = gemm_blocking<T>;
+	static constexpr std::size_t kc = std::min<std::size_t>(N, (16 * 1024) / (base::nr * sizeof(T)));
+	static constexpr std::size_t mc = std::min(base::round_up(M, base::mr),
+	                                           base::round_up((128 * 1024) / (kc * sizeof(T)), base::mr));
+	static constexpr std::size_t nc = std::min(base::round_up(P, base::nr),
+	                                           base::round_up((2 * 1024 * 1024) / (kc * sizeof(T)), base::nr));
+};
+
+// Below this amount of work the packing overhead is not worth it
+template <typename T>
+constexpr bool gemm_worth_blocking(std::size_t m, std::size_t n, std::size_t k) {
+	return std::is_arithmetic_v<T> && m >= gemm_blocking<T>::mr && n >= gemm_blocking<T>::nr
+		&& m * n * k >= 32 * 32 * 32;
+}
 
 template <typename T, std::size_t M, std::size_t N, std::size_t P>
-constexpr mat<T, M, P> operator*(const mat<T, M, N>& A, const mat<T, N, P>& B) {
-	mat<T, M, P> result;
+inline constexpr bool gemm_use_blocked = gemm_worth_blocking<T>(M, P, N);
+
+// Packs an mc x kc block of A into row panels of mr rows. Element (i, k) is
+// read at a[i * rsa + k * csa], so any layout or transposed view can be
+// packed. Within a panel, the mr values of each column k are contiguous.
+// Rows past the end of the block are zero-padded. The packed values are
+// scaled by alpha, which folds the alpha of gemm() into the packing.
+template <typename T, std::size_t MR>
+void gemm_pack_a(std::size_t mc, std::size_t kc, const T* a, std::size_t rsa, std::size_t csa, T* packed,
+                 T alpha = T(1)) {
+	for (std::size_t ir = 0; ir < mc; ir += MR) {
+		const std::size_t rows = std::min(MR, mc - ir);
+		for (std::size_t k = 0; k < kc; ++k) {
+			const T* src = a + ir * rsa + k * csa;
+			for (std::size_t i = 0; i < rows; ++i) {
+				packed[i] = alpha * src[i * rsa];
+			}
+			for (std::size_t i = rows; i < MR; ++i) {
+				packed[i] = T{};
+			}
+			packed += MR;
+		}
+	}
+}
+
+// Packs a kc x nc panel of B (element (k, j) at b[k * rsb + j * csb]) into
+// column panels of nr columns. Within a panel, the nr values of each row k
+// are contiguous.
+template <typename T, std::size_t NR>
+void gemm_pack_b(std::size_t kc, std::size_t nc, const T* b, std::size_t rsb, std::size_t csb, T* packed) {
+	for (std::size_t jr = 0; jr < nc; jr += NR) {
+		const std::size_t cols = std::min(NR, nc - jr);
+		for (std::size_t k = 0; k < kc; ++k) {
+			const T* src = b + k * rsb + jr * csb;
+			if (csb == 1) {
+				for (std::size_t j = 0; j < cols; ++j) {
+					packed[j] = src[j];
+				}
+			} else {
+				for (std::size_t j = 0; j < cols; ++j) {
+					packed[j] = src[j * csb];
+				}
+			}
+			for (std::size_t j = cols; j < NR; ++j) {
+				packed[j] = T{};
+			}
+			packed += NR;
+		}
+	}
+}
+
+// C(rows x cols) += Apanel * Bpanel over kc, with rows <= MR and cols <= NR.
+// Element (i, j) of C is c[i * rsc + j * csc].
+template <typename T, std::size_t MR, std::size_t NR>
+void gemm_micro_kernel(std::size_t kc, const T* __restrict a, const T* __restrict b,
+                       T* __restrict c, std::size_t rsc, std::size_t csc, std::size_t rows, std::size_t cols) {
+	T acc[MR][NR] = {};
+	for (std::size_t k = 0; k < kc; ++k) {
+#pragma GCC unroll 16
+		for (std::size_t i = 0; i < MR; ++i) {
+			const T aik = a[i];
+#pragma GCC unroll 64
+			for (std::size_t j = 0; j < NR; ++j) {
+				acc[i][j] += aik * b[j];
+			}
+		}
+		a += MR;
+		b += NR;
+	}
+
+	if (rows == MR && cols == NR && csc == 1) {
+		for (std::size_t i = 0; i < MR; ++i) {
+			for (std::size_t j = 0; j < NR; ++j) {
+				c[i * rsc + j] += acc[i][j];
+			}
+		}
+	} else {
+		for (std::size_t i = 0; i < rows; ++i) {
+			for (std::size_t j = 0; j < cols; ++j) {
+				c[i * rsc + j * csc] += acc[i][j];
+			}
+		}
+	}
+}
+
+// C(m x n) += alpha * A(m x k) * B(k x n) where every operand is described
+// by its row and column strides. Packing buffers are per thread and reused.
+template <typename T, typename Tiles>
+void gemm_blocked(std::size_t m, std::size_t n, std::size_t k,
+                  const T* a, std::size_t rsa, std::size_t csa,
+                  const T* b, std::size_t rsb, std::size_t csb,
+                  T* c, std::size_t rsc, std::size_t csc, T alpha = T(1)) {
+	constexpr std::size_t MR = Tiles::mr;
+	constexpr std::size_t NR = Tiles::nr;
+	constexpr std::size_t MC = Tiles::mc;
+	constexpr std::size_t KC = Tiles::kc;
+	constexpr std::size_t NC = Tiles::nc;
+
+	thread_local aligned_buffer<T> packed_a;
+	thread_local aligned_buffer<T> packed_b;
+	if (packed_a.size() < MC * KC) {
+		packed_a = aligned_buffer<T>(MC * KC);
+	}
+	if (packed_b.size() < KC * NC) {
+		packed_b = aligned_buffer<T>(KC * NC);
+	}
+
+	for (std::size_t jc = 0; jc < n; jc += NC) {
+		const std::size_t nc = std::min(NC, n - jc);
+		for (std::size_t pc = 0; pc < k; pc += KC) {
+			const std::size_t kc = std::min(KC, k - pc);
+			gemm_pack_b<T, NR>(kc, nc, b + pc * rsb + jc * csb, rsb, csb, packed_b.data());
+
+			for (std::size_t ic = 0; ic < m; ic += MC) {
+				const std::size_t mc = std::min(MC, m - ic);
+				gemm_pack_a<T, MR>(mc, kc, a + ic * rsa + pc * csa, rsa, csa, packed_a.data(), alpha);
+
+				for (std::size_t jr = 0; jr < nc; jr += NR) {
+					for (std::size_t ir = 0; ir < mc; ir += MR) {
+						gemm_micro_kernel<T, MR, NR>(
+							kc, packed_a.data() + ir * kc, packed_b.data() + jr * kc,
+							c + (ic + ir) * rsc + (jc + jr) * csc, rsc, csc,
+							std::min(MR, mc - ir), std::min(NR, nc - jr));
+					}
+				}
+			}
+		}
+	}
+}
+
+// Same product on row-major operands with leading dimensions lda, ldb, ldc
+template <typename T, typename Tiles>
+void gemm_blocked(std::size_t m, std::size_t n, std::size_t k,
+                  const T* a, std::size_t lda, const T* b, std::size_t ldb,
+                  T* c, std::size_t ldc) {
+	gemm_blocked<T, Tiles>(m, n, k, a, lda, 1, b, ldb, 1, c, ldc, 1);
+}
+
+// Layout of A * B: column-major only when both operands are column-major
+template <matrix_like A, matrix_like B>
+using product_layout = std::conditional_t<A::row_stride() == 1 && A::col_stride() != 1
+                                          && B::row_stride() == 1 && B::col_stride() != 1,
+                                          col_major, row_major>;
+
+} // namespace detail
+
+// Implementez un produit matrice/matrice via l'operator*
+
+// Large products are dispatched to the blocked kernel at runtime, which packs
+// either layout or a transposed view into the same panels. Products with
+// every dimension up to unroll_max are fully unrolled; the other small ones
+// and constant evaluation keep the plain triple loop.
+template <matrix_like A, matrix_like B>
+	requires(A::n() == B::m() && std::is_same_v<typename A::value_type, typename B::value_type>)
+constexpr mat<typename A::value_type, A::m(), B::n(), detail::product_layout<A, B>>
+operator*(const A& a, const B& b) {
+	using T = typename A::value_type;
+	constexpr std::size_t M = A::m();
+	constexpr std::size_t N = A::n();
+	constexpr std::size_t P = B::n();
+
+	mat<T, M, P, detail::product_layout<A, B>> result;
+	if constexpr (detail::unrolled<M, N, P>) {
+		detail::static_for<M * P>([&](auto ij) {
+			constexpr std::size_t i = ij / P;
+			constexpr std::size_t j = ij % P;
+			result(i, j) = detail::static_sum<T, N>([&](auto k) { return a(i, k) * b(k, j); });
+		});
+		return result;
+	}
+	if constexpr (detail::gemm_use_blocked<T, M, N, P>) {
+		if (!std::is_constant_evaluated()) {
+			detail::gemm_blocked<T, detail::gemm_tiles<T, M, N, P>>(
+				M, P, N,
+				detail::contiguous_data(a), A::row_stride(), A::col_stride(),
+				detail::contiguous_data(b), B::row_stride(), B::col_stride(),
+				result.data.data(), result.row_stride(), result.col_stride());
+			return result;
+		}
+	}
 	for (std::size_t i = 0; i < M; ++i) {
 		for (std::size_t j = 0; j < P; ++j) {
 			T sum{};
 			for (std::size_t k = 0; k < N; ++k) {
-				sum += A(i, k) * B(k, j);
+				sum += a(i, k) * b(k, j);
 			}
 			result(i, j) = sum;
 		}
 	}
 	return result;
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------------------------
+// Products with a wider accumulator
+//
+// multiply<Acc>(A, x), multiply<Acc>(x, A) and multiply<Acc>(A, B) return
+// their elements in Acc (default: accumulator_t<T>), so int8 operands give
+// int32 results instead of wrapping. Dot products of a contiguous row of A
+// with x, of x with a contiguous column of A, and of a contiguous row of A
+// with a contiguous column of B go through the widened SIMD dot kernels.
+// Otherwise, like operator*, rows (or, for a column-major A times x, columns)
+// are accumulated so that the inner loop walks contiguous memory.
+//------------------------------------------------------------------------------
+
+template <typename Acc = void, matrix_like A, vector_like V>
+	requires(V::size() == A::n() && std::is_same_v<typename V::value_type, typename A::value_type>)
+constexpr vec<detail::accumulate_t<Acc, typename A::value_type>, A::m()> multiply(const A& a, const V& x) {
+	if constexpr (et::expr<V>) {
+		return multiply<Acc>(a, x.eval());
+	} else {
+		using R = detail::accumulate_t<Acc, typename A::value_type>;
+		vec<R, A::m()> result;
+		if constexpr (A::row_stride() == 1 && A::col_stride() != 1) {
+			for (std::size_t j = 0; j < A::n(); ++j) {
+				const R xj = static_cast<R>(x[j]);
+				for (std::size_t i = 0; i < A::m(); ++i) {
+					result[i] += static_cast<R>(a(i, j)) * xj;
+				}
+			}
+		} else {
+			for (std::size_t i = 0; i < A::m(); ++i) {
+				result[i] = dot<R>(a.row(i), x);
+			}
+		}
+		return result;
+	}
+}
+
+template <typename Acc = void, vector_like V, matrix_like A>
+	requires(V::size() == A::m() && std::is_same_v<typename V::value_type, typename A::value_type>)
+constexpr vec<detail::accumulate_t<Acc, typename A::value_type>, A::n()> multiply(const V& x, const A& a) {
+	if constexpr (et::expr<V>) {
+		return multiply<Acc>(x.eval(), a);
+	} else {
+		using R = detail::accumulate_t<Acc, typename A::value_type>;
+		vec<R, A::n()> result;
+		if constexpr (A::row_stride() == 1 && A::col_stride() != 1) {
+			for (std::size_t j = 0; j < A::n(); ++j) {
+				result[j] = dot<R>(x, a.col(j));
+			}
+		} else {
+			for (std::size_t i = 0; i < A::m(); ++i) {
+				const R xi = static_cast<R>(x[i]);
+				for (std::size_t j = 0; j < A::n(); ++j) {
+					result[j] += xi * static_cast<R>(a(i, j));
+				}
+			}
+		}
+		return result;
+	}
+}
+
+template <typename Acc = void, matrix_like A, matrix_like B>
+	requires(A::n() == B::m() && std::is_same_v<typename A::value_type, typename B::value_type>)
+constexpr mat<detail::accumulate_t<Acc, typename A::value_type>, A::m(), B::n(), detail::product_layout<A, B>>
+multiply(const A& a, const B& b) {
+	using R = detail::accumulate_t<Acc, typename A::value_type>;
+	mat<R, A::m(), B::n(), detail::product_layout<A, B>> result;
+	if constexpr (A::col_stride() == 1 && B::row_stride() == 1 && B::col_stride() != 1) {
+		for (std::size_t i = 0; i < A::m(); ++i) {
+			for (std::size_t j = 0; j < B::n(); ++j) {
+				result(i, j) = dot<R>(a.row(i), b.col(j));
+			}
+		}
+	} else {
+		for (std::size_t i = 0; i < A::m(); ++i) {
+			for (std::size_t k = 0; k < A::n(); ++k) {
+				const R aik = static_cast<R>(a(i, k));
+				for (std::size_t j = 0; j < B::n(); ++j) {
+					result(i, j) += aik * static_cast<R>(b(k, j));
+				}
+			}
+		}
+	}
+	return result;
+}
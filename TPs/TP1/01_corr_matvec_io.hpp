@@ -0,0 +1,363 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+#include "01_corr_matvec_mmap.hpp"
+
+// Binary storage of vec / mat / dyn_vec / dyn_mat
+//
+// A file is a 64-byte header followed by the raw elements, in the byte
+// order of the machine that wrote them:
+//
+//   offset  size  field
+//        0     8  magic "MATVEC\r\n"
+//        8     4  format version (readers accept their version and older)
+//       12     4  byte order mark 0x01020304
+//       16     4  element type (element_type)
+//       20     4  element size in bytes
+//       24     4  layout: 0 row-major, 1 column-major
+//       28     4  alignment of the data offset
+//       32     8  rows
+//       40     8  cols (1 for vectors)
+//       48     8  data offset (multiple of the alignment)
+//       56     8  reserved, zero
+//
+// save() writes a whole object, matrix_writer streams the elements of a
+// matrix too large to be built in memory first. load<X>() copies a file
+// into a new X, converting the layout if needed; load_mapped<T>() maps a
+// row-major file and returns a mapped_mat pointing at the elements in
+// place, so opening a multi-GB file costs no read at all: pages are only
+// brought in when touched. Malformed or mismatching files throw
+// std::system_error.
+
+enum class element_type : std::uint32_t {
+	i8 = 1, u8, i16, u16, i32, u32, i64, u64, f32, f64
+};
+
+struct file_header {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t byte_order;
+	element_type type;
+	std::uint32_t element_size;
+	std::uint32_t layout;
+	std::uint32_t alignment;
+	std::uint64_t rows;
+	std::uint64_t cols;
+	std::uint64_t data_offset;
+	std::uint64_t reserved;
+};
+
+static_assert(sizeof(file_header) == 64, "file_header must stay 64 bytes");
+
+namespace detail {
+
+inline constexpr char file_magic[8] = {'M', 'A', 'T', 'V', 'E', 'C', '\r', '\n'};
+inline constexpr std::uint32_t file_version = 1;
+inline constexpr std::uint32_t file_byte_order = 0x01020304;
+
+// Elements start on a cache line, in the file and thus in a mapping of it
+inline constexpr std::uint32_t file_alignment = 64;
+
+template <typename T> constexpr element_type element_type_of() {
+	if constexpr (std::is_same_v<T, float>) {
+		return element_type::f32;
+	} else if constexpr (std::is_same_v<T, double>) {
+		return element_type::f64;
+	} else {
+		static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "unsupported element type");
+		constexpr std::uint32_t log2_size = sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : sizeof(T) == 4 ? 2 : 3;
+		return static_cast<element_type>(1 + 2 * log2_size + (std::is_signed_v<T> ? 0 : 1));
+	}
+}
+
+template <typename Layout> constexpr std::uint32_t layout_code() {
+	return std::is_same_v<Layout, col_major> ? 1 : 0;
+}
+
+[[noreturn]] inline void throw_format(const std::string& path, const std::string& what) {
+	throw std::system_error(std::make_error_code(std::errc::invalid_argument), path + ": " + what);
+}
+
+template <typename T> file_header make_header(std::uint32_t layout, std::size_t rows, std::size_t cols) {
+	file_header h{};
+	std::memcpy(h.magic, file_magic, sizeof(h.magic));
+	h.version = file_version;
+	h.byte_order = file_byte_order;
+	h.type = element_type_of<T>();
+	h.element_size = sizeof(T);
+	h.layout = layout;
+	h.alignment = file_alignment;
+	h.rows = rows;
+	h.cols = cols;
+	h.data_offset = pad_to(sizeof(file_header), file_alignment);
+	return h;
+}
+
+// Checks the header itself, then that the payload fits in file_size bytes
+inline void check_header(const file_header& h, std::size_t file_size, const std::string& path) {
+	if (std::memcmp(h.magic, file_magic, sizeof(h.magic)) != 0) {
+		throw_format(path, "not a matrix file");
+	}
+	if (h.version == 0 || h.version > file_version) {
+		throw_format(path, "unsupported format version " + std::to_string(h.version));
+	}
+	if (h.byte_order != file_byte_order) {
+		throw_format(path, "written with another byte order");
+	}
+	if (h.layout > 1 || h.element_size == 0 || h.alignment == 0 || (h.alignment & (h.alignment - 1)) != 0
+	    || h.data_offset % h.alignment != 0 || h.data_offset < sizeof(h)) {
+		throw_format(path, "corrupted header");
+	}
+	if (h.rows != 0 && h.cols > (file_size - std::min<std::size_t>(file_size, h.data_offset))
+	                                / h.element_size / h.rows) {
+		throw_format(path, "truncated file");
+	}
+}
+
+template <typename T> void check_type(const file_header& h, const std::string& path) {
+	if (h.type != element_type_of<T>() || h.element_size != sizeof(T)) {
+		throw_format(path, "element type mismatch");
+	}
+	// Mappings start on a page: the elements are read in place as T
+	if (h.data_offset % alignof(T) != 0) {
+		throw_format(path, "misaligned elements");
+	}
+}
+
+inline void check_shape(const file_header& h, std::size_t rows, std::size_t cols, const std::string& path) {
+	if (h.rows != rows || h.cols != cols) {
+		throw_format(path, "shape mismatch: file is " + std::to_string(h.rows) + " x " + std::to_string(h.cols));
+	}
+}
+
+// Header and elements of a file mapped read-only
+template <typename T> struct mapped_file {
+	file_header header;
+	mapped_region region;
+
+	explicit mapped_file(const std::string& path, bool writable = false)
+		: region(mapped_region::open(path, writable)) {
+		if (region.size() < sizeof(file_header)) {
+			throw_format(path, "not a matrix file");
+		}
+		std::memcpy(&header, region.data(), sizeof(header));
+		check_header(header, region.size(), path);
+		check_type<T>(header, path);
+	}
+
+	const T* data() const { return reinterpret_cast<const T*>(region.data() + header.data_offset); }
+
+	// Element (i, j) whatever the layout of the file
+	const T& operator()(std::size_t i, std::size_t j) const {
+		return header.layout == 0 ? data()[i * header.cols + j] : data()[i + j * header.rows];
+	}
+};
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// Streaming writer
+//------------------------------------------------------------------------------
+
+// Writes a rows x cols matrix stored with Layout, elements appended in
+// storage order (row after row for row_major, column after column for
+// col_major). close() reports an incomplete matrix or a failed write.
+template <typename T, typename Layout = row_major> class matrix_writer {
+	public:
+	matrix_writer(const std::string& path, std::size_t rows, std::size_t cols)
+		: path_(path), remaining_(rows * cols) {
+		file = std::fopen(path.c_str(), "wb");
+		if (!file) {
+			detail::throw_errno("create " + path);
+		}
+		std::setvbuf(file, nullptr, _IOFBF, std::size_t(1) << 20);
+		const file_header h = detail::make_header<T>(detail::layout_code<Layout>(), rows, cols);
+		static constexpr char padding[detail::file_alignment] = {};
+		try {
+			put(&h, sizeof(h));
+			put(padding, h.data_offset - sizeof(h));
+		} catch (...) {
+			std::fclose(file);
+			throw;
+		}
+	}
+
+	matrix_writer(const matrix_writer&) = delete;
+	matrix_writer& operator=(const matrix_writer&) = delete;
+
+	// An unclosed writer leaves an incomplete file behind
+	~matrix_writer() {
+		if (file) {
+			std::fclose(file);
+		}
+	}
+
+	// Appends count elements
+	void write(const T* values, std::size_t count) {
+		assert(file && "write after close");
+		assert(count <= remaining_ && "more elements than the matrix holds");
+		put(values, count * sizeof(T));
+		remaining_ -= count;
+	}
+
+	template <std::size_t N> void write(const vec<T, N>& v) { write(v.data.data(), N); }
+	void write(const dyn_vec<T>& v) { write(v.data(), v.size()); }
+
+	// Elements still expected
+	std::size_t remaining() const { return remaining_; }
+
+	void close() {
+		assert(file && "matrix_writer closed twice");
+		std::FILE* f = std::exchange(file, nullptr);
+		if (std::fclose(f) != 0) {
+			detail::throw_errno("write " + path_);
+		}
+		if (remaining_ != 0) {
+			detail::throw_format(path_, std::to_string(remaining_) + " elements missing");
+		}
+	}
+
+	private:
+	void put(const void* p, std::size_t bytes) {
+		if (bytes != 0 && std::fwrite(p, 1, bytes, file) != bytes) {
+			detail::throw_errno("write " + path_);
+		}
+	}
+
+	std::string path_;
+	std::FILE* file = nullptr;
+	std::size_t remaining_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// save / load
+//------------------------------------------------------------------------------
+
+template <typename T, std::size_t N> void save(const std::string& path, const vec<T, N>& v) {
+	matrix_writer<T> w(path, N, 1);
+	w.write(v);
+	w.close();
+}
+
+template <typename T> void save(const std::string& path, const dyn_vec<T>& v) {
+	matrix_writer<T> w(path, v.size(), 1);
+	w.write(v);
+	w.close();
+}
+
+template <typename T, std::size_t M, std::size_t N, typename L>
+void save(const std::string& path, const mat<T, M, N, L>& A) {
+	matrix_writer<T, L> w(path, M, N);
+	w.write(A.data.data(), M * N);
+	w.close();
+}
+
+template <typename T> void save(const std::string& path, const dyn_mat<T>& A) {
+	matrix_writer<T> w(path, A.m(), A.n());
+	for (std::size_t i = 0; i < A.m(); ++i) {
+		w.write(A.row_data(i), A.n());
+	}
+	w.close();
+}
+
+// Header of a matrix file, validated but not checked against any type
+inline file_header read_header(const std::string& path) {
+	std::FILE* f = std::fopen(path.c_str(), "rb");
+	if (!f) {
+		detail::throw_errno("open " + path);
+	}
+	file_header h{};
+	const bool complete = std::fread(&h, sizeof(h), 1, f) == 1;
+	std::fseek(f, 0, SEEK_END);
+	const long size = std::ftell(f);
+	std::fclose(f);
+	if (!complete) {
+		detail::throw_format(path, "not a matrix file");
+	}
+	detail::check_header(h, static_cast<std::size_t>(size), path);
+	return h;
+}
+
+namespace detail {
+
+template <typename T, std::size_t N> vec<T, N> load_as(const std::string& path, std::type_identity<vec<T, N>>) {
+	const mapped_file<T> f(path);
+	check_shape(f.header, N, 1, path);
+	vec<T, N> v;
+	std::copy_n(f.data(), N, v.data.data());
+	return v;
+}
+
+template <typename T> dyn_vec<T> load_as(const std::string& path, std::type_identity<dyn_vec<T>>) {
+	const mapped_file<T> f(path);
+	if (f.header.cols != 1) {
+		throw_format(path, "not a vector");
+	}
+	dyn_vec<T> v(f.header.rows);
+	for (std::size_t i = 0; i < v.size(); ++i) {
+		v[i] = f.data()[i];
+	}
+	return v;
+}
+
+template <typename T, std::size_t M, std::size_t N, typename L>
+mat<T, M, N, L> load_as(const std::string& path, std::type_identity<mat<T, M, N, L>>) {
+	const mapped_file<T> f(path);
+	check_shape(f.header, M, N, path);
+	mat<T, M, N, L> A;
+	if (f.header.layout == layout_code<L>()) {
+		std::copy_n(f.data(), M * N, A.data.data());
+	} else {
+		for (std::size_t i = 0; i < M; ++i) {
+			for (std::size_t j = 0; j < N; ++j) {
+				A(i, j) = f(i, j);
+			}
+		}
+	}
+	return A;
+}
+
+template <typename T> dyn_mat<T> load_as(const std::string& path, std::type_identity<dyn_mat<T>>) {
+	const mapped_file<T> f(path);
+	dyn_mat<T> A(f.header.rows, f.header.cols);
+	for (std::size_t i = 0; i < A.m(); ++i) {
+		if (f.header.layout == 0) {
+			std::copy_n(f.data() + i * A.n(), A.n(), A.row_data(i));
+		} else {
+			for (std::size_t j = 0; j < A.n(); ++j) {
+				A(i, j) = f(i, j);
+			}
+		}
+	}
+	return A;
+}
+
+} // namespace detail
+
+// Reads a vec, mat (either layout), dyn_vec or dyn_mat saved with save()
+// or matrix_writer; fixed sizes must match the file
+template <typename X> X load(const std::string& path) {
+	return detail::load_as(path, std::type_identity<X>{});
+}
+
+// Zero-copy load of a row-major file: the mapped_mat points at the elements
+// in the file. writable maps it shared, so writes go to the file.
+template <typename T> mapped_mat<T> load_mapped(const std::string& path, bool writable = false) {
+	detail::mapped_file<T> f(path, writable);
+	if (f.header.layout != 0) {
+		detail::throw_format(path, "zero-copy load needs a row-major file");
+	}
+	return mapped_mat<T>(std::move(f.region), f.header.data_offset, f.header.rows, f.header.cols);
+}
@@ -0,0 +1,471 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+
+// File-backed matrices and out-of-core products (POSIX)
+//
+// mapped_mat<T> memory-maps a raw row-major file of rows x cols elements, so
+// matrices larger than RAM are paged in and out by the kernel on demand.
+// multiply_streamed(A, B, C) computes C = A * B tile by tile through a
+// fixed-size staging buffer: while the GEMM kernel works on the current
+// tiles, a loader thread copies (and thereby pages in) the next ones into
+// the other half of the buffer. Finished rows of C are handed to the kernel
+// for write-back and consumed rows of A are dropped from memory, so the
+// resident set stays around the buffer size whatever the file sizes.
+//
+// I/O failures are reported with std::system_error, a staging buffer too
+// small for one tile with std::invalid_argument.
+
+namespace detail {
+
+[[noreturn]] inline void throw_errno(const std::string& what) {
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+inline std::size_t page_size() {
+	static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+	return size;
+}
+
+//------------------------------------------------------------------------------
+// mapped_region: a whole file mapped in memory, shared with the file
+//------------------------------------------------------------------------------
+
+class mapped_region {
+	public:
+	mapped_region() = default;
+
+	// Maps an existing file, read-only or read-write
+	static mapped_region open(const std::string& path, bool writable) {
+		mapped_region r;
+		r.fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+		if (r.fd < 0) {
+			throw_errno("open " + path);
+		}
+		struct stat st;
+		if (::fstat(r.fd, &st) != 0) {
+			throw_errno("stat " + path);
+		}
+		r.map(path, static_cast<std::size_t>(st.st_size), writable);
+		return r;
+	}
+
+	// Creates (or truncates) a file of size bytes and maps it read-write
+	static mapped_region create(const std::string& path, std::size_t size) {
+		mapped_region r;
+		r.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (r.fd < 0) {
+			throw_errno("create " + path);
+		}
+		if (::ftruncate(r.fd, static_cast<off_t>(size)) != 0) {
+			throw_errno("resize " + path);
+		}
+		r.map(path, size, true);
+		return r;
+	}
+
+	mapped_region(const mapped_region&) = delete;
+
+	mapped_region(mapped_region&& other) noexcept
+		: fd(std::exchange(other.fd, -1)), base(std::exchange(other.base, nullptr)),
+		  size_(std::exchange(other.size_, 0)), writable_(other.writable_) {}
+
+	mapped_region& operator=(mapped_region other) noexcept {
+		std::swap(fd, other.fd);
+		std::swap(base, other.base);
+		std::swap(size_, other.size_);
+		std::swap(writable_, other.writable_);
+		return *this;
+	}
+
+	~mapped_region() {
+		if (base) {
+			::munmap(base, size_);
+		}
+		if (fd >= 0) {
+			::close(fd);
+		}
+	}
+
+	std::byte* data() const { return base; }
+	std::size_t size() const { return size_; }
+	bool writable() const { return writable_; }
+
+	// madvise() on the pages overlapping [offset, offset + length); hints
+	// only, so failures are ignored
+	void advise(std::size_t offset, std::size_t length, int advice) const {
+		if (auto [p, n] = pages(offset, length); n != 0) {
+			::madvise(p, n, advice);
+		}
+	}
+
+	// Writes [offset, offset + length) back to the file, waiting or not
+	void sync(std::size_t offset, std::size_t length, bool wait) const {
+		if (auto [p, n] = pages(offset, length); n != 0 && writable_) {
+			if (::msync(p, n, wait ? MS_SYNC : MS_ASYNC) != 0) {
+				throw_errno("msync");
+			}
+		}
+	}
+
+	private:
+	void map(const std::string& path, std::size_t size, bool writable) {
+		size_ = size;
+		writable_ = writable;
+		if (size == 0) {
+			return;
+		}
+		void* p = ::mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+		if (p == MAP_FAILED) {
+			throw_errno("mmap " + path);
+		}
+		base = static_cast<std::byte*>(p);
+	}
+
+	// Page-aligned span covering [offset, offset + length), clipped to the map
+	std::pair<std::byte*, std::size_t> pages(std::size_t offset, std::size_t length) const {
+		if (!base || offset >= size_) {
+			return {nullptr, 0};
+		}
+		const std::size_t end = std::min(size_, offset + length);
+		const std::size_t first = offset / page_size() * page_size();
+		return {base + first, end - first};
+	}
+
+	int fd = -1;
+	std::byte* base = nullptr;
+	std::size_t size_ = 0;
+	bool writable_ = false;
+};
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// mapped_mat: row-major matrix stored in a file
+//------------------------------------------------------------------------------
+
+template <typename T> class mapped_mat {
+	static_assert(std::is_trivially_copyable_v<T>, "mapped_mat stores raw element bytes");
+
+	public:
+	using value_type = T;
+
+	mapped_mat() = default;
+
+	// Maps an existing file of exactly rows * cols elements
+	static mapped_mat open(const std::string& path, std::size_t rows, std::size_t cols, bool writable = false) {
+		mapped_mat A(detail::mapped_region::open(path, writable), rows, cols);
+		if (A.region.size() != rows * cols * sizeof(T)) {
+			throw std::system_error(std::make_error_code(std::errc::invalid_argument),
+			                        path + ": file size does not match the matrix dimensions");
+		}
+		return A;
+	}
+
+	// Creates a zero-filled rows x cols file, mapped read-write
+	static mapped_mat create(const std::string& path, std::size_t rows, std::size_t cols) {
+		return mapped_mat(detail::mapped_region::create(path, rows * cols * sizeof(T)), rows, cols);
+	}
+
+	// Matrix stored at byte offset of an already mapped file (used by
+	// load_mapped() in 01_corr_matvec_io.hpp)
+	mapped_mat(detail::mapped_region r, std::size_t offset, std::size_t rows, std::size_t cols)
+		: region(std::move(r)), offset_(offset), rows_(rows), cols_(cols) {
+		assert(offset % alignof(T) == 0 && offset + rows * cols * sizeof(T) <= region.size()
+		       && "mapped_mat outside of its file");
+	}
+
+	//--------------------------------------------------------------------------
+	// Dimensions and element access, as for dyn_mat
+	//--------------------------------------------------------------------------
+
+	std::size_t m() const { return rows_; }
+	std::size_t n() const { return cols_; }
+	std::size_t ld() const { return cols_; }
+	bool writable() const { return region.writable(); }
+
+	// Writing to a matrix opened read-only faults
+	T* data() { return base(); }
+	const T* data() const { return base(); }
+
+	T* row_data(std::size_t i) { return data() + i * cols_; }
+	const T* row_data(std::size_t i) const { return data() + i * cols_; }
+
+	T& operator()(std::size_t i, std::size_t j) { return row_data(i)[j]; }
+	const T& operator()(std::size_t i, std::size_t j) const { return row_data(i)[j]; }
+
+	// The whole matrix as a fixed-size view, usable in every mat product
+	template <std::size_t M, std::size_t N> block_view<T, M, N, N> view() {
+		assert(M == rows_ && N == cols_ && "mapped_mat view size mismatch");
+		return block_view<T, M, N, N>(data());
+	}
+
+	template <std::size_t M, std::size_t N> block_view<const T, M, N, N> view() const {
+		assert(M == rows_ && N == cols_ && "mapped_mat view size mismatch");
+		return block_view<const T, M, N, N>(data());
+	}
+
+	//--------------------------------------------------------------------------
+	// Paging control over whole rows [row0, row0 + rows)
+	//--------------------------------------------------------------------------
+
+	// Starts reading the rows ahead of their use
+	void prefetch(std::size_t row0, std::size_t rows) const {
+		region.advise(offset_ + row0 * row_bytes(), rows * row_bytes(), MADV_WILLNEED);
+	}
+
+	// Drops the rows from memory; written rows are kept in the page cache
+	// and still reach the file
+	void release(std::size_t row0, std::size_t rows) const {
+		region.advise(offset_ + row0 * row_bytes(), rows * row_bytes(), MADV_DONTNEED);
+	}
+
+	// Writes the rows back to the file, waiting for completion or not
+	void flush(std::size_t row0, std::size_t rows, bool wait = true) const {
+		region.sync(offset_ + row0 * row_bytes(), rows * row_bytes(), wait);
+	}
+
+	void flush() const { flush(0, rows_); }
+
+	private:
+	mapped_mat(detail::mapped_region r, std::size_t rows, std::size_t cols)
+		: region(std::move(r)), rows_(rows), cols_(cols) {}
+
+	T* base() const { return reinterpret_cast<T*>(region.data() + offset_); }
+	std::size_t row_bytes() const { return cols_ * sizeof(T); }
+
+	detail::mapped_region region;
+	std::size_t offset_ = 0;
+	std::size_t rows_ = 0;
+	std::size_t cols_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// Streaming tiled product
+//------------------------------------------------------------------------------
+
+// Row-major storage with a leading dimension: dyn_mat, mapped_mat
+template <typename A>
+concept row_major_storage = requires(const A& a) {
+	{ a.m() } -> std::convertible_to<std::size_t>;
+	{ a.n() } -> std::convertible_to<std::size_t>;
+	{ a.ld() } -> std::convertible_to<std::size_t>;
+	{ *a.data() };
+};
+
+template <row_major_storage A>
+using storage_value_t = std::remove_cvref_t<decltype(*std::declval<const A&>().data())>;
+
+namespace detail {
+
+// Default staging buffer of multiply_streamed
+inline constexpr std::size_t stream_buffer_bytes = std::size_t(256) << 20;
+
+// Side of the square tiles streamed through buffer_bytes: two A tiles and
+// two B tiles (double buffering) plus the C tile being accumulated
+template <typename T> std::size_t stream_tile(std::size_t buffer_bytes) {
+	std::size_t t = static_cast<std::size_t>(std::sqrt(static_cast<double>(buffer_bytes / (5 * sizeof(T)))));
+	// Multiples of 64 keep the tile rows on cache-line boundaries
+	if (t > 64) {
+		t = t / 64 * 64;
+	}
+	if (t == 0) {
+		throw std::invalid_argument("multiply_streamed: staging buffer too small");
+	}
+	return t;
+}
+
+// Thread running load(s) for one step s at a time, ahead of the caller.
+// wait() returns once the last requested step is loaded, and rethrows what
+// load threw.
+template <typename F> class step_loader {
+	public:
+	explicit step_loader(F load) : load_(std::move(load)), worker_([this] { loop(); }) {}
+
+	step_loader(const step_loader&) = delete;
+	step_loader& operator=(const step_loader&) = delete;
+
+	// Lets a running load finish; a requested one that has not started is dropped
+	~step_loader() {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		wake_.notify_all();
+		worker_.join();
+	}
+
+	void start(std::size_t s) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			assert(!pending_ && "step_loader: previous step not waited for");
+			step_ = s;
+			pending_ = true;
+		}
+		wake_.notify_all();
+	}
+
+	void wait() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		wake_.wait(lock, [this] { return !pending_; });
+		if (error_) {
+			std::rethrow_exception(std::exchange(error_, nullptr));
+		}
+	}
+
+	private:
+	void loop() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;) {
+			wake_.wait(lock, [this] { return stopping_ || pending_; });
+			if (stopping_) {
+				return;
+			}
+			const std::size_t s = step_;
+			lock.unlock();
+			std::exception_ptr error;
+			try {
+				load_(s);
+			} catch (...) {
+				error = std::current_exception();
+			}
+			lock.lock();
+			error_ = error;
+			pending_ = false;
+			wake_.notify_all();
+		}
+	}
+
+	F load_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::size_t step_ = 0;
+	bool pending_ = false;
+	bool stopping_ = false;
+	std::exception_ptr error_;
+	std::thread worker_;
+};
+
+// Copies rows x cols elements at (r0, c0) of a into dst (leading dimension cols)
+template <typename A, typename T>
+void load_tile(const A& a, std::size_t r0, std::size_t rows, std::size_t c0, std::size_t cols, T* dst) {
+	for (std::size_t i = 0; i < rows; ++i) {
+		std::copy_n(a.data() + (r0 + i) * a.ld() + c0, cols, dst + i * cols);
+	}
+}
+
+} // namespace detail
+
+// C = A * B, streamed through a staging buffer of about buffer_bytes. C must
+// not alias A or B. Any mix of mapped_mat and dyn_mat operands is accepted.
+template <row_major_storage MA, row_major_storage MB, row_major_storage MC>
+	requires(std::is_same_v<storage_value_t<MA>, storage_value_t<MB>>
+	         && std::is_same_v<storage_value_t<MA>, storage_value_t<MC>>)
+void multiply_streamed(const MA& a, const MB& b, MC& c, std::size_t buffer_bytes = detail::stream_buffer_bytes) {
+	using T = storage_value_t<MA>;
+	assert(a.n() == b.m() && a.m() == c.m() && b.n() == c.n() && "multiply_streamed size mismatch");
+	const std::size_t m = a.m();
+	const std::size_t n = b.n();
+	const std::size_t k = a.n();
+	if (m == 0 || n == 0) {
+		return;
+	}
+	if (k == 0) {
+		for (std::size_t i = 0; i < m; ++i) {
+			std::fill_n(c.data() + i * c.ld(), n, T{});
+		}
+		return;
+	}
+
+	const std::size_t t = detail::stream_tile<T>(buffer_bytes);
+	const std::size_t tm = std::min(t, m);
+	const std::size_t tn = std::min(t, n);
+	const std::size_t tk = std::min(t, k);
+	const std::size_t bi = (m + tm - 1) / tm;
+	const std::size_t bj = (n + tn - 1) / tn;
+	const std::size_t bk = (k + tk - 1) / tk;
+
+	detail::aligned_buffer<T> a_tiles(2 * tm * tk);
+	detail::aligned_buffer<T> b_tiles(2 * tk * tn);
+	detail::aligned_buffer<T> c_tile(tm * tn);
+
+	// Step s works on C tile (s / bk / bj, s / bk % bj) and depth tile s % bk
+	struct step {
+		std::size_t i0, rows, j0, cols, k0, depth;
+		bool first, last;
+	};
+	const auto decode = [&](std::size_t s) {
+		const std::size_t ib = s / (bj * bk);
+		const std::size_t jb = s / bk % bj;
+		const std::size_t kb = s % bk;
+		return step{ib * tm, std::min(tm, m - ib * tm), jb * tn, std::min(tn, n - jb * tn),
+		            kb * tk, std::min(tk, k - kb * tk), kb == 0, kb + 1 == bk};
+	};
+	const auto load = [&](std::size_t s) {
+		const step st = decode(s);
+		const std::size_t slot = s % 2;
+		detail::load_tile(a, st.i0, st.rows, st.k0, st.depth, a_tiles.data() + slot * tm * tk);
+		detail::load_tile(b, st.k0, st.depth, st.j0, st.cols, b_tiles.data() + slot * tk * tn);
+		// Let the kernel read the following row panel of A ahead of time
+		if constexpr (requires { a.prefetch(std::size_t{}, std::size_t{}); }) {
+			if (st.first && st.j0 == 0 && st.i0 + st.rows < m) {
+				a.prefetch(st.i0 + st.rows, std::min(tm, m - st.i0 - st.rows));
+			}
+		}
+	};
+
+	const std::size_t steps = bi * bj * bk;
+	detail::step_loader loader(load);
+	loader.start(0);
+	for (std::size_t s = 0; s < steps; ++s) {
+		loader.wait();
+		if (s + 1 < steps) {
+			loader.start(s + 1);
+		}
+		const step st = decode(s);
+		const std::size_t slot = s % 2;
+		if (st.first) {
+			std::fill_n(c_tile.data(), tm * tn, T{});
+		}
+		detail::gemm_blocked<T, detail::gemm_blocking<T>>(
+			st.rows, st.cols, st.depth, a_tiles.data() + slot * tm * tk, st.depth, 1,
+			b_tiles.data() + slot * tk * tn, st.cols, 1, c_tile.data(), st.cols, 1);
+		if (!st.last) {
+			continue;
+		}
+		for (std::size_t i = 0; i < st.rows; ++i) {
+			std::copy_n(c_tile.data() + i * st.cols, st.cols, c.data() + (st.i0 + i) * c.ld() + st.j0);
+		}
+		// Row panel of C complete: start its write-back, drop A's panel
+		if (st.j0 + st.cols == n) {
+			if constexpr (requires { c.flush(std::size_t{}, std::size_t{}, false); }) {
+				c.flush(st.i0, st.rows, false);
+			}
+			if constexpr (requires { a.release(std::size_t{}, std::size_t{}); }) {
+				a.release(st.i0, st.rows);
+			}
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+#include "01_corr_matvec_thread_pool.hpp"
+
+//------------------------------------------------------------------------------
+// Parallel products
+//
+// multiply(seq, ...) is the plain operator*. multiply(par, ...) splits the
+// output into fixed-size tiles and runs them on a thread pool (the global
+// one unless par.on(pool) is used). Tiles never depend on the thread count
+// and each one runs the sequential kernel over the full inner dimension, so
+// results are bitwise identical to the sequential product.
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+// Rows of A handled by one mat-vec task
+inline constexpr std::size_t gemv_rows_per_task = 256;
+
+// C(m x n) += A(m x k) * B(k x n), one output tile per task
+template <typename T, typename Tiles>
+void gemm_parallel(thread_pool& pool, std::size_t m, std::size_t n, std::size_t k,
+                   const T* a, std::size_t lda, const T* b, std::size_t ldb, T* c, std::size_t ldc) {
+	constexpr std::size_t tile_m = Tiles::mc;
+	constexpr std::size_t tile_n = std::max<std::size_t>(Tiles::nr, 256 / Tiles::nr * Tiles::nr);
+	const std::size_t tiles_m = (m + tile_m - 1) / tile_m;
+	const std::size_t tiles_n = (n + tile_n - 1) / tile_n;
+
+	pool.parallel_for(tiles_m * tiles_n, [=](std::size_t t) {
+		const std::size_t i0 = (t / tiles_n) * tile_m;
+		const std::size_t j0 = (t % tiles_n) * tile_n;
+		gemm_blocked<T, Tiles>(std::min(tile_m, m - i0), std::min(tile_n, n - j0), k,
+		                       a + i0 * lda, lda, b + j0, ldb, c + i0 * ldc + j0, ldc);
+	});
+}
+
+template <typename T>
+void gemv_parallel(thread_pool& pool, std::size_t m, std::size_t n,
+                   const T* a, std::size_t lda, const T* x, T* y) {
+	const std::size_t tasks = (m + gemv_rows_per_task - 1) / gemv_rows_per_task;
+	pool.parallel_for(tasks, [=](std::size_t t) {
+		const std::size_t i0 = t * gemv_rows_per_task;
+		simd::gemv(std::min(gemv_rows_per_task, m - i0), n, a + i0 * lda, lda, x, y + i0);
+	});
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// multiply
+//------------------------------------------------------------------------------
+
+template <typename T, std::size_t M, std::size_t N, std::size_t P>
+mat<T, M, P> multiply(execution::sequenced_policy, const mat<T, M, N>& A, const mat<T, N, P>& B) {
+	return A * B;
+}
+
+template <typename T, std::size_t M, std::size_t N>
+vec<T, M> multiply(execution::sequenced_policy, const mat<T, M, N>& A, const vec<T, N>& x) {
+	return A * x;
+}
+
+template <typename T>
+dyn_mat<T> multiply(execution::sequenced_policy, const dyn_mat<T>& A, const dyn_mat<T>& B) {
+	return A * B;
+}
+
+template <typename T>
+dyn_vec<T> multiply(execution::sequenced_policy, const dyn_mat<T>& A, const dyn_vec<T>& x) {
+	return A * x;
+}
+
+template <typename T, std::size_t M, std::size_t N, std::size_t P>
+mat<T, M, P> multiply(execution::parallel_policy policy, const mat<T, M, N>& A, const mat<T, N, P>& B) {
+	if constexpr (!detail::gemm_use_blocked<T, M, N, P>) {
+		return A * B;
+	} else {
+		mat<T, M, P> result;
+		detail::gemm_parallel<T, detail::gemm_tiles<T, M, N, P>>(
+			policy.executor(), M, P, N, A.data.data(), N, B.data.data(), P, result.data.data(), P);
+		return result;
+	}
+}
+
+template <typename T, std::size_t M, std::size_t N>
+vec<T, M> multiply(execution::parallel_policy policy, const mat<T, M, N>& A, const vec<T, N>& x) {
+	if constexpr (M <= detail::gemv_rows_per_task) {
+		return A * x;
+	} else {
+		vec<T, M> result;
+		detail::gemv_parallel(policy.executor(), M, N, A.data.data(), N, x.data.data(), result.data.data());
+		return result;
+	}
+}
+
+template <typename T>
+dyn_mat<T> multiply(execution::parallel_policy policy, const dyn_mat<T>& A, const dyn_mat<T>& B) {
+	assert(A.n() == B.m() && "A*B size mismatch");
+	if (!detail::gemm_worth_blocking<T>(A.m(), B.n(), A.n())) {
+		return A * B;
+	}
+	dyn_mat<T> result(A.m(), B.n());
+	detail::gemm_parallel<T, detail::gemm_blocking<T>>(
+		policy.executor(), A.m(), B.n(), A.n(), A.data(), A.ld(), B.data(), B.ld(), result.data(), result.ld());
+	return result;
+}
+
+template <typename T>
+dyn_vec<T> multiply(execution::parallel_policy policy, const dyn_mat<T>& A, const dyn_vec<T>& x) {
+	assert(A.n() == x.size() && "A*x size mismatch");
+	dyn_vec<T> result(A.m());
+	detail::gemv_parallel(policy.executor(), A.m(), A.n(), A.data(), A.ld(), x.data(), result.data());
+	return result;
+}
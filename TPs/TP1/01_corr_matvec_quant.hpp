@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_simd.hpp"
+
+// int8 quantized matrices
+//
+// quantize() stores a float matrix as int8 with one scale per row
+// (symmetric quantization: A(i, j) ~ scale[i] * q(i, j), |q| <= 127), which
+// divides the weight traffic by four. The product with a float vector
+// quantizes x the same way, runs the integer mat-vec with int32
+// accumulation (simd::gemv_i32: pmaddwd, or vpdpbusd with AVX-512 VNNI) and
+// rescales each row once at the end.
+
+template <std::size_t M, std::size_t N> struct quantized_mat {
+	static constexpr std::size_t m() { return M; }
+	static constexpr std::size_t n() { return N; }
+
+	mat<std::int8_t, M, N> q;
+	std::array<float, M> scale{};
+};
+
+template <std::size_t N> struct quantized_vec {
+	static constexpr std::size_t size() { return N; }
+
+	vec<std::int8_t, N> q;
+	float scale = 0.f;
+};
+
+namespace detail {
+
+// Quantizes n values with a common scale; returns the scale
+inline float quantize_span(const float* x, std::size_t n, std::int8_t* q) {
+	float amax = 0.f;
+	for (std::size_t i = 0; i < n; ++i) {
+		amax = std::max(amax, std::abs(x[i]));
+	}
+	const float scale = amax > 0.f ? amax / 127.f : 1.f;
+	const float inv = 1.f / scale;
+	for (std::size_t i = 0; i < n; ++i) {
+		q[i] = static_cast<std::int8_t>(std::clamp(std::lround(x[i] * inv), -127L, 127L));
+	}
+	return scale;
+}
+
+} // namespace detail
+
+template <std::size_t M, std::size_t N> quantized_mat<M, N> quantize(const mat<float, M, N>& A) {
+	quantized_mat<M, N> result;
+	for (std::size_t i = 0; i < M; ++i) {
+		result.scale[i] = detail::quantize_span(A.data.data() + i * N, N, result.q.data.data() + i * N);
+	}
+	return result;
+}
+
+template <std::size_t N> quantized_vec<N> quantize(const vec<float, N>& x) {
+	quantized_vec<N> result;
+	result.scale = detail::quantize_span(x.data.data(), N, result.q.data.data());
+	return result;
+}
+
+template <std::size_t M, std::size_t N> mat<float, M, N> dequantize(const quantized_mat<M, N>& A) {
+	mat<float, M, N> result;
+	for (std::size_t i = 0; i < M; ++i) {
+		for (std::size_t j = 0; j < N; ++j) {
+			result(i, j) = A.scale[i] * static_cast<float>(A.q(i, j));
+		}
+	}
+	return result;
+}
+
+template <std::size_t N> vec<float, N> dequantize(const quantized_vec<N>& x) {
+	vec<float, N> result;
+	for (std::size_t i = 0; i < N; ++i) {
+		result[i] = x.scale * static_cast<float>(x.q[i]);
+	}
+	return result;
+}
+
+// Quantized mat-vec: y = A * x, computed in int32 then rescaled
+template <std::size_t M, std::size_t N>
+vec<float, M> operator*(const quantized_mat<M, N>& A, const quantized_vec<N>& x) {
+	std::array<std::int32_t, M> acc;
+	simd::gemv_i32(M, N, A.q.data.data(), N, x.q.data.data(), acc.data());
+	vec<float, M> result;
+	for (std::size_t i = 0; i < M; ++i) {
+		result[i] = static_cast<float>(acc[i]) * (A.scale[i] * x.scale);
+	}
+	return result;
+}
+
+template <std::size_t M, std::size_t N>
+vec<float, M> operator*(const quantized_mat<M, N>& A, const vec<float, N>& x) {
+	return A * quantize(x);
+}
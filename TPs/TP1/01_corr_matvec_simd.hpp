@@ -0,0 +1,817 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// Explicit SIMD kernels used by the vec/mat operators.
+//
+// The instruction set is selected at compile time (AVX-512F, then AVX2, then
+// SSE2) from the target flags, e.g. -march=native. Every kernel has a scalar
+// fallback for element types or targets without a vector implementation.
+// Reductions use several independent accumulators so that float/double sums
+// vectorize and pipeline without -ffast-math.
+
+namespace simd {
+
+//------------------------------------------------------------------------------
+// Register abstraction
+//
+// reg<T> exposes the vector register type for T and the handful of operations
+// the kernels need. It is only defined when the target supports T.
+//------------------------------------------------------------------------------
+
+template <typename T> struct reg;
+
+#if defined(__AVX512F__)
+
+// Horizontal sums of 512-bit registers. GCC 12 implements
+// _mm512_reduce_add_* and the 512 to 256-bit casts with extracts whose
+// passthrough is left undefined, which trips -Wmaybe-uninitialized wherever
+// they are inlined; zero-masked extracts of both halves add the same lanes.
+inline __m256d reduce_halves(__m512d a) {
+	return _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xF, a, 0), _mm512_maskz_extractf64x4_pd(0xF, a, 1));
+}
+
+inline __m256i reduce_halves_epi64(__m512i a) {
+	return _mm256_add_epi64(_mm512_maskz_extracti64x4_epi64(0xF, a, 0), _mm512_maskz_extracti64x4_epi64(0xF, a, 1));
+}
+
+inline float reduce_add(__m512 a) {
+	const __m512d d = _mm512_castps_pd(a);
+	const __m256 h = _mm256_add_ps(_mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, d, 0)),
+	                               _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, d, 1)));
+	__m128 s = _mm_add_ps(_mm256_castps256_ps128(h), _mm256_extractf128_ps(h, 1));
+	s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+	s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+	return _mm_cvtss_f32(s);
+}
+
+inline double reduce_add(__m512d a) {
+	const __m256d h = reduce_halves(a);
+	const __m128d s = _mm_add_pd(_mm256_castpd256_pd128(h), _mm256_extractf128_pd(h, 1));
+	return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+inline std::int32_t reduce_add_epi32(__m512i a) {
+	const __m256i h = _mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0xF, a, 0), _mm512_maskz_extracti64x4_epi64(0xF, a, 1));
+	__m128i s = _mm_add_epi32(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+	s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+	s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+	return _mm_cvtsi128_si32(s);
+}
+
+inline std::int64_t reduce_add_epi64(__m512i a) {
+	const __m256i h = reduce_halves_epi64(a);
+	const __m128i s = _mm_add_epi64(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+	return _mm_cvtsi128_si64(_mm_add_epi64(s, _mm_unpackhi_epi64(s, s)));
+}
+
+template <> struct reg<float> {
+	using type = __m512;
+	static constexpr std::size_t width = 16;
+	static type zero() { return _mm512_setzero_ps(); }
+	static type set1(float x) { return _mm512_set1_ps(x); }
+	static type load(const float* p) { return _mm512_loadu_ps(p); }
+	static void store(float* p, type a) { _mm512_storeu_ps(p, a); }
+	static type add(type a, type b) { return _mm512_add_ps(a, b); }
+	static type sub(type a, type b) { return _mm512_sub_ps(a, b); }
+	static type div(type a, type b) { return _mm512_div_ps(a, b); }
+	static type mul(type a, type b) { return _mm512_mul_ps(a, b); }
+	static type fma(type a, type b, type c) { return _mm512_fmadd_ps(a, b, c); }
+	static float sum(type a) { return reduce_add(a); }
+};
+
+template <> struct reg<double> {
+	using type = __m512d;
+	static constexpr std::size_t width = 8;
+	static type zero() { return _mm512_setzero_pd(); }
+	static type set1(double x) { return _mm512_set1_pd(x); }
+	static type load(const double* p) { return _mm512_loadu_pd(p); }
+	static void store(double* p, type a) { _mm512_storeu_pd(p, a); }
+	static type add(type a, type b) { return _mm512_add_pd(a, b); }
+	static type sub(type a, type b) { return _mm512_sub_pd(a, b); }
+	static type div(type a, type b) { return _mm512_div_pd(a, b); }
+	static type mul(type a, type b) { return _mm512_mul_pd(a, b); }
+	static type fma(type a, type b, type c) { return _mm512_fmadd_pd(a, b, c); }
+	static double sum(type a) { return reduce_add(a); }
+};
+
+template <> struct reg<std::int32_t> {
+	using type = __m512i;
+	static constexpr std::size_t width = 16;
+	static type zero() { return _mm512_setzero_si512(); }
+	static type set1(std::int32_t x) { return _mm512_set1_epi32(x); }
+	static type load(const std::int32_t* p) { return _mm512_loadu_si512(p); }
+	static void store(std::int32_t* p, type a) { _mm512_storeu_si512(p, a); }
+	static type add(type a, type b) { return _mm512_add_epi32(a, b); }
+	static type sub(type a, type b) { return _mm512_sub_epi32(a, b); }
+	static type mul(type a, type b) { return _mm512_mullo_epi32(a, b); }
+	static type fma(type a, type b, type c) { return add(mul(a, b), c); }
+	static std::int32_t sum(type a) { return reduce_add_epi32(a); }
+};
+
+#elif defined(__AVX2__)
+
+template <> struct reg<float> {
+	using type = __m256;
+	static constexpr std::size_t width = 8;
+	static type zero() { return _mm256_setzero_ps(); }
+	static type set1(float x) { return _mm256_set1_ps(x); }
+	static type load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, type a) { _mm256_storeu_ps(p, a); }
+	static type add(type a, type b) { return _mm256_add_ps(a, b); }
+	static type sub(type a, type b) { return _mm256_sub_ps(a, b); }
+	static type div(type a, type b) { return _mm256_div_ps(a, b); }
+	static type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+#if defined(__FMA__)
+	static type fma(type a, type b, type c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+	static type fma(type a, type b, type c) { return add(mul(a, b), c); }
+#endif
+	static float sum(type a) {
+		__m128 s = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+		s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+		s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+		return _mm_cvtss_f32(s);
+	}
+};
+
+template <> struct reg<double> {
+	using type = __m256d;
+	static constexpr std::size_t width = 4;
+	static type zero() { return _mm256_setzero_pd(); }
+	static type set1(double x) { return _mm256_set1_pd(x); }
+	static type load(const double* p) { return _mm256_loadu_pd(p); }
+	static void store(double* p, type a) { _mm256_storeu_pd(p, a); }
+	static type add(type a, type b) { return _mm256_add_pd(a, b); }
+	static type sub(type a, type b) { return _mm256_sub_pd(a, b); }
+	static type div(type a, type b) { return _mm256_div_pd(a, b); }
+	static type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+#if defined(__FMA__)
+	static type fma(type a, type b, type c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+	static type fma(type a, type b, type c) { return add(mul(a, b), c); }
+#endif
+	static double sum(type a) {
+		__m128d s = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+	}
+};
+
+template <> struct reg<std::int32_t> {
+	using type = __m256i;
+	static constexpr std::size_t width = 8;
+	static type zero() { return _mm256_setzero_si256(); }
+	static type set1(std::int32_t x) { return _mm256_set1_epi32(x); }
+	static type load(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+	static void store(std::int32_t* p, type a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a); }
+	static type add(type a, type b) { return _mm256_add_epi32(a, b); }
+	static type sub(type a, type b) { return _mm256_sub_epi32(a, b); }
+	static type mul(type a, type b) { return _mm256_mullo_epi32(a, b); }
+	static type fma(type a, type b, type c) { return add(mul(a, b), c); }
+	static std::int32_t sum(type a) {
+		__m128i s = _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+		return _mm_cvtsi128_si32(s);
+	}
+};
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+template <> struct reg<float> {
+	using type = __m128;
+	static constexpr std::size_t width = 4;
+	static type zero() { return _mm_setzero_ps(); }
+	static type set1(float x) { return _mm_set1_ps(x); }
+	static type load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, type a) { _mm_storeu_ps(p, a); }
+	static type add(type a, type b) { return _mm_add_ps(a, b); }
+	static type sub(type a, type b) { return _mm_sub_ps(a, b); }
+	static type div(type a, type b) { return _mm_div_ps(a, b); }
+	static type mul(type a, type b) { return _mm_mul_ps(a, b); }
+	static type fma(type a, type b, type c) { return add(mul(a, b), c); }
+	static float sum(type a) {
+		__m128 s = _mm_add_ps(a, _mm_movehl_ps(a, a));
+		s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+		return _mm_cvtss_f32(s);
+	}
+};
+
+template <> struct reg<double> {
+	using type = __m128d;
+	static constexpr std::size_t width = 2;
+	static type zero() { return _mm_setzero_pd(); }
+	static type set1(double x) { return _mm_set1_pd(x); }
+	static type load(const double* p) { return _mm_loadu_pd(p); }
+	static void store(double* p, type a) { _mm_storeu_pd(p, a); }
+	static type add(type a, type b) { return _mm_add_pd(a, b); }
+	static type sub(type a, type b) { return _mm_sub_pd(a, b); }
+	static type div(type a, type b) { return _mm_div_pd(a, b); }
+	static type mul(type a, type b) { return _mm_mul_pd(a, b); }
+	static type fma(type a, type b, type c) { return add(mul(a, b), c); }
+	static double sum(type a) { return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a))); }
+};
+
+// SSE2 has no packed 32-bit multiply, so int32 needs SSE4.1
+#if defined(__SSE4_1__)
+template <> struct reg<std::int32_t> {
+	using type = __m128i;
+	static constexpr std::size_t width = 4;
+	static type zero() { return _mm_setzero_si128(); }
+	static type set1(std::int32_t x) { return _mm_set1_epi32(x); }
+	static type load(const std::int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+	static void store(std::int32_t* p, type a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a); }
+	static type add(type a, type b) { return _mm_add_epi32(a, b); }
+	static type sub(type a, type b) { return _mm_sub_epi32(a, b); }
+	static type mul(type a, type b) { return _mm_mullo_epi32(a, b); }
+	static type fma(type a, type b, type c) { return add(mul(a, b), c); }
+	static std::int32_t sum(type a) {
+		a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0x4E));
+		a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0xB1));
+		return _mm_cvtsi128_si32(a);
+	}
+};
+#endif
+
+#endif
+
+// True when reg<T> has a vector implementation on this target
+template <typename T>
+concept vectorized = requires { reg<std::remove_cv_t<T>>::width; };
+
+// Scalar stand-in with the reg<T> interface, so that kernels written against
+// reg<T> also compile for types without a vector implementation
+template <typename T> struct scalar_reg {
+	using type = T;
+	static constexpr std::size_t width = 1;
+	static type zero() { return T{}; }
+	static type set1(T x) { return x; }
+	static type load(const T* p) { return *p; }
+	static void store(T* p, type a) { *p = a; }
+	static type add(type a, type b) { return a + b; }
+	static type sub(type a, type b) { return a - b; }
+	static type mul(type a, type b) { return a * b; }
+	static type div(type a, type b) { return a / b; }
+	static type fma(type a, type b, type c) { return a * b + c; }
+	static T sum(type a) { return a; }
+};
+
+template <typename T>
+using reg_or_scalar = std::conditional_t<vectorized<T>, reg<T>, scalar_reg<T>>;
+
+// Number of lanes per register for T (1 on the scalar fallback)
+template <typename T>
+constexpr std::size_t lanes() {
+	if constexpr (vectorized<T>) {
+		return reg<T>::width;
+	} else {
+		return 1;
+	}
+}
+
+//------------------------------------------------------------------------------
+// dot: sum of a[i] * b[i] over n elements
+//
+// Floating-point sums are computed by blocks of dot_block elements, each one
+// with the usual SIMD accumulators, and the block sums are combined with
+// compensated (Neumaier) summation. The error then grows with the block
+// size rather than with n, at no measurable cost.
+//------------------------------------------------------------------------------
+
+inline constexpr std::size_t dot_block = 4096;
+
+template <typename T>
+T dot_unblocked(const T* a, const T* b, std::size_t n) {
+	std::size_t i = 0;
+	T result{};
+	if constexpr (vectorized<T>) {
+		using R = reg<T>;
+		constexpr std::size_t W = R::width;
+		typename R::type s0 = R::zero(), s1 = R::zero(), s2 = R::zero(), s3 = R::zero();
+		for (; i + 4 * W <= n; i += 4 * W) {
+			s0 = R::fma(R::load(a + i), R::load(b + i), s0);
+			s1 = R::fma(R::load(a + i + W), R::load(b + i + W), s1);
+			s2 = R::fma(R::load(a + i + 2 * W), R::load(b + i + 2 * W), s2);
+			s3 = R::fma(R::load(a + i + 3 * W), R::load(b + i + 3 * W), s3);
+		}
+		for (; i + W <= n; i += W) {
+			s0 = R::fma(R::load(a + i), R::load(b + i), s0);
+		}
+		result = R::sum(R::add(R::add(s0, s1), R::add(s2, s3)));
+	}
+	for (; i < n; ++i) {
+		result += a[i] * b[i];
+	}
+	return result;
+}
+
+template <typename T>
+T dot(const T* a, const T* b, std::size_t n) {
+	if constexpr (!std::is_floating_point_v<T>) {
+		return dot_unblocked(a, b, n);
+	} else {
+		if (n <= dot_block) {
+			return dot_unblocked(a, b, n);
+		}
+		T sum{};
+		T compensation{};
+		for (std::size_t i = 0; i < n; i += dot_block) {
+			const T x = dot_unblocked(a + i, b + i, n - i < dot_block ? n - i : dot_block);
+			const T t = sum + x;
+			compensation += (sum >= x) == (sum >= -x) ? (sum - t) + x : (x - t) + sum;
+			sum = t;
+		}
+		return sum + compensation;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Widened dot products of small integers, accumulated in int32
+//
+// widen<T> is defined for int8, uint8 and int16 when the target has the
+// needed instructions: elements are sign/zero-extended to int16 and
+// multiplied pairwise into int32 lanes (pmaddwd). With AVX-512 VNNI the
+// int16 path uses vpdpwssd, and int8 uses vpdpbusd on 64 elements at once:
+// vpdpbusd multiplies unsigned by signed bytes, so a is biased by 128 and
+// 128 * sum(b) is subtracted at the end. Intermediate sums wrap modulo 2^32,
+// so the result is exact whenever the true dot product fits in an int32.
+//------------------------------------------------------------------------------
+
+template <typename T> struct widen;
+
+#if defined(__AVX512BW__)
+
+// Sign- or zero-extends 32 elements to int16
+template <typename T> __m512i widen16_avx512(const T* p) {
+	if constexpr (std::is_same_v<T, std::int16_t>) {
+		return _mm512_loadu_si512(p);
+	} else {
+		const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		if constexpr (std::is_signed_v<T>) {
+			return _mm512_cvtepi8_epi16(v);
+		} else {
+			return _mm512_cvtepu8_epi16(v);
+		}
+	}
+}
+
+template <typename T> struct widen_avx512 {
+	using type = __m512i;
+	static constexpr std::size_t width = 32;
+	static type zero() { return _mm512_setzero_si512(); }
+	static type add(type a, type b) { return _mm512_add_epi32(a, b); }
+	static type step(type acc, const T* a, const T* b) {
+#if defined(__AVX512VNNI__)
+		return _mm512_dpwssd_epi32(acc, widen16_avx512(a), widen16_avx512(b));
+#else
+		return _mm512_add_epi32(acc, _mm512_madd_epi16(widen16_avx512(a), widen16_avx512(b)));
+#endif
+	}
+	static std::int32_t sum(type acc) { return reduce_add_epi32(acc); }
+};
+
+template <> struct widen<std::uint8_t> : widen_avx512<std::uint8_t> {};
+template <> struct widen<std::int16_t> : widen_avx512<std::int16_t> {};
+
+#if defined(__AVX512VNNI__)
+template <> struct widen<std::int8_t> {
+	struct type {
+		__m512i dot;
+		__m512i bias;
+	};
+	static constexpr std::size_t width = 64;
+	static type zero() { return {_mm512_setzero_si512(), _mm512_setzero_si512()}; }
+	static type add(type a, type b) { return {_mm512_add_epi32(a.dot, b.dot), _mm512_add_epi32(a.bias, b.bias)}; }
+	static type step(type acc, const std::int8_t* a, const std::int8_t* b) {
+		const __m512i offset = _mm512_set1_epi8(static_cast<char>(0x80));
+		const __m512i ones = _mm512_set1_epi8(1);
+		const __m512i va = _mm512_xor_si512(_mm512_loadu_si512(a), offset);
+		const __m512i vb = _mm512_loadu_si512(b);
+		return {_mm512_dpbusd_epi32(acc.dot, va, vb), _mm512_dpbusd_epi32(acc.bias, ones, vb)};
+	}
+	static std::int32_t sum(type acc) {
+		const __m512i r = _mm512_sub_epi32(acc.dot, _mm512_maskz_slli_epi32(0xFFFF, acc.bias, 7));
+		return reduce_add_epi32(r);
+	}
+};
+#else
+template <> struct widen<std::int8_t> : widen_avx512<std::int8_t> {};
+#endif
+
+#elif defined(__AVX2__)
+
+// Sign- or zero-extends 16 elements to int16
+template <typename T> __m256i widen16_avx2(const T* p) {
+	if constexpr (std::is_same_v<T, std::int16_t>) {
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+	} else {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		if constexpr (std::is_signed_v<T>) {
+			return _mm256_cvtepi8_epi16(v);
+		} else {
+			return _mm256_cvtepu8_epi16(v);
+		}
+	}
+}
+
+template <typename T> struct widen_avx2 {
+	using type = __m256i;
+	static constexpr std::size_t width = 16;
+	static type zero() { return _mm256_setzero_si256(); }
+	static type add(type a, type b) { return _mm256_add_epi32(a, b); }
+	static type step(type acc, const T* a, const T* b) {
+		return _mm256_add_epi32(acc, _mm256_madd_epi16(widen16_avx2(a), widen16_avx2(b)));
+	}
+	// Not reg<int32_t>::sum, which takes 512-bit registers on AVX-512F targets without BW
+	static std::int32_t sum(type acc) {
+		__m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+		return _mm_cvtsi128_si32(s);
+	}
+};
+
+template <> struct widen<std::int8_t> : widen_avx2<std::int8_t> {};
+template <> struct widen<std::uint8_t> : widen_avx2<std::uint8_t> {};
+template <> struct widen<std::int16_t> : widen_avx2<std::int16_t> {};
+
+#elif defined(__SSE4_1__)
+
+// Sign- or zero-extends 8 elements to int16
+template <typename T> __m128i widen16_sse(const T* p) {
+	if constexpr (std::is_same_v<T, std::int16_t>) {
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	} else {
+		const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+		if constexpr (std::is_signed_v<T>) {
+			return _mm_cvtepi8_epi16(v);
+		} else {
+			return _mm_cvtepu8_epi16(v);
+		}
+	}
+}
+
+template <typename T> struct widen_sse {
+	using type = __m128i;
+	static constexpr std::size_t width = 8;
+	static type zero() { return _mm_setzero_si128(); }
+	static type add(type a, type b) { return _mm_add_epi32(a, b); }
+	static type step(type acc, const T* a, const T* b) {
+		return _mm_add_epi32(acc, _mm_madd_epi16(widen16_sse(a), widen16_sse(b)));
+	}
+	static std::int32_t sum(type acc) { return reg<std::int32_t>::sum(acc); }
+};
+
+template <> struct widen<std::int8_t> : widen_sse<std::int8_t> {};
+template <> struct widen<std::uint8_t> : widen_sse<std::uint8_t> {};
+template <> struct widen<std::int16_t> : widen_sse<std::int16_t> {};
+
+#endif
+
+// True when widen<T> has a vector implementation on this target
+template <typename T>
+concept widened = requires { widen<std::remove_cv_t<T>>::width; };
+
+// Sum of a[i] * b[i] in int32, for 8- and 16-bit integers
+template <typename T>
+std::int32_t dot_i32(const T* a, const T* b, std::size_t n) {
+	std::size_t i = 0;
+	std::uint32_t result = 0;
+	if constexpr (widened<T>) {
+		using R = widen<T>;
+		constexpr std::size_t W = R::width;
+		typename R::type s0 = R::zero(), s1 = R::zero();
+		for (; i + 2 * W <= n; i += 2 * W) {
+			s0 = R::step(s0, a + i, b + i);
+			s1 = R::step(s1, a + i + W, b + i + W);
+		}
+		for (; i + W <= n; i += W) {
+			s0 = R::step(s0, a + i, b + i);
+		}
+		result = static_cast<std::uint32_t>(R::sum(R::add(s0, s1)));
+	}
+	for (; i < n; ++i) {
+		result += static_cast<std::uint32_t>(std::int32_t{a[i]} * std::int32_t{b[i]});
+	}
+	return static_cast<std::int32_t>(result);
+}
+
+// y[i] = sum_j a[i * lda + j] * x[j] in int32, one widened dot per row
+template <typename T>
+void gemv_i32(std::size_t m, std::size_t n, const T* a, std::size_t lda, const T* x, std::int32_t* y) {
+	for (std::size_t i = 0; i < m; ++i) {
+		y[i] = dot_i32(a + i * lda, x, n);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Exact int16 dot products, accumulated in int64
+//
+// pmaddwd adds two int16 products into an int32 lane p, with p in
+// [-2^31 + 2^16, 2^31] (2^31 = 2 * (-32768)^2 wraps to INT32_MIN). The lane
+// q = p + 2^31 - 1 then lies in [0, 2^32) as an unsigned number, so a pair
+// of lanes read as one 64-bit value is lo(q) + 2^32 hi(q), with no sign
+// extension: the 64-bit lanes are summed as they are (A), their high halves
+// apart (H, a logical shift), and sum(p) = A - 2^32 H + H - (2^31 - 1) per
+// lane. No cross-lane shuffle is needed, and the result is exact for any n
+// below 2^32 (no wrapping, unlike dot_i32).
+//
+// widen64<T> is only defined for int16; other types and targets (SSE2
+// without SSE4.1) use the scalar loop.
+//------------------------------------------------------------------------------
+
+template <typename T> struct widen64;
+
+#if defined(__AVX512BW__)
+
+template <> struct widen64<std::int16_t> {
+	struct type {
+		__m512i all;
+		__m512i high;
+	};
+	static constexpr std::size_t width = 32;
+	static type zero() { return {_mm512_setzero_si512(), _mm512_setzero_si512()}; }
+	static type step(type acc, const std::int16_t* a, const std::int16_t* b) {
+		const __m512i p = _mm512_madd_epi16(_mm512_loadu_si512(a), _mm512_loadu_si512(b));
+		const __m512i q = _mm512_add_epi32(p, _mm512_set1_epi32(0x7FFFFFFF));
+		return {_mm512_add_epi64(acc.all, q), _mm512_add_epi64(acc.high, _mm512_maskz_srli_epi64(0xFF, q, 32))};
+	}
+	// Sum of the biased lanes, all - 2^32 high + high. The shifts are
+	// zero-masked for the same reason as reduce_add.
+	static std::uint64_t sum(type acc) {
+		const __m512i high = _mm512_maskz_slli_epi64(0xFF, acc.high, 32);
+		const __m512i r = _mm512_add_epi64(_mm512_sub_epi64(acc.all, high), acc.high);
+		return static_cast<std::uint64_t>(reduce_add_epi64(r));
+	}
+};
+
+#elif defined(__AVX2__)
+
+template <> struct widen64<std::int16_t> {
+	struct type {
+		__m256i all;
+		__m256i high;
+	};
+	static constexpr std::size_t width = 16;
+	static type zero() { return {_mm256_setzero_si256(), _mm256_setzero_si256()}; }
+	static type step(type acc, const std::int16_t* a, const std::int16_t* b) {
+		const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+		const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+		const __m256i q = _mm256_add_epi32(_mm256_madd_epi16(va, vb), _mm256_set1_epi32(0x7FFFFFFF));
+		return {_mm256_add_epi64(acc.all, q), _mm256_add_epi64(acc.high, _mm256_srli_epi64(q, 32))};
+	}
+	static std::uint64_t sum(type acc) {
+		const __m256i r = _mm256_add_epi64(_mm256_sub_epi64(acc.all, _mm256_slli_epi64(acc.high, 32)), acc.high);
+		const __m128i s = _mm_add_epi64(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+		return static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_add_epi64(s, _mm_unpackhi_epi64(s, s))));
+	}
+};
+
+#elif defined(__SSE4_1__)
+
+template <> struct widen64<std::int16_t> {
+	struct type {
+		__m128i all;
+		__m128i high;
+	};
+	static constexpr std::size_t width = 8;
+	static type zero() { return {_mm_setzero_si128(), _mm_setzero_si128()}; }
+	static type step(type acc, const std::int16_t* a, const std::int16_t* b) {
+		const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+		const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+		const __m128i q = _mm_add_epi32(_mm_madd_epi16(va, vb), _mm_set1_epi32(0x7FFFFFFF));
+		return {_mm_add_epi64(acc.all, q), _mm_add_epi64(acc.high, _mm_srli_epi64(q, 32))};
+	}
+	static std::uint64_t sum(type acc) {
+		const __m128i r = _mm_add_epi64(_mm_sub_epi64(acc.all, _mm_slli_epi64(acc.high, 32)), acc.high);
+		return static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_add_epi64(r, _mm_unpackhi_epi64(r, r))));
+	}
+};
+
+#endif
+
+// True when widen64<T> has a vector implementation on this target
+template <typename T>
+concept widened64 = requires { widen64<std::remove_cv_t<T>>::width; };
+
+// Sum of a[i] * b[i] in int64, exact for 8- and 16-bit integers
+template <typename T>
+std::int64_t dot_i64(const T* a, const T* b, std::size_t n) {
+	std::size_t i = 0;
+	std::int64_t result = 0;
+	if constexpr (widened64<T>) {
+		using R = widen64<T>;
+		constexpr std::size_t W = R::width;
+		typename R::type s = R::zero();
+		for (; i + W <= n; i += W) {
+			s = R::step(s, a + i, b + i);
+		}
+		const std::uint64_t lanes = i / 2;
+		result = static_cast<std::int64_t>(R::sum(s) - lanes * 0x7FFFFFFFu);
+	}
+	for (; i < n; ++i) {
+		result += std::int64_t{a[i]} * std::int64_t{b[i]};
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// scale: out[i] = x[i] * alpha
+//------------------------------------------------------------------------------
+
+template <typename T>
+void scale(const T* x, T alpha, T* out, std::size_t n) {
+	std::size_t i = 0;
+	if constexpr (vectorized<T>) {
+		using R = reg<T>;
+		constexpr std::size_t W = R::width;
+		const typename R::type va = R::set1(alpha);
+		for (; i + 2 * W <= n; i += 2 * W) {
+			R::store(out + i, R::mul(R::load(x + i), va));
+			R::store(out + i + W, R::mul(R::load(x + i + W), va));
+		}
+		for (; i + W <= n; i += W) {
+			R::store(out + i, R::mul(R::load(x + i), va));
+		}
+	}
+	for (; i < n; ++i) {
+		out[i] = x[i] * alpha;
+	}
+}
+
+//------------------------------------------------------------------------------
+// axpy: y[i] += alpha * x[i]
+//------------------------------------------------------------------------------
+
+template <typename T>
+void axpy(std::size_t n, T alpha, const T* x, T* y) {
+	std::size_t i = 0;
+	if constexpr (vectorized<T>) {
+		using R = reg<T>;
+		constexpr std::size_t W = R::width;
+		const typename R::type va = R::set1(alpha);
+		for (; i + 2 * W <= n; i += 2 * W) {
+			R::store(y + i, R::fma(va, R::load(x + i), R::load(y + i)));
+			R::store(y + i + W, R::fma(va, R::load(x + i + W), R::load(y + i + W)));
+		}
+		for (; i + W <= n; i += W) {
+			R::store(y + i, R::fma(va, R::load(x + i), R::load(y + i)));
+		}
+	}
+	for (; i < n; ++i) {
+		y[i] += alpha * x[i];
+	}
+}
+
+//------------------------------------------------------------------------------
+// gemv: y[i] = alpha * sum_j a[i * lda + j] * x[j] + beta * y[i] for a
+// row-major m x n matrix. With beta == 0, y is not read (BLAS convention).
+//
+// Four rows are processed together so that every load of x feeds four
+// independent accumulator chains and the matrix is streamed exactly once.
+//------------------------------------------------------------------------------
+
+template <typename T>
+void gemv(std::size_t m, std::size_t n, T alpha, const T* a, std::size_t lda, const T* x, T beta, T* y) {
+	auto put = [=](std::size_t r, T v) {
+		y[r] = beta == T{} ? alpha * v : alpha * v + beta * y[r];
+	};
+	std::size_t i = 0;
+	if constexpr (vectorized<T>) {
+		using R = reg<T>;
+		constexpr std::size_t W = R::width;
+		for (; i + 4 <= m; i += 4) {
+			const T* a0 = a + i * lda;
+			const T* a1 = a0 + lda;
+			const T* a2 = a1 + lda;
+			const T* a3 = a2 + lda;
+			typename R::type s0 = R::zero(), s1 = R::zero(), s2 = R::zero(), s3 = R::zero();
+			std::size_t j = 0;
+			for (; j + W <= n; j += W) {
+				const typename R::type vx = R::load(x + j);
+				s0 = R::fma(R::load(a0 + j), vx, s0);
+				s1 = R::fma(R::load(a1 + j), vx, s1);
+				s2 = R::fma(R::load(a2 + j), vx, s2);
+				s3 = R::fma(R::load(a3 + j), vx, s3);
+			}
+			T r0 = R::sum(s0), r1 = R::sum(s1), r2 = R::sum(s2), r3 = R::sum(s3);
+			for (; j < n; ++j) {
+				r0 += a0[j] * x[j];
+				r1 += a1[j] * x[j];
+				r2 += a2[j] * x[j];
+				r3 += a3[j] * x[j];
+			}
+			put(i, r0);
+			put(i + 1, r1);
+			put(i + 2, r2);
+			put(i + 3, r3);
+		}
+	}
+	for (; i < m; ++i) {
+		put(i, simd::dot(a + i * lda, x, n));
+	}
+}
+
+// y = A * x
+template <typename T>
+void gemv(std::size_t m, std::size_t n, const T* a, std::size_t lda, const T* x, T* y) {
+	gemv(m, n, T(1), a, lda, x, T{}, y);
+}
+
+//------------------------------------------------------------------------------
+// transpose_tile: dst[j * ldd + i] = src[i * lds + j] on a W x W tile
+//
+// W = transpose_width<T>(). 4-byte and 8-byte element types are moved as
+// float/double bit patterns with register shuffles, anything else (or a
+// target without SSE2) goes through a scalar 4x4 tile.
+//------------------------------------------------------------------------------
+
+template <typename T>
+constexpr std::size_t transpose_width() {
+#if defined(__AVX__)
+	if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+		return 32 / sizeof(T);
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+		return 16 / sizeof(T);
+	}
+#endif
+	return 4;
+}
+
+template <typename T>
+void transpose_tile(const T* src, std::size_t lds, T* dst, std::size_t ldd) {
+	[[maybe_unused]] const float* fs = reinterpret_cast<const float*>(src);
+	[[maybe_unused]] float* fd = reinterpret_cast<float*>(dst);
+	[[maybe_unused]] const double* ds = reinterpret_cast<const double*>(src);
+	[[maybe_unused]] double* dd = reinterpret_cast<double*>(dst);
+
+#if defined(__AVX__)
+	if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 4) {
+		// 8x8: interleave pairs of rows, then 2x2 blocks, then 128-bit halves
+		__m256 r0 = _mm256_loadu_ps(fs + 0 * lds), r1 = _mm256_loadu_ps(fs + 1 * lds);
+		__m256 r2 = _mm256_loadu_ps(fs + 2 * lds), r3 = _mm256_loadu_ps(fs + 3 * lds);
+		__m256 r4 = _mm256_loadu_ps(fs + 4 * lds), r5 = _mm256_loadu_ps(fs + 5 * lds);
+		__m256 r6 = _mm256_loadu_ps(fs + 6 * lds), r7 = _mm256_loadu_ps(fs + 7 * lds);
+		__m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+		__m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+		__m256 t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5);
+		__m256 t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+		r0 = _mm256_shuffle_ps(t0, t2, 0x44); r1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+		r2 = _mm256_shuffle_ps(t1, t3, 0x44); r3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+		r4 = _mm256_shuffle_ps(t4, t6, 0x44); r5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+		r6 = _mm256_shuffle_ps(t5, t7, 0x44); r7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+		_mm256_storeu_ps(fd + 0 * ldd, _mm256_permute2f128_ps(r0, r4, 0x20));
+		_mm256_storeu_ps(fd + 1 * ldd, _mm256_permute2f128_ps(r1, r5, 0x20));
+		_mm256_storeu_ps(fd + 2 * ldd, _mm256_permute2f128_ps(r2, r6, 0x20));
+		_mm256_storeu_ps(fd + 3 * ldd, _mm256_permute2f128_ps(r3, r7, 0x20));
+		_mm256_storeu_ps(fd + 4 * ldd, _mm256_permute2f128_ps(r0, r4, 0x31));
+		_mm256_storeu_ps(fd + 5 * ldd, _mm256_permute2f128_ps(r1, r5, 0x31));
+		_mm256_storeu_ps(fd + 6 * ldd, _mm256_permute2f128_ps(r2, r6, 0x31));
+		_mm256_storeu_ps(fd + 7 * ldd, _mm256_permute2f128_ps(r3, r7, 0x31));
+		return;
+	} else if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 8) {
+		// 4x4: interleave pairs of rows, then swap 128-bit halves
+		__m256d r0 = _mm256_loadu_pd(ds + 0 * lds), r1 = _mm256_loadu_pd(ds + 1 * lds);
+		__m256d r2 = _mm256_loadu_pd(ds + 2 * lds), r3 = _mm256_loadu_pd(ds + 3 * lds);
+		__m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+		__m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+		_mm256_storeu_pd(dd + 0 * ldd, _mm256_permute2f128_pd(t0, t2, 0x20));
+		_mm256_storeu_pd(dd + 1 * ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+		_mm256_storeu_pd(dd + 2 * ldd, _mm256_permute2f128_pd(t0, t2, 0x31));
+		_mm256_storeu_pd(dd + 3 * ldd, _mm256_permute2f128_pd(t1, t3, 0x31));
+		return;
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 4) {
+		__m128 r0 = _mm_loadu_ps(fs + 0 * lds), r1 = _mm_loadu_ps(fs + 1 * lds);
+		__m128 r2 = _mm_loadu_ps(fs + 2 * lds), r3 = _mm_loadu_ps(fs + 3 * lds);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		_mm_storeu_ps(fd + 0 * ldd, r0);
+		_mm_storeu_ps(fd + 1 * ldd, r1);
+		_mm_storeu_ps(fd + 2 * ldd, r2);
+		_mm_storeu_ps(fd + 3 * ldd, r3);
+		return;
+	} else if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 8) {
+		__m128d r0 = _mm_loadu_pd(ds), r1 = _mm_loadu_pd(ds + lds);
+		_mm_storeu_pd(dd, _mm_unpacklo_pd(r0, r1));
+		_mm_storeu_pd(dd + ldd, _mm_unpackhi_pd(r0, r1));
+		return;
+	}
+#endif
+	constexpr std::size_t W = transpose_width<T>();
+	for (std::size_t i = 0; i < W; ++i) {
+		for (std::size_t j = 0; j < W; ++j) {
+			dst[j * ldd + i] = src[i * lds + j];
+		}
+	}
+}
+
+} // namespace simd
@@ -0,0 +1,647 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_arena.hpp"
+#include "01_corr_matvec_dyn.hpp"
+#include "01_corr_matvec_batch.hpp"
+#include "01_corr_matvec_simd.hpp"
+
+// Dense linear solvers
+//
+//   lu(A)         P A = L U, partial pivoting      (square)
+//   cholesky(A)   A = L L^T                        (symmetric positive definite)
+//   qr(A)         A = Q R, Householder reflectors  (m >= n, least squares)
+//
+// A is a row-major mat or a dyn_mat; the factorization works on a copy.
+// The returned objects solve for a vector, or for a matrix whose columns are
+// as many right-hand sides, and return the same kind of object. lu(A, ws),
+// cholesky(A, ws) and qr(A, ws) take the copy, the pivots and the results
+// from the arena ws; the internal temporaries always come from a per-thread
+// arena, so a loop of such calls does not allocate once it has warmed up.
+//
+// Factorizations are blocked: a panel of factor_block columns is factorized
+// with level-2 loops, then the trailing matrix is updated with the blocked
+// GEMM kernel, which carries most of the O(n^3) work. Triangular solves with
+// several right-hand sides are blocked the same way. For mat<T, N, N> with
+// N <= 4, solve(), inverse() and determinant() use straight-line cofactor
+// formulas instead.
+
+namespace detail {
+
+// Panel width of the blocked factorizations and triangular solves
+inline constexpr std::size_t factor_block = 64;
+
+//------------------------------------------------------------------------------
+// Row-major view of the operands: rows x cols, leading dimension ld (a
+// vector is a single column)
+//------------------------------------------------------------------------------
+
+template <typename T> struct dense_ref {
+	T* data;
+	std::size_t rows;
+	std::size_t cols;
+	std::size_t ld;
+};
+
+template <typename T, std::size_t M, std::size_t N> dense_ref<T> dense(mat<T, M, N>& A) {
+	return {A.data.data(), M, N, N};
+}
+
+template <typename T, std::size_t M, std::size_t N> dense_ref<const T> dense(const mat<T, M, N>& A) {
+	return {A.data.data(), M, N, N};
+}
+
+template <typename T> dense_ref<T> dense(dyn_mat<T>& A) {
+	return {A.data(), A.m(), A.n(), A.ld()};
+}
+
+template <typename T> dense_ref<const T> dense(const dyn_mat<T>& A) {
+	return {A.data(), A.m(), A.n(), A.ld()};
+}
+
+template <typename T, std::size_t N> dense_ref<T> dense(vec<T, N>& v) {
+	return {v.data.data(), N, 1, 1};
+}
+
+template <typename T> dense_ref<T> dense(dyn_vec<T>& v) {
+	return {v.data(), v.size(), 1, 1};
+}
+
+// Element type of a mat or dyn_mat
+template <typename Matrix>
+using scalar_of = std::remove_cvref_t<decltype(std::declval<const Matrix&>()(0, 0))>;
+
+// Object of the same kind as b with `rows` rows (Rows for fixed sizes),
+// taken from ws when there is one
+template <std::size_t Rows, typename T, std::size_t M>
+vec<T, Rows> with_rows(const vec<T, M>&, std::size_t, arena*) {
+	return {};
+}
+
+template <std::size_t Rows, typename T, std::size_t M, std::size_t R>
+mat<T, Rows, R> with_rows(const mat<T, M, R>&, std::size_t, arena*) {
+	return {};
+}
+
+template <std::size_t Rows, typename T> dyn_vec<T> with_rows(const dyn_vec<T>&, std::size_t rows, arena* ws) {
+	return ws ? dyn_vec<T>(rows, *ws) : dyn_vec<T>(rows);
+}
+
+template <std::size_t Rows, typename T> dyn_mat<T> with_rows(const dyn_mat<T>& b, std::size_t rows, arena* ws) {
+	return ws ? dyn_mat<T>(rows, b.n(), *ws) : dyn_mat<T>(rows, b.n());
+}
+
+// Copy of A, taken from ws for a dyn_mat
+template <typename T, std::size_t M, std::size_t N> mat<T, M, N> copy_in(const mat<T, M, N>& A, arena&) {
+	return A;
+}
+
+template <typename T> dyn_mat<T> copy_in(const dyn_mat<T>& A, arena& ws) {
+	return dyn_mat<T>(A, ws);
+}
+
+// Number of columns of a fixed-size matrix, 0 for dyn_mat
+template <typename Matrix> inline constexpr std::size_t static_cols = 0;
+template <typename T, std::size_t M, std::size_t N> inline constexpr std::size_t static_cols<mat<T, M, N>> = N;
+
+//------------------------------------------------------------------------------
+// Triangular solve: B <- T^-1 B, T n x n lower or upper triangular with
+// element (i, j) at t[i * rst + j * cst] (T^T is the same storage with the
+// strides exchanged), B n x r with leading dimension ldb. unit: the
+// diagonal of T is implicitly 1.
+//------------------------------------------------------------------------------
+
+// Substitution on rows [i0, i1), the other rows being already accounted for
+template <typename T>
+void trsm_block(bool lower, bool unit, std::size_t i0, std::size_t i1, std::size_t r,
+                const T* t, std::size_t rst, std::size_t cst, T* b, std::size_t ldb) {
+	for (std::size_t s = i0; s < i1; ++s) {
+		const std::size_t i = lower ? s : i0 + i1 - 1 - s;
+		const std::size_t k0 = lower ? i0 : i + 1;
+		const std::size_t k1 = lower ? i : i1;
+		T* bi = b + i * ldb;
+		if (r == 1 && cst == 1 && ldb == 1) {
+			bi[0] -= simd::dot(t + i * rst + k0, b + k0, k1 - k0);
+		} else {
+			for (std::size_t k = k0; k < k1; ++k) {
+				simd::axpy(r, -t[i * rst + k * cst], b + k * ldb, bi);
+			}
+		}
+		if (!unit) {
+			const T inv = T(1) / t[i * rst + i * cst];
+			for (std::size_t j = 0; j < r; ++j) {
+				bi[j] *= inv;
+			}
+		}
+	}
+}
+
+template <typename T>
+void trsm(bool lower, bool unit, std::size_t n, std::size_t r,
+          const T* t, std::size_t rst, std::size_t cst, T* b, std::size_t ldb) {
+	if (r < 4 || n <= factor_block) {
+		trsm_block(lower, unit, 0, n, r, t, rst, cst, b, ldb);
+		return;
+	}
+	const std::size_t blocks = (n + factor_block - 1) / factor_block;
+	for (std::size_t s = 0; s < blocks; ++s) {
+		const std::size_t i0 = (lower ? s : blocks - 1 - s) * factor_block;
+		const std::size_t i1 = std::min(n, i0 + factor_block);
+		// Remove the contribution of the rows solved by the previous blocks
+		if (lower && i0 > 0) {
+			gemm_blocked<T, gemm_blocking<T>>(i1 - i0, r, i0, t + i0 * rst, rst, cst, b, ldb, 1,
+			                                  b + i0 * ldb, ldb, 1, T(-1));
+		} else if (!lower && i1 < n) {
+			gemm_blocked<T, gemm_blocking<T>>(i1 - i0, r, n - i1, t + i0 * rst + i1 * cst, rst, cst,
+			                                  b + i1 * ldb, ldb, 1, b + i0 * ldb, ldb, 1, T(-1));
+		}
+		trsm_block(lower, unit, i0, i1, r, t, rst, cst, b, ldb);
+	}
+}
+
+//------------------------------------------------------------------------------
+// LU with partial pivoting: P A = L U with L unit lower, both stored in a;
+// row k was exchanged with row piv[k] at step k. Returns false on a zero
+// pivot (the factorization still completes, but U is singular).
+//------------------------------------------------------------------------------
+
+// Panel of columns [k0, k0 + kb): pivoting swaps whole rows, the update is
+// restricted to the panel
+template <typename T>
+bool lu_panel(std::size_t n, T* a, std::size_t ld, std::size_t k0, std::size_t kb, std::size_t* piv) {
+	bool regular = true;
+	const std::size_t k1 = k0 + kb;
+	for (std::size_t k = k0; k < k1; ++k) {
+		std::size_t p = k;
+		for (std::size_t i = k + 1; i < n; ++i) {
+			if (std::abs(a[i * ld + k]) > std::abs(a[p * ld + k])) {
+				p = i;
+			}
+		}
+		piv[k] = p;
+		if (p != k) {
+			std::swap_ranges(a + k * ld, a + k * ld + n, a + p * ld);
+		}
+		if (a[k * ld + k] == T{}) {
+			regular = false;
+			continue;
+		}
+		const T inv = T(1) / a[k * ld + k];
+		for (std::size_t i = k + 1; i < n; ++i) {
+			const T l = a[i * ld + k] *= inv;
+			simd::axpy(k1 - k - 1, -l, a + k * ld + k + 1, a + i * ld + k + 1);
+		}
+	}
+	return regular;
+}
+
+template <typename T> bool lu_factor(std::size_t n, T* a, std::size_t ld, std::size_t* piv) {
+	bool regular = true;
+	for (std::size_t k0 = 0; k0 < n; k0 += factor_block) {
+		const std::size_t kb = std::min(factor_block, n - k0);
+		const std::size_t k1 = k0 + kb;
+		regular = lu_panel(n, a, ld, k0, kb, piv) && regular;
+		if (k1 < n) {
+			// U12 = L11^-1 A12, then A22 -= L21 U12
+			trsm_block(true, true, k0, k1, n - k1, a, ld, std::size_t{1}, a + k1, ld);
+			gemm_blocked<T, gemm_blocking<T>>(n - k1, n - k1, kb, a + k1 * ld + k0, ld, 1,
+			                                  a + k0 * ld + k1, ld, 1, a + k1 * ld + k1, ld, 1, T(-1));
+		}
+	}
+	return regular;
+}
+
+//------------------------------------------------------------------------------
+// Cholesky: A = L L^T, L stored in the lower triangle of a (the upper
+// triangle is cleared). Returns false if A is not positive definite.
+//------------------------------------------------------------------------------
+
+template <typename T> bool cholesky_factor(std::size_t n, T* a, std::size_t ld) {
+	for (std::size_t k0 = 0; k0 < n; k0 += factor_block) {
+		const std::size_t kb = std::min(factor_block, n - k0);
+		const std::size_t k1 = k0 + kb;
+		// L11 and L21 = A21 L11^-T, with dot products along the rows
+		for (std::size_t j = k0; j < k1; ++j) {
+			const T* lj = a + j * ld + k0;
+			const T d = a[j * ld + j] - simd::dot(lj, lj, j - k0);
+			if (!(d > T{})) {
+				return false;
+			}
+			const T ljj = std::sqrt(d);
+			a[j * ld + j] = ljj;
+			for (std::size_t i = j + 1; i < n; ++i) {
+				T* li = a + i * ld + k0;
+				li[j - k0] = (li[j - k0] - simd::dot(li, lj, j - k0)) / ljj;
+			}
+		}
+		// A22 -= L21 L21^T, lower block triangle only
+		for (std::size_t i0 = k1; i0 < n; i0 += factor_block) {
+			const std::size_t i1 = std::min(n, i0 + factor_block);
+			gemm_blocked<T, gemm_blocking<T>>(i1 - i0, i1 - k1, kb, a + i0 * ld + k0, ld, 1,
+			                                  a + k1 * ld + k0, 1, ld, a + i0 * ld + k1, ld, 1, T(-1));
+		}
+	}
+	for (std::size_t i = 0; i < n; ++i) {
+		std::fill(a + i * ld + i + 1, a + i * ld + n, T{});
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Householder QR of an m x n matrix, m >= n: R in the upper triangle, the
+// reflector v_k below the diagonal of column k (v_k[k] = 1 is implicit), and
+// H_k = I - tau[k] v_k v_k^T. Each panel is applied to the trailing matrix in
+// compact WY form, H_k0 ... H_k1-1 = I - V T V^T, i.e. with three GEMMs.
+//------------------------------------------------------------------------------
+
+// Applies H_k to rows k .. m of the r columns at b (leading dimension ldb),
+// with w (r elements) as scratch
+template <typename T>
+void apply_reflector(std::size_t m, std::size_t k, std::size_t r, const T* a, std::size_t ld, T tau,
+                     T* b, std::size_t ldb, T* w) {
+	if (tau == T{} || r == 0) {
+		return;
+	}
+	std::copy_n(b + k * ldb, r, w);
+	for (std::size_t i = k + 1; i < m; ++i) {
+		simd::axpy(r, a[i * ld + k], b + i * ldb, w);
+	}
+	simd::axpy(r, -tau, w, b + k * ldb);
+	for (std::size_t i = k + 1; i < m; ++i) {
+		simd::axpy(r, -tau * a[i * ld + k], w, b + i * ldb);
+	}
+}
+
+template <typename T> void qr_factor(std::size_t m, std::size_t n, T* a, std::size_t ld, T* tau) {
+	arena& ws = scratch_arena();
+	const arena_scope scope(ws);
+	T* w = ws.allocate<T>(n);
+	for (std::size_t k0 = 0; k0 < n; k0 += factor_block) {
+		const std::size_t kb = std::min(factor_block, n - k0);
+		const std::size_t k1 = k0 + kb;
+
+		// Panel: reflector of column k, applied to columns k + 1 .. k1
+		for (std::size_t k = k0; k < k1; ++k) {
+			T norm2{};
+			for (std::size_t i = k + 1; i < m; ++i) {
+				norm2 += a[i * ld + k] * a[i * ld + k];
+			}
+			tau[k] = T{};
+			if (norm2 == T{}) {
+				continue;
+			}
+			const T alpha = a[k * ld + k];
+			const T beta = -std::copysign(std::sqrt(alpha * alpha + norm2), alpha);
+			tau[k] = (beta - alpha) / beta;
+			const T scale = T(1) / (alpha - beta);
+			for (std::size_t i = k + 1; i < m; ++i) {
+				a[i * ld + k] *= scale;
+			}
+			a[k * ld + k] = beta;
+			apply_reflector(m, k, k1 - k - 1, a, ld, tau[k], a + k + 1, ld, w);
+		}
+		if (k1 == n) {
+			break;
+		}
+
+		// V, rows k0 .. m, unit lower trapezoidal
+		const arena_scope panel(ws);
+		const std::size_t rows = m - k0;
+		T* v = ws.allocate<T>(rows * kb);
+		for (std::size_t i = 0; i < rows; ++i) {
+			for (std::size_t j = 0; j < kb && j <= i; ++j) {
+				v[i * kb + j] = i == j ? T(1) : a[(k0 + i) * ld + k0 + j];
+			}
+		}
+		// T upper triangular: T(j, j) = tau_j, T(0:j, j) = -tau_j T(0:j, 0:j) V(:, 0:j)^T v_j
+		T* t = ws.allocate<T>(kb * kb);
+		for (std::size_t j = 0; j < kb; ++j) {
+			const T tj = tau[k0 + j];
+			t[j * kb + j] = tj;
+			for (std::size_t p = 0; p < j; ++p) {
+				T z{};
+				for (std::size_t i = j; i < rows; ++i) {
+					z += v[i * kb + p] * v[i * kb + j];
+				}
+				w[p] = z;
+			}
+			for (std::size_t p = 0; p < j; ++p) {
+				T s{};
+				for (std::size_t q = p; q < j; ++q) {
+					s += t[p * kb + q] * w[q];
+				}
+				t[p * kb + j] = -tj * s;
+			}
+		}
+
+		// A2 -= V T^T V^T A2, A2 being rows k0 .. m of columns k1 .. n
+		const std::size_t cols = n - k1;
+		T* a2 = a + k0 * ld + k1;
+		T* vta = ws.allocate<T>(kb * cols);
+		T* tvta = ws.allocate<T>(kb * cols);
+		gemm_blocked<T, gemm_blocking<T>>(kb, cols, rows, v, 1, kb, a2, ld, 1, vta, cols, 1);
+		gemm_blocked<T, gemm_blocking<T>>(kb, cols, kb, t, 1, kb, vta, cols, 1, tvta, cols, 1);
+		gemm_blocked<T, gemm_blocking<T>>(rows, cols, kb, v, kb, 1, tvta, cols, 1, a2, ld, 1, T(-1));
+	}
+}
+
+//------------------------------------------------------------------------------
+// Closed-form determinant of a row-major N x N matrix (N = 2, 3, 4), with
+// the same minors as small_inverse
+//------------------------------------------------------------------------------
+
+template <std::size_t N, typename T> T small_determinant(const T* a) {
+	static_assert(N >= 2 && N <= 4, "closed-form determinant only for 2x2, 3x3 and 4x4");
+	if constexpr (N == 2) {
+		return a[0] * a[3] - a[1] * a[2];
+	} else if constexpr (N == 3) {
+		return a[0] * (a[4] * a[8] - a[5] * a[7]) + a[1] * (a[5] * a[6] - a[3] * a[8])
+		       + a[2] * (a[3] * a[7] - a[4] * a[6]);
+	} else {
+		const T s0 = a[0] * a[5] - a[4] * a[1];
+		const T s1 = a[0] * a[6] - a[4] * a[2];
+		const T s2 = a[0] * a[7] - a[4] * a[3];
+		const T s3 = a[1] * a[6] - a[5] * a[2];
+		const T s4 = a[1] * a[7] - a[5] * a[3];
+		const T s5 = a[2] * a[7] - a[6] * a[3];
+		const T c5 = a[10] * a[15] - a[14] * a[11];
+		const T c4 = a[9] * a[15] - a[13] * a[11];
+		const T c3 = a[9] * a[14] - a[13] * a[10];
+		const T c2 = a[8] * a[15] - a[12] * a[11];
+		const T c1 = a[8] * a[14] - a[12] * a[10];
+		const T c0 = a[8] * a[13] - a[12] * a[9];
+		return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	}
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// LU factorization
+//------------------------------------------------------------------------------
+
+template <typename Matrix> class lu_factorization {
+	public:
+	using value_type = detail::scalar_of<Matrix>;
+
+	explicit lu_factorization(const Matrix& A) : lu(A), piv(detail::dense(A).rows) { compute(); }
+
+	// Factors and pivots taken from ws
+	lu_factorization(const Matrix& A, arena& ws) : lu(detail::copy_in(A, ws)), piv(detail::dense(A).rows, ws) {
+		compute();
+	}
+
+	// A zero pivot was met: solve() would divide by zero
+	bool singular() const { return !regular; }
+
+	// L (unit diagonal, strictly lower part) and U (upper part) in one matrix
+	const Matrix& factors() const { return lu; }
+
+	// Step k exchanged rows k and pivots()[k]
+	const dyn_vec<std::size_t>& pivots() const { return piv; }
+
+	value_type determinant() const {
+		const auto a = detail::dense(lu);
+		value_type det(1);
+		for (std::size_t k = 0; k < a.rows; ++k) {
+			det *= piv[k] == k ? a.data[k * a.ld + k] : -a.data[k * a.ld + k];
+		}
+		return det;
+	}
+
+	// A^-1 b for a vector, or for every column of a matrix
+	template <typename B> B solve(B b) const {
+		assert(regular && "solve with a singular matrix");
+		const auto a = detail::dense(lu);
+		const auto x = detail::dense(b);
+		assert(x.rows == a.rows && "solve size mismatch");
+		for (std::size_t k = 0; k < a.rows; ++k) {
+			if (piv[k] != k) {
+				std::swap_ranges(x.data + k * x.ld, x.data + k * x.ld + x.cols, x.data + piv[k] * x.ld);
+			}
+		}
+		detail::trsm(true, true, a.rows, x.cols, a.data, a.ld, 1, x.data, x.ld);
+		detail::trsm(false, false, a.rows, x.cols, a.data, a.ld, 1, x.data, x.ld);
+		return b;
+	}
+
+	private:
+	void compute() {
+		const auto a = detail::dense(lu);
+		assert(a.rows == a.cols && "LU needs a square matrix");
+		regular = detail::lu_factor(a.rows, a.data, a.ld, piv.data());
+	}
+
+	Matrix lu;
+	dyn_vec<std::size_t> piv;
+	bool regular = true;
+};
+
+template <typename Matrix> lu_factorization<Matrix> lu(const Matrix& A) {
+	return lu_factorization<Matrix>(A);
+}
+
+template <typename Matrix> lu_factorization<Matrix> lu(const Matrix& A, arena& ws) {
+	return lu_factorization<Matrix>(A, ws);
+}
+
+//------------------------------------------------------------------------------
+// Cholesky factorization
+//------------------------------------------------------------------------------
+
+template <typename Matrix> class cholesky_factorization {
+	public:
+	using value_type = detail::scalar_of<Matrix>;
+
+	// Only the lower triangle of A is read
+	explicit cholesky_factorization(const Matrix& A) : l(A) { compute(); }
+
+	// Factor taken from ws
+	cholesky_factorization(const Matrix& A, arena& ws) : l(detail::copy_in(A, ws)) { compute(); }
+
+	// False if A is not (numerically) symmetric positive definite
+	bool positive_definite() const { return definite; }
+
+	// L, lower triangular with a positive diagonal
+	const Matrix& factor() const { return l; }
+
+	// A^-1 b by L y = b, then L^T x = y
+	template <typename B> B solve(B b) const {
+		assert(definite && "solve with a matrix that is not positive definite");
+		const auto a = detail::dense(l);
+		const auto x = detail::dense(b);
+		assert(x.rows == a.rows && "solve size mismatch");
+		detail::trsm(true, false, a.rows, x.cols, a.data, a.ld, 1, x.data, x.ld);
+		detail::trsm(false, false, a.rows, x.cols, a.data, 1, a.ld, x.data, x.ld);
+		return b;
+	}
+
+	private:
+	void compute() {
+		const auto a = detail::dense(l);
+		assert(a.rows == a.cols && "Cholesky needs a square matrix");
+		definite = detail::cholesky_factor(a.rows, a.data, a.ld);
+	}
+
+	Matrix l;
+	bool definite = true;
+};
+
+template <typename Matrix> cholesky_factorization<Matrix> cholesky(const Matrix& A) {
+	return cholesky_factorization<Matrix>(A);
+}
+
+template <typename Matrix> cholesky_factorization<Matrix> cholesky(const Matrix& A, arena& ws) {
+	return cholesky_factorization<Matrix>(A, ws);
+}
+
+//------------------------------------------------------------------------------
+// QR factorization
+//------------------------------------------------------------------------------
+
+template <typename Matrix> class qr_factorization {
+	public:
+	using value_type = detail::scalar_of<Matrix>;
+
+	explicit qr_factorization(const Matrix& A) : qr(A), tau(detail::dense(A).cols) { compute(); }
+
+	// Factors and coefficients taken from ws
+	qr_factorization(const Matrix& A, arena& ws) : qr(detail::copy_in(A, ws)), tau(detail::dense(A).cols, ws) {
+		compute();
+	}
+
+	// R in the upper triangle, the Householder vectors below it
+	const Matrix& factors() const { return qr; }
+
+	// Scalar factors of the reflectors H_k = I - tau_k v_k v_k^T
+	const dyn_vec<value_type>& coefficients() const { return tau; }
+
+	// Least-squares solution of A x = b (the exact one when A is square and
+	// regular): x has n rows where b has m
+	template <typename B> auto solve(B b) const { return solve_least_squares(b, nullptr); }
+
+	// Same, with x taken from ws
+	template <typename B> auto solve(B b, arena& ws) const { return solve_least_squares(b, &ws); }
+
+	private:
+	void compute() {
+		const auto a = detail::dense(qr);
+		assert(a.rows >= a.cols && "QR needs at least as many rows as columns");
+		detail::qr_factor(a.rows, a.cols, a.data, a.ld, tau.data());
+	}
+
+	template <typename B> auto solve_least_squares(B& b, arena* ws) const {
+		const auto a = detail::dense(qr);
+		const auto y = detail::dense(b);
+		assert(y.rows == a.rows && "solve size mismatch");
+		// y <- Q^T b, then R x = y(0:n)
+		{
+			arena& scratch = detail::scratch_arena();
+			const arena_scope scope(scratch);
+			value_type* w = scratch.allocate<value_type>(y.cols);
+			for (std::size_t k = 0; k < a.cols; ++k) {
+				detail::apply_reflector(a.rows, k, y.cols, a.data, a.ld, tau[k], y.data, y.ld, w);
+			}
+		}
+		detail::trsm(false, false, a.cols, y.cols, a.data, a.ld, 1, y.data, y.ld);
+		auto result = detail::with_rows<detail::static_cols<Matrix>>(b, a.cols, ws);
+		const auto x = detail::dense(result);
+		for (std::size_t i = 0; i < a.cols; ++i) {
+			std::copy_n(y.data + i * y.ld, y.cols, x.data + i * x.ld);
+		}
+		return result;
+	}
+
+	Matrix qr;
+	dyn_vec<value_type> tau;
+};
+
+template <typename Matrix> qr_factorization<Matrix> qr(const Matrix& A) {
+	return qr_factorization<Matrix>(A);
+}
+
+template <typename Matrix> qr_factorization<Matrix> qr(const Matrix& A, arena& ws) {
+	return qr_factorization<Matrix>(A, ws);
+}
+
+//------------------------------------------------------------------------------
+// Direct solve, inverse and determinant (the factorization is a temporary of
+// the per-thread arena)
+//------------------------------------------------------------------------------
+
+template <typename T, std::size_t N> vec<T, N> solve(const mat<T, N, N>& A, const vec<T, N>& b) {
+	if constexpr (N == 1) {
+		return vec<T, N>(b[0] / A(0, 0));
+	} else if constexpr (N <= 4) {
+		mat<T, N, N> inv;
+		detail::small_inverse<N>(A.data.data(), inv.data.data());
+		return inv * b;
+	} else {
+		arena& ws = detail::scratch_arena();
+		const arena_scope scope(ws);
+		return lu(A, ws).solve(b);
+	}
+}
+
+template <typename T> dyn_vec<T> solve(const dyn_mat<T>& A, const dyn_vec<T>& b) {
+	arena& ws = detail::scratch_arena();
+	const arena_scope scope(ws);
+	return lu(A, ws).solve(b);
+}
+
+// Same, with the factorization and x taken from ws
+template <typename T> dyn_vec<T> solve(const dyn_mat<T>& A, const dyn_vec<T>& b, arena& ws) {
+	return lu(A, ws).solve(dyn_vec<T>(b, ws));
+}
+
+template <typename T, std::size_t N> mat<T, N, N> inverse(const mat<T, N, N>& A) {
+	mat<T, N, N> result;
+	if constexpr (N == 1) {
+		result(0, 0) = T(1) / A(0, 0);
+	} else if constexpr (N <= 4) {
+		detail::small_inverse<N>(A.data.data(), result.data.data());
+	} else {
+		for (std::size_t i = 0; i < N; ++i) {
+			result(i, i) = T(1);
+		}
+		arena& ws = detail::scratch_arena();
+		const arena_scope scope(ws);
+		result = lu(A, ws).solve(result);
+	}
+	return result;
+}
+
+template <typename T> dyn_mat<T> inverse(const dyn_mat<T>& A) {
+	dyn_mat<T> identity(A.m(), A.n());
+	for (std::size_t i = 0; i < A.m(); ++i) {
+		identity(i, i) = T(1);
+	}
+	arena& ws = detail::scratch_arena();
+	const arena_scope scope(ws);
+	return lu(A, ws).solve(std::move(identity));
+}
+
+template <typename T, std::size_t N> T determinant(const mat<T, N, N>& A) {
+	if constexpr (N == 1) {
+		return A(0, 0);
+	} else if constexpr (N <= 4) {
+		return detail::small_determinant<N>(A.data.data());
+	} else {
+		arena& ws = detail::scratch_arena();
+		const arena_scope scope(ws);
+		return lu(A, ws).determinant();
+	}
+}
+
+template <typename T> T determinant(const dyn_mat<T>& A) {
+	arena& ws = detail::scratch_arena();
+	const arena_scope scope(ws);
+	return lu(A, ws).determinant();
+}
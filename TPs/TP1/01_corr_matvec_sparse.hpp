@@ -0,0 +1,397 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+#include "01_corr_matvec_parallel.hpp"
+
+// Sparse matrices
+//
+// coo_matrix collects (row, col, value) triplets in any order. It is then
+// compressed into one of:
+//  - csr_matrix: rows stored one after the other (fast A * x, A * B)
+//  - csc_matrix: columns stored one after the other (fast x * A)
+//  - bsr_matrix<T, B>: CSR over dense B x B blocks, for operators whose
+//    non-zeros come in small dense clusters
+// Duplicate triplets are summed. Products cost O(nnz) instead of O(m * n)
+// and follow the dyn_mat conventions: sizes are checked with assert and
+// results are dyn_vec / dyn_mat.
+
+//------------------------------------------------------------------------------
+// COO builder
+//------------------------------------------------------------------------------
+
+template <typename T> struct triplet {
+	std::size_t row;
+	std::size_t col;
+	T value;
+};
+
+template <typename T> class coo_matrix {
+	public:
+	coo_matrix(std::size_t rows, std::size_t cols) : rows_(rows), cols_(cols) {}
+
+	void add(std::size_t i, std::size_t j, const T& value) {
+		assert(i < rows_ && j < cols_ && "coo_matrix index out of range");
+		entries_.push_back({i, j, value});
+	}
+
+	void reserve(std::size_t count) { entries_.reserve(count); }
+
+	std::size_t m() const { return rows_; }
+	std::size_t n() const { return cols_; }
+	const std::vector<triplet<T>>& entries() const { return entries_; }
+
+	private:
+	std::size_t rows_;
+	std::size_t cols_;
+	std::vector<triplet<T>> entries_;
+};
+
+namespace detail {
+
+// Compressed storage along one dimension: entries of major index k are
+// idx/val[ptr[k] .. ptr[k + 1]), sorted by minor index, duplicates summed
+template <typename T> struct compressed {
+	std::vector<std::size_t> ptr;
+	std::vector<std::size_t> idx;
+	std::vector<T> val;
+};
+
+// by_col selects CSC (major = column) instead of CSR (major = row)
+template <typename T>
+compressed<T> compress(std::size_t majors, const std::vector<triplet<T>>& entries, bool by_col) {
+	auto major = [by_col](const triplet<T>& t) { return by_col ? t.col : t.row; };
+	auto minor = [by_col](const triplet<T>& t) { return by_col ? t.row : t.col; };
+
+	std::vector<triplet<T>> sorted(entries);
+	std::sort(sorted.begin(), sorted.end(), [&](const triplet<T>& a, const triplet<T>& b) {
+		return major(a) != major(b) ? major(a) < major(b) : minor(a) < minor(b);
+	});
+
+	compressed<T> c;
+	c.ptr.assign(majors + 1, 0);
+	c.idx.reserve(sorted.size());
+	c.val.reserve(sorted.size());
+	for (std::size_t k = 0; k < sorted.size(); ++k) {
+		const triplet<T>& t = sorted[k];
+		if (k > 0 && major(t) == major(sorted[k - 1]) && minor(t) == minor(sorted[k - 1])) {
+			c.val.back() += t.value;
+			continue;
+		}
+		c.idx.push_back(minor(t));
+		c.val.push_back(t.value);
+		++c.ptr[major(t) + 1];
+	}
+	for (std::size_t k = 0; k < majors; ++k) {
+		c.ptr[k + 1] += c.ptr[k];
+	}
+	return c;
+}
+
+// Entry (major, minor) of compressed storage, zero if absent
+template <typename T> T compressed_at(const compressed<T>& c, std::size_t major, std::size_t minor) {
+	auto first = c.idx.begin() + c.ptr[major];
+	auto last = c.idx.begin() + c.ptr[major + 1];
+	auto it = std::lower_bound(first, last, minor);
+	return (it != last && *it == minor) ? c.val[it - c.idx.begin()] : T{};
+}
+
+// y[i] = sum_k val[k] * x[idx[k]] for rows [first, last)
+template <typename T>
+void csr_spmv(std::size_t first, std::size_t last, const compressed<T>& c, const T* x, T* y) {
+	for (std::size_t i = first; i < last; ++i) {
+		T acc{};
+		for (std::size_t k = c.ptr[i]; k < c.ptr[i + 1]; ++k) {
+			acc += c.val[k] * x[c.idx[k]];
+		}
+		y[i] = acc;
+	}
+}
+
+// Non-zeros handled by one parallel SpMV task
+inline constexpr std::size_t spmv_nnz_per_task = 32768;
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// csr_matrix
+//------------------------------------------------------------------------------
+
+template <typename T> class csr_matrix {
+	public:
+	using value_type = T;
+
+	explicit csr_matrix(const coo_matrix<T>& coo)
+		: rows_(coo.m()), cols_(coo.n()), c(detail::compress(coo.m(), coo.entries(), false)) {}
+
+	std::size_t m() const { return rows_; }
+	std::size_t n() const { return cols_; }
+	std::size_t nnz() const { return c.val.size(); }
+
+	// Entry (i, j), O(log nnz(row i))
+	T operator()(std::size_t i, std::size_t j) const { return detail::compressed_at(c, i, j); }
+
+	const std::vector<std::size_t>& row_ptr() const { return c.ptr; }
+	const std::vector<std::size_t>& col_idx() const { return c.idx; }
+	const std::vector<T>& values() const { return c.val; }
+
+	dyn_mat<T> to_dense() const {
+		dyn_mat<T> result(rows_, cols_);
+		for (std::size_t i = 0; i < rows_; ++i) {
+			for (std::size_t k = c.ptr[i]; k < c.ptr[i + 1]; ++k) {
+				result(i, c.idx[k]) = c.val[k];
+			}
+		}
+		return result;
+	}
+
+	// y = A * x, x and y holding n() and m() elements
+	void spmv(const T* x, T* y) const { detail::csr_spmv(0, rows_, c, x, y); }
+
+	// Same product split into row ranges of about spmv_nnz_per_task
+	// non-zeros. The split only depends on the matrix, and each row is
+	// computed by a single task, so results match spmv() exactly.
+	void spmv(thread_pool& pool, const T* x, T* y) const {
+		const std::size_t tasks = std::max<std::size_t>(1, nnz() / detail::spmv_nnz_per_task);
+		if (tasks == 1) {
+			spmv(x, y);
+			return;
+		}
+		std::vector<std::size_t> bounds(tasks + 1, rows_);
+		bounds[0] = 0;
+		for (std::size_t t = 1; t < tasks; ++t) {
+			auto it = std::lower_bound(c.ptr.begin(), c.ptr.end(), t * nnz() / tasks);
+			bounds[t] = std::max(bounds[t - 1], static_cast<std::size_t>(it - c.ptr.begin()));
+		}
+		pool.parallel_for(tasks, [&](std::size_t t) {
+			detail::csr_spmv(bounds[t], bounds[t + 1], c, x, y);
+		});
+	}
+
+	private:
+	std::size_t rows_;
+	std::size_t cols_;
+	detail::compressed<T> c;
+};
+
+//------------------------------------------------------------------------------
+// csc_matrix
+//------------------------------------------------------------------------------
+
+template <typename T> class csc_matrix {
+	public:
+	using value_type = T;
+
+	explicit csc_matrix(const coo_matrix<T>& coo)
+		: rows_(coo.m()), cols_(coo.n()), c(detail::compress(coo.n(), coo.entries(), true)) {}
+
+	std::size_t m() const { return rows_; }
+	std::size_t n() const { return cols_; }
+	std::size_t nnz() const { return c.val.size(); }
+
+	T operator()(std::size_t i, std::size_t j) const { return detail::compressed_at(c, j, i); }
+
+	const std::vector<std::size_t>& col_ptr() const { return c.ptr; }
+	const std::vector<std::size_t>& row_idx() const { return c.idx; }
+	const std::vector<T>& values() const { return c.val; }
+
+	dyn_mat<T> to_dense() const {
+		dyn_mat<T> result(rows_, cols_);
+		for (std::size_t j = 0; j < cols_; ++j) {
+			for (std::size_t k = c.ptr[j]; k < c.ptr[j + 1]; ++k) {
+				result(c.idx[k], j) = c.val[k];
+			}
+		}
+		return result;
+	}
+
+	// y = A * x, accumulated column by column
+	void spmv(const T* x, T* y) const {
+		std::fill_n(y, rows_, T{});
+		for (std::size_t j = 0; j < cols_; ++j) {
+			const T xj = x[j];
+			for (std::size_t k = c.ptr[j]; k < c.ptr[j + 1]; ++k) {
+				y[c.idx[k]] += c.val[k] * xj;
+			}
+		}
+	}
+
+	// y = x * A: one sparse dot product per column
+	void spmv_left(const T* x, T* y) const { detail::csr_spmv(0, cols_, c, x, y); }
+
+	private:
+	std::size_t rows_;
+	std::size_t cols_;
+	detail::compressed<T> c;
+};
+
+//------------------------------------------------------------------------------
+// bsr_matrix<T, B>: CSR over dense B x B blocks (rows and cols multiples of B)
+//------------------------------------------------------------------------------
+
+template <typename T, std::size_t B> class bsr_matrix {
+	public:
+	using value_type = T;
+
+	static constexpr std::size_t block_size() { return B; }
+
+	explicit bsr_matrix(const coo_matrix<T>& coo) : rows_(coo.m()), cols_(coo.n()) {
+		assert(rows_ % B == 0 && cols_ % B == 0 && "bsr_matrix dimensions must be multiples of B");
+		// One triplet per touched block; its value is the block's slot
+		std::vector<triplet<std::size_t>> touched;
+		touched.reserve(coo.entries().size());
+		for (const auto& t : coo.entries()) {
+			touched.push_back({t.row / B, t.col / B, 0});
+		}
+		detail::compressed<std::size_t> blocks = detail::compress(rows_ / B, touched, false);
+		ptr = std::move(blocks.ptr);
+		idx = std::move(blocks.idx);
+
+		val.assign(idx.size() * B * B, T{});
+		for (const auto& t : coo.entries()) {
+			const std::size_t bi = t.row / B;
+			auto first = idx.begin() + ptr[bi];
+			const std::size_t slot = std::lower_bound(first, idx.begin() + ptr[bi + 1], t.col / B) - idx.begin();
+			val[slot * B * B + (t.row % B) * B + t.col % B] += t.value;
+		}
+	}
+
+	std::size_t m() const { return rows_; }
+	std::size_t n() const { return cols_; }
+	std::size_t blocks() const { return idx.size(); }
+
+	T operator()(std::size_t i, std::size_t j) const {
+		const std::size_t bi = i / B;
+		auto first = idx.begin() + ptr[bi];
+		auto last = idx.begin() + ptr[bi + 1];
+		auto it = std::lower_bound(first, last, j / B);
+		if (it == last || *it != j / B) {
+			return T{};
+		}
+		return val[(it - idx.begin()) * B * B + (i % B) * B + j % B];
+	}
+
+	dyn_mat<T> to_dense() const {
+		dyn_mat<T> result(rows_, cols_);
+		for (std::size_t i = 0; i < rows_; ++i) {
+			for (std::size_t j = 0; j < cols_; ++j) {
+				result(i, j) = (*this)(i, j);
+			}
+		}
+		return result;
+	}
+
+	// y = A * x, one dense B x B mat-vec per stored block
+	void spmv(const T* x, T* y) const {
+		for (std::size_t bi = 0; bi < rows_ / B; ++bi) {
+			T acc[B] = {};
+			for (std::size_t k = ptr[bi]; k < ptr[bi + 1]; ++k) {
+				const T* a = val.data() + k * B * B;
+				const T* xb = x + idx[k] * B;
+				#pragma GCC unroll 8
+				for (std::size_t r = 0; r < B; ++r) {
+					#pragma GCC unroll 8
+					for (std::size_t s = 0; s < B; ++s) {
+						acc[r] += a[r * B + s] * xb[s];
+					}
+				}
+			}
+			std::copy_n(acc, B, y + bi * B);
+		}
+	}
+
+	private:
+	std::size_t rows_;
+	std::size_t cols_;
+	std::vector<std::size_t> ptr;
+	std::vector<std::size_t> idx;
+	std::vector<T> val;
+};
+
+//------------------------------------------------------------------------------
+// Products
+//------------------------------------------------------------------------------
+
+// Sparse matrix-like: csr_matrix, csc_matrix and bsr_matrix
+template <typename S>
+concept sparse_matrix = requires(const S& A, const typename S::value_type* x, typename S::value_type* y) {
+	A.to_dense();
+	A.spmv(x, y);
+};
+
+template <sparse_matrix S> dyn_vec<typename S::value_type> operator*(const S& A, const dyn_vec<typename S::value_type>& x) {
+	assert(A.n() == x.size() && "A*x size mismatch");
+	dyn_vec<typename S::value_type> result(A.m());
+	A.spmv(x.data(), result.data());
+	return result;
+}
+
+template <sparse_matrix S, std::size_t N>
+dyn_vec<typename S::value_type> operator*(const S& A, const vec<typename S::value_type, N>& x) {
+	assert(A.n() == N && "A*x size mismatch");
+	dyn_vec<typename S::value_type> result(A.m());
+	A.spmv(x.data.data(), result.data());
+	return result;
+}
+
+// x * A for CSC: one sparse dot per column
+template <typename T> dyn_vec<T> operator*(const dyn_vec<T>& x, const csc_matrix<T>& A) {
+	assert(x.size() == A.m() && "x*A size mismatch");
+	dyn_vec<T> result(A.n());
+	A.spmv_left(x.data(), result.data());
+	return result;
+}
+
+// x * A for CSR: rows scattered into the result
+template <typename T> dyn_vec<T> operator*(const dyn_vec<T>& x, const csr_matrix<T>& A) {
+	assert(x.size() == A.m() && "x*A size mismatch");
+	dyn_vec<T> result(A.n());
+	for (std::size_t i = 0; i < A.m(); ++i) {
+		for (std::size_t k = A.row_ptr()[i]; k < A.row_ptr()[i + 1]; ++k) {
+			result[A.col_idx()[k]] += x[i] * A.values()[k];
+		}
+	}
+	return result;
+}
+
+// Sparse * dense: row i of C accumulates a_ik * row k of B, so the inner
+// loop runs over contiguous rows of B and C
+template <typename T> dyn_mat<T> operator*(const csr_matrix<T>& A, const dyn_mat<T>& B) {
+	assert(A.n() == B.m() && "A*B size mismatch");
+	dyn_mat<T> result(A.m(), B.n());
+	for (std::size_t i = 0; i < A.m(); ++i) {
+		T* c = result.row_data(i);
+		for (std::size_t k = A.row_ptr()[i]; k < A.row_ptr()[i + 1]; ++k) {
+			const T aik = A.values()[k];
+			const T* b = B.row_data(A.col_idx()[k]);
+			for (std::size_t j = 0; j < B.n(); ++j) {
+				c[j] += aik * b[j];
+			}
+		}
+	}
+	return result;
+}
+
+template <typename T, std::size_t N, std::size_t P>
+dyn_mat<T> operator*(const csr_matrix<T>& A, const mat<T, N, P>& B) {
+	return A * dyn_mat<T>(B);
+}
+
+// Parallel SpMV
+template <typename T>
+dyn_vec<T> multiply(execution::sequenced_policy, const csr_matrix<T>& A, const dyn_vec<T>& x) {
+	return A * x;
+}
+
+template <typename T>
+dyn_vec<T> multiply(execution::parallel_policy policy, const csr_matrix<T>& A, const dyn_vec<T>& x) {
+	assert(A.n() == x.size() && "A*x size mismatch");
+	dyn_vec<T> result(A.m());
+	A.spmv(policy.executor(), x.data(), result.data());
+	return result;
+}
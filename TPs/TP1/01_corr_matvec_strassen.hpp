@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+
+// Strassen-Winograd product for large square matrices
+//
+// multiply_strassen(A, B) splits the operands in 2 x 2 blocks and forms the
+// product with 7 block products and 15 block additions (Winograd's variant
+// of Strassen's algorithm) instead of 8 products, recursively, down to
+// blocks of at most options.cutoff rows which go to the blocked GEMM kernel.
+// An odd size is peeled: the even leading block recurses and the last row
+// and column are finished with O(n^2) classical products.
+//
+// Each recursion level needs two half-size temporaries; the products reuse
+// the quadrants of C for the rest (schedule of Douglas, Heroux, Slishman
+// and Smith, 1994). The temporaries of all the levels are carved out of a
+// strassen_workspace, about 2/3 n^2 elements in total, which grows to the
+// largest size requested and is then reused without further allocation.
+//
+// Accuracy: the bound is normwise, not componentwise. With u the unit
+// roundoff, l recursion levels and base blocks of size n0 (n = 2^l n0), to
+// first order
+//
+//   max |C - C^| <= (18^l (n0^2 + 6 n0) - 6 n) u max |A| max |B|
+//
+// (Higham, Accuracy and Stability of Numerical Algorithms, 2nd ed., 23.2.2),
+// against n^2 u max |A| max |B| for the classical product. Every level
+// multiplies the constant by 18 / 4 = 4.5, so keep the cutoff large and use
+// the classical product where componentwise accuracy matters (operands
+// with entries of very different magnitudes). strassen_error_bound()
+// returns the factor in front of u max |A| max |B|.
+
+struct strassen_options {
+	// Blocks of at most cutoff rows use the classical kernel. Smaller
+	// blocks spend more in additions and memory traffic than the saved
+	// products bring back: on an AVX-512 core, n = 256 is about even and
+	// 4096 runs 1.4-1.7x faster with cutoffs of 256-512 (see the strassen
+	// rows of 01_corr_matvec_bench)
+	std::size_t cutoff = 256;
+};
+
+//------------------------------------------------------------------------------
+// Workspace
+//------------------------------------------------------------------------------
+
+template <typename T> class strassen_workspace {
+	public:
+	strassen_workspace() = default;
+
+	// Elements needed for an n x n product
+	static std::size_t required(std::size_t n, const strassen_options& opts) {
+		if (n <= opts.cutoff || n < 2) {
+			return 0;
+		}
+		if (n % 2 != 0) {
+			return required(n - 1, opts);
+		}
+		const std::size_t h = n / 2;
+		return 2 * h * stride(h) + required(h, opts);
+	}
+
+	// Distance between two rows of an h x h temporary
+	static std::size_t stride(std::size_t h) { return detail::pad_to(h, detail::aligned_elements<T>); }
+
+	// Grows the buffer to at least count elements (never shrinks)
+	void reserve(std::size_t count) {
+		if (buffer.size() < count) {
+			buffer = detail::aligned_buffer<T>(count);
+		}
+	}
+
+	std::size_t capacity() const { return buffer.size(); }
+	T* data() { return buffer.data(); }
+
+	private:
+	detail::aligned_buffer<T> buffer;
+};
+
+namespace detail {
+
+// z = x + y, resp. x - y, on h x h blocks
+template <typename T>
+void block_add(std::size_t h, const T* x, std::size_t ldx, const T* y, std::size_t ldy, T* z, std::size_t ldz) {
+	for (std::size_t i = 0; i < h; ++i) {
+		for (std::size_t j = 0; j < h; ++j) {
+			z[i * ldz + j] = x[i * ldx + j] + y[i * ldy + j];
+		}
+	}
+}
+
+template <typename T>
+void block_sub(std::size_t h, const T* x, std::size_t ldx, const T* y, std::size_t ldy, T* z, std::size_t ldz) {
+	for (std::size_t i = 0; i < h; ++i) {
+		for (std::size_t j = 0; j < h; ++j) {
+			z[i * ldz + j] = x[i * ldx + j] - y[i * ldy + j];
+		}
+	}
+}
+
+// C = A * B with the classical blocked kernel
+template <typename T>
+void classical_product(std::size_t m, std::size_t n, std::size_t k, const T* a, std::size_t lda,
+                       const T* b, std::size_t ldb, T* c, std::size_t ldc) {
+	for (std::size_t i = 0; i < m; ++i) {
+		std::fill_n(c + i * ldc, n, T{});
+	}
+	gemm_blocked<T, gemm_blocking<T>>(m, n, k, a, lda, 1, b, ldb, 1, c, ldc, 1);
+}
+
+// C = A * B for n x n row-major blocks, ws holding strassen_workspace::required(n)
+template <typename T>
+void strassen(std::size_t n, const T* a, std::size_t lda, const T* b, std::size_t ldb, T* c, std::size_t ldc,
+              T* ws, const strassen_options& opts) {
+	if (n <= opts.cutoff || n < 2) {
+		classical_product(n, n, n, a, lda, b, ldb, c, ldc);
+		return;
+	}
+	if (n % 2 != 0) {
+		// C11 = A11 B11 + a12 b21, then the last column and the last row
+		const std::size_t e = n - 1;
+		strassen(e, a, lda, b, ldb, c, ldc, ws, opts);
+		gemm_blocked<T, gemm_blocking<T>>(e, e, 1, a + e, lda, 1, b + e * ldb, ldb, 1, c, ldc, 1);
+		classical_product(n, 1, n, a, lda, b + e, ldb, c + e, ldc);
+		classical_product(1, e, n, a + e * lda, lda, b, ldb, c + e * ldc, ldc);
+		return;
+	}
+
+	const std::size_t h = n / 2;
+	const std::size_t ld = strassen_workspace<T>::stride(h);
+	T* x = ws;
+	T* y = ws + h * ld;
+	T* next = ws + 2 * h * ld;
+	const T* a11 = a;
+	const T* a12 = a + h;
+	const T* a21 = a + h * lda;
+	const T* a22 = a + h * lda + h;
+	const T* b11 = b;
+	const T* b12 = b + h;
+	const T* b21 = b + h * ldb;
+	const T* b22 = b + h * ldb + h;
+	T* c11 = c;
+	T* c12 = c + h;
+	T* c21 = c + h * ldc;
+	T* c22 = c + h * ldc + h;
+
+	// P7 = (A11 - A21)(B22 - B12) -> C21
+	block_sub(h, a11, lda, a21, lda, x, ld);
+	block_sub(h, b22, ldb, b12, ldb, y, ld);
+	strassen(h, x, ld, y, ld, c21, ldc, next, opts);
+	// P5 = (A21 + A22)(B12 - B11) -> C22
+	block_add(h, a21, lda, a22, lda, x, ld);
+	block_sub(h, b12, ldb, b11, ldb, y, ld);
+	strassen(h, x, ld, y, ld, c22, ldc, next, opts);
+	// P6 = (S1 - A11)(B22 - T1) -> C12
+	block_sub(h, x, ld, a11, lda, x, ld);
+	block_sub(h, b22, ldb, y, ld, y, ld);
+	strassen(h, x, ld, y, ld, c12, ldc, next, opts);
+	// P3 = (A12 - S2) B22 -> C11
+	block_sub(h, a12, lda, x, ld, x, ld);
+	strassen(h, x, ld, b22, ldb, c11, ldc, next, opts);
+	// P1 = A11 B11 -> X
+	strassen(h, a11, lda, b11, ldb, x, ld, next, opts);
+	// U2 = P1 + P6, U3 = U2 + P7, U4 = U2 + P5, U7 = U3 + P5, U5 = U4 + P3
+	block_add(h, x, ld, c12, ldc, c12, ldc);
+	block_add(h, c12, ldc, c21, ldc, c21, ldc);
+	block_add(h, c12, ldc, c22, ldc, c12, ldc);
+	block_add(h, c21, ldc, c22, ldc, c22, ldc);
+	block_add(h, c12, ldc, c11, ldc, c12, ldc);
+	// P4 = A22 (T2 - B21), U6 = U3 - P4
+	block_sub(h, y, ld, b21, ldb, y, ld);
+	strassen(h, a22, lda, y, ld, c11, ldc, next, opts);
+	block_sub(h, c21, ldc, c11, ldc, c21, ldc);
+	// P2 = A12 B21, U1 = P1 + P2
+	strassen(h, a12, lda, b21, ldb, c11, ldc, next, opts);
+	block_add(h, x, ld, c11, ldc, c11, ldc);
+}
+
+} // namespace detail
+
+// Factor g such that, to first order, max |C - C^| <= g u max |A| max |B|
+inline double strassen_error_bound(std::size_t n, const strassen_options& opts = {}) {
+	std::size_t n0 = n;
+	double levels = 0.0;
+	while (n0 > opts.cutoff && n0 >= 2) {
+		n0 = n0 / 2;
+		levels += 1.0;
+	}
+	const double base = static_cast<double>(n0);
+	return std::pow(18.0, levels) * (base * base + 6.0 * base) - 6.0 * std::exp2(levels) * base;
+}
+
+//------------------------------------------------------------------------------
+// Products
+//------------------------------------------------------------------------------
+
+// C = A * B on n x n row-major blocks; C must not alias A or B
+template <typename T>
+void multiply_strassen(std::size_t n, const T* a, std::size_t lda, const T* b, std::size_t ldb, T* c,
+                       std::size_t ldc, strassen_workspace<T>& ws, const strassen_options& opts = {}) {
+	ws.reserve(strassen_workspace<T>::required(n, opts));
+	detail::strassen(n, a, lda, b, ldb, c, ldc, ws.data(), opts);
+}
+
+template <typename T>
+dyn_mat<T> multiply_strassen(const dyn_mat<T>& A, const dyn_mat<T>& B, strassen_workspace<T>& ws,
+                             const strassen_options& opts = {}) {
+	assert(A.m() == A.n() && B.m() == B.n() && A.n() == B.m() && "multiply_strassen needs square operands");
+	dyn_mat<T> C(A.m(), B.n());
+	multiply_strassen(A.m(), A.data(), A.ld(), B.data(), B.ld(), C.data(), C.ld(), ws, opts);
+	return C;
+}
+
+template <typename T, std::size_t N>
+void multiply_strassen(const mat<T, N, N>& A, const mat<T, N, N>& B, mat<T, N, N>& C, strassen_workspace<T>& ws,
+                       const strassen_options& opts = {}) {
+	multiply_strassen(N, A.data.data(), N, B.data.data(), N, C.data.data(), N, ws, opts);
+}
+
+// Same products with a per-thread workspace kept between calls
+template <typename T>
+dyn_mat<T> multiply_strassen(const dyn_mat<T>& A, const dyn_mat<T>& B, const strassen_options& opts = {}) {
+	thread_local strassen_workspace<T> ws;
+	return multiply_strassen(A, B, ws, opts);
+}
+
+template <typename T, std::size_t N>
+void multiply_strassen(const mat<T, N, N>& A, const mat<T, N, N>& B, mat<T, N, N>& C,
+                       const strassen_options& opts = {}) {
+	thread_local strassen_workspace<T> ws;
+	multiply_strassen(A, B, C, ws, opts);
+}
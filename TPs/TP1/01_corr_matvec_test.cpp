@@ -1,6 +1,36 @@
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
 #include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+#include "01_corr_matvec_parallel.hpp"
+#include "01_corr_matvec_transpose.hpp"
+#include "01_corr_matvec_batch.hpp"
+#include "01_corr_matvec_sparse.hpp"
+#include "01_corr_matvec_quant.hpp"
+#include "01_corr_matvec_blas.hpp"
+#include "01_corr_matvec_solve.hpp"
+#include "01_corr_matvec_mmap.hpp"
+#include "01_corr_matvec_io.hpp"
+#include "01_corr_matvec_strassen.hpp"
+#include "01_corr_matvec_arena.hpp"
+#include "01_corr_matvec_fixed.hpp"
+
+// Vrai si V peut etre multiplie par un scalaire S, a droite ou a gauche
+template <typename V, typename S>
+concept scalable_by = requires(V v, S s) { v * s; } || requires(V v, S s) { s * v; };
 
 int main(int, char const *[])
 {
@@ -256,6 +286,1491 @@ int main(int, char const *[])
 		assert(C(1,1) == 154 && "A*B [1,1] mismatch");
 	}
 
+	//--------------------------------------------------------------------------
+	// 10) Tests A * B sur de grandes tailles (noyau GEMM par blocs)
+	//--------------------------------------------------------------------------
+
+	{
+		// Tailles non multiples des tuiles pour couvrir les bords
+		static mat<double, 67, 45> A;
+		static mat<double, 45, 93> B;
+		for (std::size_t i = 0; i < A.m(); ++i) {
+			for (std::size_t j = 0; j < A.n(); ++j) {
+				A(i, j) = static_cast<double>((i * 7 + j * 3) % 11) - 5.0;
+			}
+		}
+		for (std::size_t i = 0; i < B.m(); ++i) {
+			for (std::size_t j = 0; j < B.n(); ++j) {
+				B(i, j) = static_cast<double>((i * 5 + j * 2) % 13) - 6.0;
+			}
+		}
+
+		static mat<double, 67, 93> C;
+		C = A * B;
+		for (std::size_t i = 0; i < C.m(); ++i) {
+			for (std::size_t j = 0; j < C.n(); ++j) {
+				double ref = 0.0;
+				for (std::size_t k = 0; k < A.n(); ++k) {
+					ref += A(i, k) * B(k, j);
+				}
+				assert(C(i, j) == ref && "Blocked A*B mismatch");
+			}
+		}
+	}
+
+	// Le chemin constexpr doit rester disponible
+	{
+		constexpr auto C = [] {
+			mat<int, 2, 2> A;
+			A(0, 0) = 1; A(0, 1) = 2;
+			A(1, 0) = 3; A(1, 1) = 4;
+			return A * A;
+		}();
+		static_assert(C(0, 0) == 7 && C(0, 1) == 10 && C(1, 0) == 15 && C(1, 1) == 22,
+		              "constexpr A*B mismatch");
+	}
+
+	//--------------------------------------------------------------------------
+	// 11) Tests des noyaux SIMD (dot, u * alpha, A * x) avec reste non aligne
+	//--------------------------------------------------------------------------
+
+	{
+		vec<int, 37> u;
+		vec<int, 37> v;
+		int ref = 0;
+		for (std::size_t i = 0; i < u.size(); ++i) {
+			u[i] = static_cast<int>(i) - 10;
+			v[i] = static_cast<int>(i % 5) - 2;
+			ref += u[i] * v[i];
+		}
+		assert(dot(u, v) == ref && "SIMD dot mismatch");
+
+		auto w = u * 3;
+		for (std::size_t i = 0; i < w.size(); ++i) {
+			assert(w[i] == u[i] * 3 && "SIMD scaling mismatch");
+		}
+
+		mat<float, 13, 37> A;
+		vec<float, 37> x;
+		for (std::size_t j = 0; j < x.size(); ++j) {
+			x[j] = static_cast<float>(j % 4) - 1.5f;
+		}
+		for (std::size_t i = 0; i < A.m(); ++i) {
+			for (std::size_t j = 0; j < A.n(); ++j) {
+				A(i, j) = static_cast<float>((i + 2 * j) % 7) - 3.f;
+			}
+		}
+		// Entrees exactement representables : le resultat ne depend pas de
+		// l'ordre de sommation
+		[[maybe_unused]] auto y = A * x;
+		for (std::size_t i = 0; i < A.m(); ++i) {
+			assert(y[i] == dot(A.row(i), x) && "SIMD A*x mismatch");
+			float r = 0.f;
+			for (std::size_t j = 0; j < A.n(); ++j) {
+				r += A(i, j) * x[j];
+			}
+			assert(y[i] == r && "SIMD A*x mismatch");
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// 12) Tests dyn_vec / dyn_mat (taille dynamique, stockage aligne)
+	//--------------------------------------------------------------------------
+
+	{
+		dyn_mat<double> A(3, 5, 1.5);
+		assert(A.m() == 3 && A.n() == 5 && "dyn_mat dimensions");
+		assert(A.ld() % 8 == 0 && A.ld() >= A.n() && "dyn_mat leading dimension");
+		assert(reinterpret_cast<std::uintptr_t>(A.row_data(1)) % 64 == 0 && "dyn_mat row alignment");
+		assert(A(2, 4) == 1.5 && "dyn_mat fill constructor");
+
+		// Aller-retour avec les types de taille fixe
+		mat<int, 2, 3> F;
+		F(0, 0) = 1; F(0, 1) = 2; F(0, 2) = 3;
+		F(1, 0) = 4; F(1, 1) = 5; F(1, 2) = 6;
+		dyn_mat<int> D(F);
+		assert(D(1, 2) == 6 && D.row(1)[0] == 4 && D.col(2)[0] == 3 && "dyn_mat from mat");
+		[[maybe_unused]] auto F2 = static_cast<mat<int, 2, 3>>(D);
+		assert(F2(0, 1) == 2 && "dyn_mat to mat");
+
+		vec<int, 3> x;
+		x[0] = 1; x[1] = -1; x[2] = 2;
+		dyn_vec<int> dx(x);
+		auto y = D * dx;
+		assert(y.size() == 2 && y[0] == 5 && y[1] == 11 && "dyn A*x mismatch");
+		auto z = dyn_vec<int>(2, 1) * D;
+		assert(z.size() == 3 && z[0] == 5 && z[1] == 7 && z[2] == 9 && "dyn x*A mismatch");
+		assert(dot(dx, dx) == 6 && "dyn dot mismatch");
+		assert((dx * 2)[2] == 4 && (2 * dx)[1] == -2 && "dyn scaling mismatch");
+		auto uv = dyn_vec<int>(2, 2) * dx;
+		assert(uv.m() == 2 && uv.n() == 3 && uv(1, 2) == 4 && "dyn dyadic mismatch");
+		[[maybe_unused]] auto back = static_cast<vec<int, 3>>(dx);
+		assert(back[1] == -1 && "dyn_vec to vec");
+
+		// Produit par blocs sur tailles non multiples des tuiles
+		dyn_mat<float> P(70, 41), Q(41, 53);
+		for (std::size_t i = 0; i < P.m(); ++i) {
+			for (std::size_t j = 0; j < P.n(); ++j) {
+				P(i, j) = static_cast<float>((i + j) % 5) - 2.f;
+			}
+		}
+		for (std::size_t i = 0; i < Q.m(); ++i) {
+			for (std::size_t j = 0; j < Q.n(); ++j) {
+				Q(i, j) = static_cast<float>((2 * i + j) % 7) - 3.f;
+			}
+		}
+		auto R = P * Q;
+		for (std::size_t i = 0; i < R.m(); ++i) {
+			for (std::size_t j = 0; j < R.n(); ++j) {
+				float ref = 0.f;
+				for (std::size_t k = 0; k < P.n(); ++k) {
+					ref += P(i, k) * Q(k, j);
+				}
+				assert(R(i, j) == ref && "dyn A*B mismatch");
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// 13) Tests des vues row_view / col_view / block_view
+	//--------------------------------------------------------------------------
+
+	{
+		mat<int, 3, 3> A;
+		// A = [ [1, 2, 3],
+		//       [4, 5, 6],
+		//       [7, 8, 9] ]
+		for (std::size_t i = 0; i < 3; ++i) {
+			for (std::size_t j = 0; j < 3; ++j) {
+				A(i, j) = static_cast<int>(3 * i + j + 1);
+			}
+		}
+
+		// Les vues ecrivent dans la matrice parente
+		A.row(0) *= 2;
+		assert(A(0, 0) == 2 && A(0, 2) == 6 && "row_view write-through");
+		A.col(1) = A.col(0);
+		assert(A(0, 1) == 2 && A(1, 1) == 4 && A(2, 1) == 7 && "col_view assignment");
+
+		// dot, scaling et produit matrice/vecteur sans copie
+		assert(dot(A.row(1), A.col(2)) == 4 * 6 + 4 * 6 + 6 * 9 && "dot on views");
+		[[maybe_unused]] vec<int, 3> c2 = A.col(2) * 2;
+		assert(c2[0] == 12 && c2[1] == 12 && c2[2] == 18 && "scaling a view");
+		[[maybe_unused]] auto y = A * A.col(0);
+		assert(y[0] == 2 * 2 + 2 * 4 + 6 * 7 && y[2] == 7 * 2 + 7 * 4 + 9 * 7 && "A * col_view");
+
+		// Sous-matrice 2x2 en bas a droite
+		auto B = A.block<2, 2>(1, 1);
+		assert(B(0, 0) == 4 && B(1, 1) == 9 && "block_view access");
+		B(0, 1) = 0;
+		assert(A(1, 2) == 0 && "block_view write-through");
+		vec<int, 2> x(1);
+		[[maybe_unused]] auto z = B * x;
+		assert(z[0] == 4 && z[1] == 16 && "block_view * x");
+
+		// Les vues restent utilisables en constexpr
+		constexpr auto r = [] {
+			mat<int, 2, 2> C;
+			C(1, 0) = 3; C(1, 1) = 4;
+			return dot(C.row(1), C.row(1));
+		}();
+		static_assert(r == 25, "constexpr row_view");
+	}
+
+	//--------------------------------------------------------------------------
+	// 14) Tests multiply(par, ...) : resultat identique au sequentiel
+	//--------------------------------------------------------------------------
+
+	{
+		thread_pool pool(4);
+		auto par = execution::par.on(pool);
+
+		dyn_mat<double> A(301, 157), B(157, 290);
+		for (std::size_t i = 0; i < A.m(); ++i) {
+			for (std::size_t j = 0; j < A.n(); ++j) {
+				A(i, j) = 1.0 / static_cast<double>(i + 2 * j + 1);
+			}
+		}
+		for (std::size_t i = 0; i < B.m(); ++i) {
+			for (std::size_t j = 0; j < B.n(); ++j) {
+				B(i, j) = 1.0 / static_cast<double>(3 * i + j + 1);
+			}
+		}
+
+		auto C = A * B;
+		auto Cp = multiply(par, A, B);
+		for (std::size_t i = 0; i < C.m(); ++i) {
+			for (std::size_t j = 0; j < C.n(); ++j) {
+				assert(C(i, j) == Cp(i, j) && "parallel A*B mismatch");
+			}
+		}
+
+		dyn_mat<double> L(1000, 157, 0.5);
+		auto x = A.row(7);
+		auto y = L * x;
+		auto yp = multiply(par, L, x);
+		for (std::size_t i = 0; i < y.size(); ++i) {
+			assert(y[i] == yp[i] && "parallel A*x mismatch");
+		}
+
+		static mat<float, 64, 96> F(0.25f);
+		static mat<float, 96, 80> G(2.f);
+		[[maybe_unused]] auto H = multiply(par, F, G);
+		assert(H(63, 79) == 48.f && multiply(execution::seq, F, G)(0, 0) == 48.f && "parallel mat*mat");
+
+		// Les exceptions des taches remontent a l'appelant
+		[[maybe_unused]] bool thrown = false;
+		try {
+			pool.parallel_for(16, [](std::size_t i) {
+				if (i == 5) {
+					throw 5;
+				}
+			});
+		} catch (int) {
+			thrown = true;
+		}
+		assert(thrown && "parallel_for should rethrow task exceptions");
+	}
+
+	//--------------------------------------------------------------------------
+	// 15) Tests des expressions paresseuses (+, -, scaling, fma)
+	//--------------------------------------------------------------------------
+
+	{
+		vec<double, 3> x, y;
+		x[0] = 1.0; x[1] = 2.0; x[2] = 3.0;
+		y[0] = 4.0; y[1] = 5.0; y[2] = 6.0;
+
+		// Rien n'est calcule avant l'affectation : une seule boucle fusionnee
+		[[maybe_unused]] vec<double, 3> r = x * 2.0 + y - x;
+		assert(r[0] == 5.0 && r[1] == 7.0 && r[2] == 9.0 && "x*2 + y - x mismatch");
+
+		// AXPY en place, l'aliasing element par element est sans danger
+		y += 0.5 * x;
+		assert(y[0] == 4.5 && y[2] == 7.5 && "y += a*x mismatch");
+		y = fma(x, x, y);
+		assert(y[1] == 10.0 && "fma(x, x, y) mismatch");
+
+		// Un temporaire capture par une expression est conserve par valeur
+		mat<double, 2, 3> A(1.0);
+		auto e = A * x * 2.0;
+		static_assert(!std::is_same_v<decltype(e), vec<double, 2>>, "scaling should be lazy");
+		[[maybe_unused]] vec<double, 2> z = e;
+		assert(z[0] == 12.0 && z[1] == 12.0 && "A*x*2 mismatch");
+
+		// Memes operations sur les matrices et les vues
+		mat<double, 2, 3> B = A + A * 3.0;
+		assert(B(1, 2) == 4.0 && "A + A*3 mismatch");
+		B -= A;
+		assert(B(0, 0) == 3.0 && "B -= A mismatch");
+		assert((A + A)(1, 1) == 2.0 && "lazy mat access");
+		B.row(0) = B.row(1) + A.row(0);
+		assert(B(0, 1) == 4.0 && "row expression assignment");
+		assert((A * (x + x))[1] == 12.0 && "A * lazy x");
+
+		constexpr auto c = [] {
+			vec<int, 2> u(3);
+			vec<int, 2> v = u * 2 - u + fma(u, u, 1);
+			return v[0];
+		}();
+		static_assert(c == 13, "constexpr expression");
+
+		// Le scalaire doit avoir le type des elements : vec<int, 4> * 0.5
+		// ne compile pas au lieu de tronquer 0.5 a 0
+		static_assert(scalable_by<vec<int, 4>, int> && scalable_by<mat<double, 2, 3>, double>, "scaling");
+		static_assert(!scalable_by<vec<int, 4>, double> && !scalable_by<vec<double, 3>, float>
+		              && !scalable_by<decltype(x + y), int> && !scalable_by<mat<float, 2, 2>, double>,
+		              "scalar of another type");
+	}
+
+	//--------------------------------------------------------------------------
+	// 16) Tests des layouts (row_major / col_major) et de transpose()
+	//--------------------------------------------------------------------------
+
+	{
+		// Meme matrice 2x3 dans les deux layouts
+		mat<int, 2, 3> R;
+		mat<int, 2, 3, col_major> C;
+		for (std::size_t i = 0; i < 2; ++i) {
+			for (std::size_t j = 0; j < 3; ++j) {
+				R(i, j) = static_cast<int>(3 * i + j + 1);
+				C(i, j) = R(i, j);
+			}
+		}
+		// En column-major, les colonnes sont contigues
+		assert(C.data[0] == 1 && C.data[1] == 4 && C.data[2] == 2 && "col_major storage");
+		assert(C.col(1)[1] == 5 && C.row(1)[2] == 6 && "col_major row/col views");
+
+		vec<int, 3> x;
+		x[0] = 1; x[1] = 0; x[2] = -1;
+		vec<int, 2> w;
+		w[0] = 2; w[1] = 1;
+		[[maybe_unused]] auto yr = R * x;
+		[[maybe_unused]] auto yc = C * x;
+		assert(yr[0] == -2 && yr[1] == -2 && yc[0] == yr[0] && yc[1] == yr[1] && "A*x on both layouts");
+		[[maybe_unused]] auto zr = w * R;
+		[[maybe_unused]] auto zc = w * C;
+		assert(zr[0] == 6 && zr[2] == 12 && zc[0] == zr[0] && zc[2] == zr[2] && "x*A on both layouts");
+
+		// transpose() est une vue : aucune copie, ecriture dans le parent
+		auto Rt = R.transpose();
+		static_assert(decltype(Rt)::m() == 3 && decltype(Rt)::n() == 2, "transpose shape");
+		assert(Rt(2, 1) == R(1, 2) && "transpose access");
+		R.transpose()(0, 1) = 40;
+		assert(R(1, 0) == 40 && "transpose write-through");
+		R(1, 0) = 4;
+
+		[[maybe_unused]] auto yt = Rt * w;
+		assert(yt[0] == zr[0] && yt[2] == zr[2] && "A^T * x == x * A");
+
+		// A^T * B, avec un melange de layouts, petit et grand format
+		auto RtC = R.transpose() * C;
+		static_assert(decltype(RtC)::m() == 3 && decltype(RtC)::n() == 3, "A^T*B shape");
+		assert(RtC(0, 0) == 17 && RtC(2, 1) == 3 * 2 + 6 * 5 && "A^T*B mismatch");
+
+		static mat<double, 45, 70> G;
+		static mat<double, 45, 60, col_major> H;
+		for (std::size_t i = 0; i < 45; ++i) {
+			for (std::size_t j = 0; j < 70; ++j) {
+				G(i, j) = static_cast<double>((i + 3 * j) % 9) - 4.0;
+			}
+			for (std::size_t j = 0; j < 60; ++j) {
+				H(i, j) = static_cast<double>((2 * i + j) % 5) - 2.0;
+			}
+		}
+		// G^T et H sont tous deux column-major : le produit aussi
+		static mat<double, 70, 60, col_major> GtH;
+		GtH = G.transpose() * H;
+		for (std::size_t i = 0; i < 70; ++i) {
+			for (std::size_t j = 0; j < 60; ++j) {
+				double ref = 0.0;
+				for (std::size_t k = 0; k < 45; ++k) {
+					ref += G(k, i) * H(k, j);
+				}
+				assert(GtH(i, j) == ref && "blocked A^T*B mismatch");
+			}
+		}
+
+		// Conversion explicite entre layouts, depuis une vue transposee
+		mat<int, 3, 2, col_major> D(R.transpose());
+		mat<int, 2, 3> R2(C);
+		assert(D(2, 1) == 6 && R2(1, 0) == 4 && "layout conversion");
+		auto CD = C * D;
+		static_assert(std::is_same_v<decltype(CD), mat<int, 2, 2, col_major>>, "col_major product layout");
+		auto RR = R * R.transpose();
+		static_assert(std::is_same_v<decltype(RR), mat<int, 2, 2>>, "row_major product layout");
+		assert(CD(0, 1) == 1 * 4 + 2 * 5 + 3 * 6 && RR(0, 1) == CD(0, 1) && "A*A^T mismatch");
+
+		// Acces (i, j) d'une expression column-major : indice dans l'ordre de stockage
+		mat<int, 2, 3, col_major> Z{};
+		[[maybe_unused]] auto CZ = C + Z;
+		[[maybe_unused]] auto RZ = R + mat<int, 2, 3>{};
+		for (std::size_t i = 0; i < 2; ++i) {
+			for (std::size_t j = 0; j < 3; ++j) {
+				assert(CZ(i, j) == C(i, j) && RZ(i, j) == R(i, j) && "(A + B)(i, j) on both layouts");
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// 17) Tests de transposed() / transpose_in_place() (recursif, tuiles SIMD)
+	//--------------------------------------------------------------------------
+
+	{
+		// Tailles non multiples des tuiles et au-dessus de la feuille de recursion
+		static mat<float, 131, 77> A;
+		for (std::size_t i = 0; i < A.m(); ++i) {
+			for (std::size_t j = 0; j < A.n(); ++j) {
+				A(i, j) = static_cast<float>(i * 1000 + j);
+			}
+		}
+		static mat<float, 77, 131> At;
+		At = transposed(A);
+		for (std::size_t i = 0; i < A.m(); ++i) {
+			for (std::size_t j = 0; j < A.n(); ++j) {
+				assert(At(j, i) == A(i, j) && "transposed mismatch");
+			}
+		}
+
+		static mat<double, 150, 150, col_major> S;
+		for (std::size_t i = 0; i < S.m(); ++i) {
+			for (std::size_t j = 0; j < S.n(); ++j) {
+				S(i, j) = static_cast<double>(i * 1000 + j);
+			}
+		}
+		transpose_in_place(S);
+		for (std::size_t i = 0; i < S.m(); ++i) {
+			for (std::size_t j = 0; j < S.n(); ++j) {
+				assert(S(i, j) == static_cast<double>(j * 1000 + i) && "transpose_in_place mismatch");
+			}
+		}
+
+		dyn_mat<int> D(70, 133);
+		for (std::size_t i = 0; i < D.m(); ++i) {
+			for (std::size_t j = 0; j < D.n(); ++j) {
+				D(i, j) = static_cast<int>(i * 1000 + j);
+			}
+		}
+		transpose_in_place(D);
+		assert(D.m() == 133 && D.n() == 70 && D(132, 69) == 69132 && D(5, 3) == 3005 && "dyn transpose");
+
+		constexpr auto c = [] {
+			mat<int, 3, 3> C;
+			C(0, 2) = 7;
+			transpose_in_place(C);
+			return transposed(C)(0, 2) + C(2, 0);
+		}();
+		static_assert(c == 14, "constexpr transpose");
+	}
+
+	//--------------------------------------------------------------------------
+	// 18) Tests des operations par lots (mat_batch / vec_batch, stockage SoA)
+	//--------------------------------------------------------------------------
+
+	{
+		// Nombre de matrices non multiple de la largeur SIMD
+		constexpr std::size_t count = 37;
+		std::vector<mat<float, 4, 4>> ms(count);
+		std::vector<mat<float, 4, 4>> ns(count);
+		std::vector<vec<float, 4>> vs(count);
+		for (std::size_t b = 0; b < count; ++b) {
+			for (std::size_t i = 0; i < 4; ++i) {
+				// Diagonale dominante : matrices bien inversibles
+				for (std::size_t j = 0; j < 4; ++j) {
+					ms[b](i, j) = static_cast<float>((b + 3 * i + 5 * j) % 7) + (i == j ? 10.f : 0.f);
+					ns[b](i, j) = static_cast<float>((2 * b + i + j) % 5);
+				}
+				vs[b][i] = static_cast<float>(b % 4 + i);
+			}
+		}
+
+		mat_batch<float, 4, 4> A(ms);
+		mat_batch<float, 4, 4> B(ns);
+		vec_batch<float, 4> x(vs);
+		assert(A.size() == count && A.get(5).data == ms[5].data && x.get(36).data == vs[36].data && "pack / get");
+
+		auto y = A * x;
+		auto C = A * B;
+		for (std::size_t b = 0; b < count; ++b) {
+			assert(y.get(b).data == (ms[b] * vs[b]).data && "batched mat-vec");
+			assert(C.get(b).data == (ms[b] * ns[b]).data && "batched mat-mat");
+		}
+
+		// A * A^-1 ~ I
+		auto Ai = inverse(A);
+		std::vector<mat<float, 4, 4>> is(count);
+		Ai.unpack(is);
+		for (std::size_t b = 0; b < count; ++b) {
+			auto I = ms[b] * is[b];
+			for (std::size_t i = 0; i < 4; ++i) {
+				for (std::size_t j = 0; j < 4; ++j) {
+					[[maybe_unused]] float e = I(i, j) - (i == j ? 1.f : 0.f);
+					assert(e < 1e-5f && e > -1e-5f && "batched inverse 4x4");
+				}
+			}
+		}
+
+		// 2x2 et 3x3 en double, et mat-vec non carre
+		mat_batch<double, 3, 3> D(3);
+		mat_batch<double, 2, 2> E(3);
+		for (std::size_t b = 0; b < 3; ++b) {
+			for (std::size_t i = 0; i < 3; ++i) {
+				for (std::size_t j = 0; j < 3; ++j) {
+					D(b, i, j) = static_cast<double>(i == j ? 4 + b : (i + j + b) % 3);
+				}
+			}
+			E.set(b, mat<double, 2, 2>{});
+			E(b, 0, 0) = 2.0;
+			E(b, 0, 1) = 1.0;
+			E(b, 1, 0) = static_cast<double>(b);
+			E(b, 1, 1) = 3.0;
+		}
+		auto DDi = D * inverse(D);
+		auto EEi = E * inverse(E);
+		for (std::size_t b = 0; b < 3; ++b) {
+			for (std::size_t i = 0; i < 3; ++i) {
+				for (std::size_t j = 0; j < 3; ++j) {
+					[[maybe_unused]] double e = DDi(b, i, j) - (i == j ? 1.0 : 0.0);
+					assert(e < 1e-12 && e > -1e-12 && "batched inverse 3x3");
+					if (i < 2 && j < 2) {
+						e = EEi(b, i, j) - (i == j ? 1.0 : 0.0);
+						assert(e < 1e-12 && e > -1e-12 && "batched inverse 2x2");
+					}
+				}
+			}
+		}
+
+		mat_batch<int, 2, 3> F(20);
+		vec_batch<int, 3> z(20);
+		for (std::size_t b = 0; b < 20; ++b) {
+			F.set(b, mat<int, 2, 3>{});
+			F(b, 0, 0) = 1;
+			F(b, 1, 2) = static_cast<int>(b);
+			z.set(b, vec<int, 3>{});
+			z(b, 0) = 2;
+			z(b, 2) = 3;
+		}
+		auto w = F * z;
+		assert(w(19, 0) == 2 && w(19, 1) == 57 && w(0, 1) == 0 && "batched int mat-vec");
+	}
+
+	//--------------------------------------------------------------------------
+	// 19) Tests des matrices creuses (COO -> CSR / CSC / BSR)
+	//--------------------------------------------------------------------------
+
+	{
+		// Matrice 12 x 8 avec un doublon, comparee a sa version dense
+		coo_matrix<double> coo(12, 8);
+		for (std::size_t i = 0; i < 12; ++i) {
+			coo.add(i, (3 * i) % 8, static_cast<double>(i + 1));
+			coo.add(i, (5 * i + 1) % 8, 0.5);
+		}
+		coo.add(4, 6, 2.0);
+		coo.add(4, 6, 1.0);
+
+		csr_matrix<double> A(coo);
+		csc_matrix<double> Ac(coo);
+		bsr_matrix<double, 4> Ab(coo);
+		dyn_mat<double> D = A.to_dense();
+		assert(A(4, 6) == 3.0 && A(0, 2) == 0.0 && Ac(4, 6) == 3.0 && Ab(4, 6) == 3.0 && "duplicates summed");
+		assert(A.nnz() == Ac.nnz() && A.nnz() < 12 * 8 && "nnz");
+
+		vec<double, 8> x;
+		dyn_vec<double> u(12);
+		for (std::size_t j = 0; j < 8; ++j) {
+			x[j] = static_cast<double>(j) - 2.5;
+		}
+		for (std::size_t i = 0; i < 12; ++i) {
+			u[i] = static_cast<double>(i % 5);
+		}
+		dyn_vec<double> dx(x);
+		dyn_vec<double> ref = D * dx;
+		dyn_vec<double> y = A * x;
+		dyn_vec<double> yc = Ac * dx;
+		dyn_vec<double> yb = Ab * x;
+		for (std::size_t i = 0; i < 12; ++i) {
+			assert(y[i] == ref[i] && yc[i] == ref[i] && yb[i] == ref[i] && "sparse A*x");
+		}
+
+		dyn_vec<double> left = u * D;
+		dyn_vec<double> l1 = u * A;
+		dyn_vec<double> l2 = u * Ac;
+		for (std::size_t j = 0; j < 8; ++j) {
+			assert(l1[j] == left[j] && l2[j] == left[j] && "sparse x*A");
+		}
+
+		mat<double, 8, 3> B;
+		for (std::size_t k = 0; k < 8; ++k) {
+			for (std::size_t j = 0; j < 3; ++j) {
+				B(k, j) = static_cast<double>(k + 2 * j);
+			}
+		}
+		dyn_mat<double> C = A * B;
+		dyn_mat<double> Cref = D * dyn_mat<double>(B);
+		for (std::size_t i = 0; i < 12; ++i) {
+			for (std::size_t j = 0; j < 3; ++j) {
+				assert(C(i, j) == Cref(i, j) && "sparse * dense");
+			}
+		}
+
+		// SpMV parallele sur assez de non-zeros pour plusieurs taches
+		constexpr std::size_t n = 20000;
+		coo_matrix<float> big(n, n);
+		for (std::size_t i = 0; i < n; ++i) {
+			for (std::size_t k = 0; k < 5; ++k) {
+				big.add(i, (i * 7 + k * 1013) % n, static_cast<float>(k + 1));
+			}
+		}
+		csr_matrix<float> S(big);
+		dyn_vec<float> v(n);
+		for (std::size_t j = 0; j < n; ++j) {
+			v[j] = static_cast<float>(j % 13) * 0.25f;
+		}
+		thread_pool pool(3);
+		dyn_vec<float> s1 = multiply(execution::seq, S, v);
+		dyn_vec<float> s2 = multiply(execution::par.on(pool), S, v);
+		for (std::size_t i = 0; i < n; ++i) {
+			assert(s1[i] == s2[i] && "parallel SpMV");
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// 20) Tests des accumulateurs elargis et du produit quantifie int8
+	//--------------------------------------------------------------------------
+
+	{
+		// int8 : 200 * 127 * 127 deborde un int8 et un int16, pas un int32
+		static_assert(std::is_same_v<accumulator_t<std::int8_t>, std::int32_t>, "int8 -> int32");
+		static_assert(std::is_same_v<accumulator_t<float>, float>, "float -> float");
+		vec<std::int8_t, 200> a;
+		vec<std::int8_t, 200> b;
+		vec<std::uint8_t, 77> c;
+		vec<std::int16_t, 45> d;
+		std::int32_t ab = 0;
+		std::int32_t cc = 0;
+		std::int32_t dd = 0;
+		for (std::size_t i = 0; i < 200; ++i) {
+			a[i] = static_cast<std::int8_t>(i % 2 ? 127 : -128);
+			b[i] = static_cast<std::int8_t>(i % 2 ? 127 : -128);
+			ab += std::int32_t{a[i]} * std::int32_t{b[i]};
+		}
+		for (std::size_t i = 0; i < 77; ++i) {
+			c[i] = static_cast<std::uint8_t>(255 - i);
+			cc += std::int32_t{c[i]} * std::int32_t{c[i]};
+		}
+		for (std::size_t i = 0; i < 45; ++i) {
+			d[i] = static_cast<std::int16_t>(i * 200 - 4000);
+			dd += std::int32_t{d[i]} * std::int32_t{d[i]};
+		}
+		assert(dot(a, b) == ab && dot(c, c) == cc && dot(d, d) == dd && "widened dot");
+		assert(dot<std::int64_t>(a, b) == ab && "explicit accumulator");
+
+		constexpr auto uu = [] {
+			vec<std::int8_t, 3> u;
+			u[0] = u[1] = u[2] = 100;
+			return dot(u, u);
+		}();
+		static_assert(uu == 30000, "constexpr widened dot");
+
+		// float : sommes compensees par blocs sur un long vecteur
+		constexpr std::size_t n = 1 << 20;
+		static vec<float, n> ones;
+		static vec<float, n> small;
+		for (std::size_t i = 0; i < n; ++i) {
+			ones[i] = 1.f;
+			small[i] = i == 0 ? 1e8f : 1.f;
+		}
+		assert(dot(ones, ones) == static_cast<float>(n) && "long float dot");
+		assert(dot<double>(ones, small) == 1e8 + (n - 1) && "float dot in double");
+
+		// multiply<Acc> : produits sans debordement
+		mat<std::int8_t, 3, 70> A;
+		vec<std::int8_t, 70> x;
+		for (std::size_t j = 0; j < 70; ++j) {
+			x[j] = 100;
+			for (std::size_t i = 0; i < 3; ++i) {
+				A(i, j) = static_cast<std::int8_t>(i == 1 ? -100 : 100);
+			}
+		}
+		auto y = multiply(A, x);
+		static_assert(std::is_same_v<decltype(y), vec<std::int32_t, 3>>, "widened mat-vec type");
+		assert(y[0] == 700000 && y[1] == -700000 && "widened mat-vec");
+		vec<std::int8_t, 3> w;
+		w[0] = w[1] = w[2] = 1;
+		[[maybe_unused]] auto z = multiply(w, A);
+		assert(z[5] == 100 && "widened vec-mat");
+		[[maybe_unused]] auto AAt = multiply(A, A.transpose());
+		assert(AAt(0, 0) == 700000 && AAt(0, 1) == -700000 && "widened mat-mat");
+
+		// Les deux layouts, contre le calcul direct en int32
+		mat<std::int8_t, 3, 70, col_major> Ac(A);
+		mat<std::int8_t, 70, 5> B;
+		for (std::size_t i = 0; i < 70; ++i) {
+			for (std::size_t j = 0; j < 5; ++j) {
+				B(i, j) = static_cast<std::int8_t>(static_cast<int>((i * 5 + j) % 255) - 127);
+			}
+		}
+		[[maybe_unused]] auto zc = multiply(w, Ac);
+		[[maybe_unused]] auto AB = multiply(A, B);
+		[[maybe_unused]] auto AcB = multiply(Ac, B);
+		for (std::size_t j = 0; j < 70; ++j) {
+			assert(zc[j] == z[j] && "widened vec-mat, col_major");
+		}
+		for (std::size_t i = 0; i < 3; ++i) {
+			for (std::size_t j = 0; j < 5; ++j) {
+				std::int32_t ref = 0;
+				for (std::size_t k = 0; k < 70; ++k) {
+					ref += std::int32_t{A(i, k)} * std::int32_t{B(k, j)};
+				}
+				assert(AB(i, j) == ref && AcB(i, j) == ref && "widened mat-mat, both layouts");
+			}
+		}
+		vec<std::int8_t, 70> xv;
+		for (std::size_t j = 0; j < 70; ++j) {
+			xv[j] = static_cast<std::int8_t>(static_cast<int>((j * 37) % 255) - 127);
+		}
+		[[maybe_unused]] auto yv = multiply(A, xv);
+		[[maybe_unused]] auto ycv = multiply(Ac, xv);
+		for (std::size_t i = 0; i < 3; ++i) {
+			[[maybe_unused]] std::int32_t ref = 0;
+			for (std::size_t k = 0; k < 70; ++k) {
+				ref += std::int32_t{A(i, k)} * std::int32_t{xv[k]};
+			}
+			assert(yv[i] == ref && ycv[i] == ref && "widened mat-vec, both layouts");
+		}
+
+		// Produit quantifie int8 : proche du produit float
+		static mat<float, 64, 96> F;
+		vec<float, 96> v;
+		for (std::size_t j = 0; j < 96; ++j) {
+			v[j] = static_cast<float>(j % 9) * 0.3f - 1.f;
+			for (std::size_t i = 0; i < 64; ++i) {
+				F(i, j) = static_cast<float>((i * 7 + j * 3) % 19) * 0.1f - 0.9f;
+			}
+		}
+		auto Fq = quantize(F);
+		vec<float, 64> exact = F * v;
+		vec<float, 64> approx = Fq * v;
+		for (std::size_t i = 0; i < 64; ++i) {
+			[[maybe_unused]] float e = approx[i] - exact[i];
+			assert(e < 0.1f && e > -0.1f && "quantized mat-vec");
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// 21) Tests des mises a jour fusionnees (axpy, gemv, gemm, ger)
+	//--------------------------------------------------------------------------
+
+	{
+		vec<double, 37> x;
+		vec<double, 37> y;
+		for (std::size_t i = 0; i < 37; ++i) {
+			x[i] = static_cast<double>(i);
+			y[i] = 1.0;
+		}
+		axpy(2.0, x, y);
+		assert(y[0] == 1.0 && y[36] == 73.0 && "axpy");
+
+		// y = alpha * A * x + beta * y, dans les deux layouts
+		mat<double, 5, 37> A;
+		mat<double, 5, 37, col_major> Ac;
+		for (std::size_t i = 0; i < 5; ++i) {
+			for (std::size_t j = 0; j < 37; ++j) {
+				A(i, j) = static_cast<double>((i + j) % 4);
+				Ac(i, j) = A(i, j);
+			}
+		}
+		vec<double, 5> z;
+		vec<double, 5> zc;
+		for (std::size_t i = 0; i < 5; ++i) {
+			z[i] = zc[i] = static_cast<double>(i);
+		}
+		[[maybe_unused]] vec<double, 5> Ax = A * x;
+		gemv(0.5, A, x, 3.0, z);
+		gemv(0.5, Ac, x, 3.0, zc);
+		for (std::size_t i = 0; i < 5; ++i) {
+			assert(z[i] == 0.5 * Ax[i] + 3.0 * static_cast<double>(i) && zc[i] == z[i] && "gemv alpha/beta");
+		}
+
+		// beta = 0 : la sortie n'est pas lue (NaN ignore)
+		vec<double, 5> nan;
+		for (std::size_t i = 0; i < 5; ++i) {
+			nan[i] = 0.0 / 0.0;
+		}
+		gemv(1.0, A, x, 0.0, nan);
+		assert(nan[4] == Ax[4] && "gemv beta = 0");
+
+		// C = alpha * A * B + beta * C, petit et grand (noyau par blocs)
+		static mat<float, 70, 90> G;
+		static mat<float, 90, 50, col_major> H;
+		static mat<float, 70, 50> K;
+		for (std::size_t i = 0; i < 90; ++i) {
+			for (std::size_t j = 0; j < 70; ++j) {
+				G(j, i) = static_cast<float>((i * 3 + j) % 5);
+			}
+			for (std::size_t j = 0; j < 50; ++j) {
+				H(i, j) = static_cast<float>((i + 2 * j) % 3);
+			}
+		}
+		for (std::size_t i = 0; i < 70; ++i) {
+			for (std::size_t j = 0; j < 50; ++j) {
+				K(i, j) = 1.f;
+			}
+		}
+		[[maybe_unused]] auto GH = G * H;
+		gemm(2.f, G, H, -1.f, K);
+		for (std::size_t i = 0; i < 70; ++i) {
+			for (std::size_t j = 0; j < 50; ++j) {
+				assert(K(i, j) == 2.f * GH(i, j) - 1.f && "gemm alpha/beta");
+			}
+		}
+
+		mat<int, 2, 3> S;
+		mat<int, 3, 2> T;
+		mat<int, 2, 2> U;
+		for (std::size_t k = 0; k < 6; ++k) {
+			S.data[k] = static_cast<int>(k);
+			T.data[k] = static_cast<int>(k + 1);
+		}
+		U(0, 0) = 10;
+		gemm(1, S, T, 2, U);
+		[[maybe_unused]] auto ST = S * T;
+		assert(U(0, 0) == ST(0, 0) + 20 && U(1, 1) == ST(1, 1) && "small gemm");
+
+		dyn_mat<double> D(40, 33, 1.0);
+		dyn_mat<double> E(33, 41, 0.5);
+		dyn_mat<double> F(40, 41, 2.0);
+		gemm(1.0, D, E, 0.5, F);
+		assert(F(39, 40) == 16.5 + 1.0 && F(0, 0) == 17.5 && "dyn gemm");
+		dyn_vec<double> dv(33, 2.0);
+		dyn_vec<double> dw(40, 1.0);
+		gemv(1.0, D, dv, 1.0, dw);
+		assert(dw[7] == 67.0 && "dyn gemv");
+
+		// A += alpha * u * v^T sans matrice temporaire
+		mat<double, 5, 37> R = A;
+		mat<double, 5, 37, col_major> Rc = Ac;
+		vec<double, 5> u;
+		for (std::size_t i = 0; i < 5; ++i) {
+			u[i] = static_cast<double>(i) - 1.0;
+		}
+		ger(3.0, u, x, R);
+		ger(3.0, u, x, Rc);
+		for (std::size_t i = 0; i < 5; ++i) {
+			for (std::size_t j = 0; j < 37; ++j) {
+				assert(R(i, j) == A(i, j) + 3.0 * u[i] * x[j] && Rc(i, j) == R(i, j) && "ger");
+			}
+		}
+		dyn_vec<double> du(40, 1.0);
+		ger(2.0, du, dv, D);
+		assert(D(5, 5) == 5.0 && "dyn ger");
+	}
+
+	//--------------------------------------------------------------------------
+	// 22) Tests des solveurs (LU, Cholesky, QR, formes closes)
+	//--------------------------------------------------------------------------
+
+	{
+		// Petites tailles : inverse et determinant par cofacteurs
+		mat<double, 3, 3> A3;
+		A3(0, 0) = 4.0; A3(0, 1) = 1.0; A3(0, 2) = 2.0;
+		A3(1, 0) = 1.0; A3(1, 1) = 5.0; A3(1, 2) = 3.0;
+		A3(2, 0) = 2.0; A3(2, 1) = 3.0; A3(2, 2) = 6.0;
+		vec<double, 3> b3;
+		b3[0] = 1.0; b3[1] = -2.0; b3[2] = 3.0;
+		vec<double, 3> x3 = solve(A3, b3);
+		[[maybe_unused]] vec<double, 3> r3 = A3 * x3;
+		for (std::size_t i = 0; i < 3; ++i) {
+			assert(std::abs(r3[i] - b3[i]) < 1e-12 && "solve 3x3");
+		}
+		assert(std::abs(determinant(A3) - 70.0) < 1e-12 && "determinant 3x3");
+		assert(std::abs(lu(A3).determinant() - 70.0) < 1e-12 && "determinant LU");
+		mat<double, 4, 4> A4;
+		for (std::size_t i = 0; i < 4; ++i) {
+			for (std::size_t j = 0; j < 4; ++j) {
+				A4(i, j) = static_cast<double>((i * 5 + j * 3) % 7) + (i == j ? 4.0 : 0.0);
+			}
+		}
+		assert(std::abs(determinant(A4) - lu(A4).determinant()) < 1e-9 && "determinant 4x4");
+		[[maybe_unused]] auto P4 = A4 * inverse(A4);
+		for (std::size_t i = 0; i < 4; ++i) {
+			for (std::size_t j = 0; j < 4; ++j) {
+				assert(std::abs(P4(i, j) - (i == j ? 1.0 : 0.0)) < 1e-12 && "inverse 4x4");
+			}
+		}
+
+		// Grandes tailles : plusieurs panneaux de factor_block colonnes
+		const std::size_t n = 150;
+		auto noise = [](std::uint64_t k) {
+			k *= 0x9E3779B97F4A7C15u;
+			k ^= k >> 29;
+			return static_cast<double>(k % 1000) / 500.0 - 1.0;
+		};
+		dyn_mat<double> A(n, n);
+		dyn_mat<double> S(n, n);
+		for (std::size_t i = 0; i < n; ++i) {
+			for (std::size_t j = 0; j < n; ++j) {
+				A(i, j) = i == j ? 0.0 : noise(i * n + j);
+				S(i, j) = 1.0 / static_cast<double>(1 + i + j) + (i == j ? 1.0 : 0.0);
+			}
+		}
+		dyn_vec<double> b(n);
+		dyn_mat<double> B(n, 9);
+		for (std::size_t i = 0; i < n; ++i) {
+			b[i] = static_cast<double>(i % 11) - 5.0;
+			for (std::size_t j = 0; j < 9; ++j) {
+				B(i, j) = static_cast<double>((i + j) % 5);
+			}
+		}
+		[[maybe_unused]] auto residual = [](const dyn_mat<double>& M, const dyn_mat<double>& X, const dyn_mat<double>& Y) {
+			dyn_mat<double> MX = M * X;
+			double r = 0.0;
+			for (std::size_t i = 0; i < Y.m(); ++i) {
+				for (std::size_t j = 0; j < Y.n(); ++j) {
+					r = std::max(r, std::abs(MX(i, j) - Y(i, j)));
+				}
+			}
+			return r;
+		};
+
+		// LU avec pivotage partiel (diagonale nulle : le pivotage est necessaire)
+		auto F = lu(A);
+		assert(!F.singular() && "LU regular");
+		dyn_vec<double> x = F.solve(b);
+		dyn_vec<double> Ax = A * x;
+		for (std::size_t i = 0; i < n; ++i) {
+			assert(std::abs(Ax[i] - b[i]) < 1e-8 && "LU solve");
+		}
+		assert(residual(A, F.solve(B), B) < 1e-8 && "LU solve, plusieurs seconds membres");
+		assert(std::abs(determinant(A) - F.determinant()) == 0.0 && "determinant dyn");
+		dyn_mat<double> I(n, n);
+		for (std::size_t i = 0; i < n; ++i) {
+			I(i, i) = 1.0;
+		}
+		assert(residual(A, inverse(A), I) < 1e-8 && "inverse dyn");
+
+		// Matrice singuliere : deux lignes egales
+		dyn_mat<double> Z(4, 4, 1.0);
+		assert(lu(Z).singular() && "LU singular");
+
+		// Cholesky sur une matrice symetrique definie positive
+		auto C = cholesky(S);
+		assert(C.positive_definite() && "Cholesky SPD");
+		assert(C.factor()(0, 1) == 0.0 && C.factor()(n - 1, n - 1) > 0.0 && "Cholesky L triangulaire");
+		dyn_mat<double> LLt(n, n);
+		for (std::size_t i = 0; i < n; ++i) {
+			for (std::size_t j = 0; j < n; ++j) {
+				double s = 0.0;
+				for (std::size_t k = 0; k < n; ++k) {
+					s += C.factor()(i, k) * C.factor()(j, k);
+				}
+				LLt(i, j) = s;
+			}
+		}
+		assert(residual(LLt, I, S) < 1e-12 && "Cholesky L L^T = S");
+		assert(residual(S, C.solve(B), B) < 1e-10 && "Cholesky solve");
+		dyn_mat<double> nd = S;
+		nd(n / 2, n / 2) = -1.0;
+		assert(!cholesky(nd).positive_definite() && "Cholesky non defini positif");
+
+		// QR : moindres carres, A^T (A x - b) = 0
+		const std::size_t m = 210;
+		dyn_mat<double> R(m, 130);
+		dyn_vec<double> c(m);
+		for (std::size_t i = 0; i < m; ++i) {
+			for (std::size_t j = 0; j < 130; ++j) {
+				R(i, j) = noise(i * 130 + j + 7);
+			}
+			c[i] = std::cos(static_cast<double>(i));
+		}
+		dyn_vec<double> ls = qr(R).solve(c);
+		assert(ls.size() == 130 && "QR taille de la solution");
+		dyn_vec<double> res = R * ls;
+		for (std::size_t i = 0; i < m; ++i) {
+			res[i] -= c[i];
+		}
+		dyn_vec<double> normal = res * R;
+		for (std::size_t j = 0; j < 130; ++j) {
+			assert(std::abs(normal[j]) < 1e-9 && "QR equations normales");
+		}
+		assert(residual(A, qr(A).solve(B), B) < 1e-8 && "QR carre");
+
+		// Tailles fixes au-dela des formes closes
+		static mat<double, 70, 70> Af;
+		static vec<double, 70> bf;
+		for (std::size_t i = 0; i < 70; ++i) {
+			for (std::size_t j = 0; j < 70; ++j) {
+				Af(i, j) = S(i, j);
+			}
+			bf[i] = b[i];
+		}
+		vec<double, 70> xf = solve(Af, bf);
+		[[maybe_unused]] vec<double, 70> xc = cholesky(Af).solve(bf);
+		[[maybe_unused]] vec<double, 70> xq = qr(Af).solve(bf);
+		[[maybe_unused]] vec<double, 70> Axf = Af * xf;
+		for (std::size_t i = 0; i < 70; ++i) {
+			assert(std::abs(Axf[i] - bf[i]) < 1e-10 && std::abs(xc[i] - xf[i]) < 1e-9
+			       && std::abs(xq[i] - xf[i]) < 1e-9 && "solveurs en taille fixe");
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// 23) Tests des noyaux deroules (tailles fixes <= unroll_max)
+	//--------------------------------------------------------------------------
+
+	{
+		// Evaluation a la compilation : dot, scaling, mat-vec, vec-mat, mat-mat
+		constexpr auto r = [] {
+			mat<int, 3, 4> A;
+			mat<int, 4, 2, col_major> B;
+			vec<int, 4> x;
+			vec<int, 3> y;
+			for (std::size_t i = 0; i < 4; ++i) {
+				x[i] = static_cast<int>(i) + 1;
+				for (std::size_t j = 0; j < 3; ++j) {
+					A(j, i) = static_cast<int>(i + 2 * j);
+				}
+				for (std::size_t j = 0; j < 2; ++j) {
+					B(i, j) = static_cast<int>(i * j) + 1;
+				}
+			}
+			y[0] = 1;
+			y[1] = -1;
+			y[2] = 2;
+			vec<int, 4> x2 = x * 2;
+			vec<int, 3> Ax = A * x2;
+			vec<int, 4> yA = y * A;
+			auto AB = A * B;
+			auto AtA = A.transpose() * A;
+			return std::array<int, 6>{dot(x, x2), Ax[2], yA[3], AB(2, 1), AtA(3, 3), AB(0, 0)};
+		}();
+		static_assert(r[0] == 60 && r[1] == 120 && r[2] == 12 && r[3] == 60 && r[4] == 83 && r[5] == 6,
+		              "constexpr unrolled kernels");
+
+		// Memes resultats que les boucles (8 = unroll_max, 9 n'est pas deroule)
+		mat<double, 8, 8> S;
+		mat<double, 9, 9> L;
+		vec<double, 8> u;
+		vec<double, 9> w;
+		for (std::size_t i = 0; i < 9; ++i) {
+			w[i] = static_cast<double>(i) * 0.5 - 1.0;
+			for (std::size_t j = 0; j < 9; ++j) {
+				L(i, j) = static_cast<double>((i * 9 + j) % 7) - 3.0;
+			}
+		}
+		for (std::size_t i = 0; i < 8; ++i) {
+			u[i] = w[i];
+			for (std::size_t j = 0; j < 8; ++j) {
+				S(i, j) = L(i, j);
+			}
+		}
+		[[maybe_unused]] vec<double, 8> Su = S * u;
+		[[maybe_unused]] vec<double, 9> Lw = L * w;
+		[[maybe_unused]] vec<double, 8> uS = u * S;
+		[[maybe_unused]] vec<double, 9> wL = w * L;
+		[[maybe_unused]] auto SS = S * S;
+		[[maybe_unused]] auto LL = L * L;
+		for (std::size_t i = 0; i < 8; ++i) {
+			assert(Su[i] == Lw[i] - L(i, 8) * w[8] && "mat-vec deroule");
+			assert(uS[i] == wL[i] - w[8] * L(8, i) && "vec-mat deroule");
+			for (std::size_t j = 0; j < 8; ++j) {
+				assert(SS(i, j) == LL(i, j) - L(i, 8) * L(8, j) && "mat-mat deroule");
+			}
+		}
+		assert(dot(u, u) == dot(w, w) - w[8] * w[8] && "dot deroule");
+	}
+
+	//--------------------------------------------------------------------------
+	// 24) Tests des matrices projetees en memoire et du produit en flux
+	//--------------------------------------------------------------------------
+
+	{
+		const auto dir = std::filesystem::temp_directory_path();
+		const std::string pa = (dir / "matvec_test_a.bin").string();
+		const std::string pb = (dir / "matvec_test_b.bin").string();
+		const std::string pc = (dir / "matvec_test_c.bin").string();
+
+		dyn_mat<float> A(70, 50);
+		dyn_mat<float> B(50, 45);
+		{
+			auto fa = mapped_mat<float>::create(pa, 70, 50);
+			auto fb = mapped_mat<float>::create(pb, 50, 45);
+			for (std::size_t i = 0; i < 70; ++i) {
+				for (std::size_t j = 0; j < 50; ++j) {
+					A(i, j) = fa(i, j) = static_cast<float>((i * 3 + j) % 7) - 3.f;
+				}
+			}
+			for (std::size_t i = 0; i < 50; ++i) {
+				for (std::size_t j = 0; j < 45; ++j) {
+					B(i, j) = fb(i, j) = static_cast<float>((i + 5 * j) % 4);
+				}
+			}
+			fa.flush();
+		}
+		dyn_mat<float> AB = A * B;
+
+		// Tampon de 16 x 16 elements par tuile : bords irreguliers dans les 3 dimensions
+		{
+			const auto fa = mapped_mat<float>::open(pa, 70, 50);
+			const auto fb = mapped_mat<float>::open(pb, 50, 45);
+			auto fc = mapped_mat<float>::create(pc, 70, 45);
+			multiply_streamed(fa, fb, fc, 5 * sizeof(float) * 16 * 16);
+		}
+		const auto fc = mapped_mat<float>::open(pc, 70, 45);
+		dyn_mat<float> C(70, 45);
+		multiply_streamed(A, B, C, 5 * sizeof(float) * 20 * 20);
+		[[maybe_unused]] bool too_small = false;
+		try {
+			multiply_streamed(A, B, C, 4 * sizeof(float));
+		} catch (const std::invalid_argument&) {
+			too_small = true;
+		}
+		assert(too_small && "multiply_streamed buffer too small");
+		for (std::size_t i = 0; i < 70; ++i) {
+			for (std::size_t j = 0; j < 45; ++j) {
+				assert(fc(i, j) == AB(i, j) && C(i, j) == AB(i, j) && "multiply_streamed");
+			}
+		}
+
+		// Erreurs d'E/S : fichier absent, dimensions incoherentes
+		[[maybe_unused]] bool missing = false;
+		[[maybe_unused]] bool mismatch = false;
+		try {
+			mapped_mat<float>::open((dir / "matvec_test_missing.bin").string(), 2, 2);
+		} catch (const std::system_error&) {
+			missing = true;
+		}
+		try {
+			mapped_mat<float>::open(pc, 70, 46);
+		} catch (const std::system_error&) {
+			mismatch = true;
+		}
+		assert(missing && mismatch && "mapped_mat errors");
+
+		std::filesystem::remove(pa);
+		std::filesystem::remove(pb);
+		std::filesystem::remove(pc);
+	}
+
+	//--------------------------------------------------------------------------
+	// 25) Tests de la serialisation binaire (save / load / load_mapped)
+	//--------------------------------------------------------------------------
+
+	{
+		const auto dir = std::filesystem::temp_directory_path();
+		const std::string pm = (dir / "matvec_test_m.bin").string();
+		const std::string pv = (dir / "matvec_test_v.bin").string();
+		const std::string pd = (dir / "matvec_test_d.bin").string();
+
+		// Aller-retour en taille fixe, avec changement de layout au chargement
+		mat<double, 3, 5, col_major> M;
+		vec<std::int16_t, 7> v;
+		for (std::size_t i = 0; i < 3; ++i) {
+			for (std::size_t j = 0; j < 5; ++j) {
+				M(i, j) = static_cast<double>(i * 5 + j) / 4.0;
+			}
+		}
+		for (std::size_t i = 0; i < 7; ++i) {
+			v[i] = static_cast<std::int16_t>(1000 - 300 * static_cast<int>(i));
+		}
+		save(pm, M);
+		save(pv, v);
+		assert((load<vec<std::int16_t, 7>>(pv).data == v.data) && "load vec");
+		assert((load<mat<double, 3, 5, col_major>>(pm).data == M.data) && "load mat");
+		[[maybe_unused]] auto Mr = load<mat<double, 3, 5>>(pm);
+		dyn_mat<double> Md = load<dyn_mat<double>>(pm);
+		for (std::size_t i = 0; i < 3; ++i) {
+			for (std::size_t j = 0; j < 5; ++j) {
+				assert(Mr(i, j) == M(i, j) && Md(i, j) == M(i, j) && "load avec conversion de layout");
+			}
+		}
+		const file_header h = read_header(pm);
+		assert(h.rows == 3 && h.cols == 5 && h.layout == 1 && h.type == element_type::f64
+		       && h.data_offset % 64 == 0 && "read_header");
+
+		// Ecriture en flux, puis chargement sans copie
+		{
+			matrix_writer<float> w(pd, 40, 33);
+			dyn_vec<float> row(33);
+			for (std::size_t i = 0; i < 40; ++i) {
+				for (std::size_t j = 0; j < 33; ++j) {
+					row[j] = static_cast<float>(i) - static_cast<float>(j) * 0.5f;
+				}
+				w.write(row);
+			}
+			assert(w.remaining() == 0 && "matrix_writer remaining");
+			w.close();
+		}
+		const auto D = load_mapped<float>(pd);
+		assert(D.m() == 40 && D.n() == 33 && D(39, 32) == 39.f - 16.f && "load_mapped");
+		assert(reinterpret_cast<std::uintptr_t>(D.data()) % 64 == 0 && "load_mapped aligned");
+		assert(load<dyn_mat<float>>(pd)(7, 3) == D(7, 3) && "load dyn_mat");
+		mat<float, 33, 2> P(1.f);
+		[[maybe_unused]] auto DP = D.view<40, 33>() * P;
+		assert(DP(39, 1) == static_cast<float>(39 * 33) - 0.5f * static_cast<float>(32 * 33 / 2) && "view mapped");
+
+		// Fichiers invalides : type, forme, layout, ecriture incomplete
+		[[maybe_unused]] auto fails = [](auto&& f) {
+			try {
+				f();
+			} catch (const std::system_error&) {
+				return true;
+			}
+			return false;
+		};
+		assert(fails([&] { load<dyn_mat<double>>(pd); }) && "type mismatch");
+		assert((fails([&] { load<mat<float, 40, 32>>(pd); })) && "shape mismatch");
+		assert(fails([&] { load_mapped<double>(pm); }) && "zero-copy col-major");
+		assert(fails([&] { load<dyn_vec<std::int16_t>>(pm); }) && "not a matrix of int16");
+		assert(fails([&] {
+			matrix_writer<float> w(pd, 2, 2);
+			w.close();
+		}) && "incomplete write");
+		assert(fails([&] { read_header(pd); }) && "truncated file");
+
+		// En-tetes forges : alignement qui n'est pas une puissance de deux,
+		// elements mal alignes pour le type lu
+		const auto forge = [&](std::uint32_t alignment, std::uint64_t offset) {
+			file_header fh = h;
+			fh.alignment = alignment;
+			fh.data_offset = offset;
+			std::FILE* out = std::fopen(pd.c_str(), "wb");
+			std::fwrite(&fh, sizeof(fh), 1, out);
+			const std::array<char, 64> zeros{};
+			std::fwrite(zeros.data(), 1, offset - sizeof(fh), out);
+			std::fwrite(M.data.data(), sizeof(double), M.data.size(), out);
+			std::fclose(out);
+		};
+		forge(1, 64);
+		assert(load<dyn_mat<double>>(pd)(2, 4) == M(2, 4) && "alignment 1, aligned offset");
+		forge(1, 65);
+		assert(fails([&] { load<dyn_mat<double>>(pd); }) && fails([&] { load_mapped<double>(pd); })
+		       && "misaligned elements");
+		forge(48, 96);
+		assert(fails([&] { read_header(pd); }) && "alignment not a power of two");
+
+		std::filesystem::remove(pm);
+		std::filesystem::remove(pv);
+		std::filesystem::remove(pd);
+	}
+
+	//--------------------------------------------------------------------------
+	// 26) Tests du produit de Strassen-Winograd
+	//--------------------------------------------------------------------------
+
+	{
+		// Coefficients dans [-1, 1] : |A| <= 1 et |B| <= 1 dans la borne d'erreur
+		const auto fill = [](auto& M, std::uint64_t seed) {
+			for (std::size_t i = 0; i < M.m(); ++i) {
+				for (std::size_t j = 0; j < M.n(); ++j) {
+					std::uint64_t k = (i * M.n() + j + 1) * (seed + 1);
+					k *= 0x9E3779B97F4A7C15u;
+					k ^= k >> 29;
+					M(i, j) = static_cast<double>(k % 1000) / 500.0 - 1.0;
+				}
+			}
+		};
+
+		// Tailles paires et impaires, plusieurs niveaux de recursion
+		strassen_workspace<double> ws;
+		for (std::size_t n : {1, 2, 3, 7, 16, 33, 64, 101}) {
+			for (std::size_t cutoff : {1, 4, 8}) {
+				const strassen_options opts{cutoff};
+				dyn_mat<double> A(n, n), B(n, n);
+				fill(A, 1);
+				fill(B, 2);
+				const dyn_mat<double> ref = A * B;
+				const dyn_mat<double> C = multiply_strassen(A, B, ws, opts);
+				[[maybe_unused]] const double tol = strassen_error_bound(n, opts) * std::numeric_limits<double>::epsilon();
+				double err = 0.0;
+				for (std::size_t i = 0; i < n; ++i) {
+					for (std::size_t j = 0; j < n; ++j) {
+						err = std::max(err, std::abs(C(i, j) - ref(i, j)));
+					}
+				}
+				assert(err <= tol && "multiply_strassen dans la borne d'erreur");
+				assert(ws.capacity() >= strassen_workspace<double>::required(n, opts) && "workspace");
+			}
+		}
+
+		// L'espace de travail est reutilise sans reallocation
+		[[maybe_unused]] const double* before = ws.data();
+		[[maybe_unused]] const std::size_t capacity = ws.capacity();
+		{
+			dyn_mat<double> A(40, 40), B(40, 40);
+			fill(A, 3);
+			fill(B, 4);
+			multiply_strassen(A, B, ws, strassen_options{4});
+		}
+		assert(ws.data() == before && ws.capacity() == capacity && "workspace reutilise");
+		assert(strassen_workspace<double>::required(64, strassen_options{64}) == 0 && "pas de recursion");
+		assert(strassen_error_bound(64, strassen_options{64}) == 64.0 * 64.0 && "borne classique");
+
+		// Taille fixe, espace de travail par thread
+		mat<float, 24, 24> F, G, H;
+		for (std::size_t i = 0; i < 24; ++i) {
+			for (std::size_t j = 0; j < 24; ++j) {
+				F(i, j) = static_cast<float>((i + 2 * j) % 5);
+				G(i, j) = static_cast<float>((3 * i + j) % 4) - 1.f;
+			}
+		}
+		multiply_strassen(F, G, H, strassen_options{5});
+		[[maybe_unused]] const mat<float, 24, 24> FG = F * G;
+		assert(H.data == FG.data && "multiply_strassen mat (entiers exacts)");
+	}
+
+	//--------------------------------------------------------------------------
+	// 27) Tests de l'arene et du compteur d'allocations
+	//--------------------------------------------------------------------------
+
+	{
+		// Compteur : une allocation par dyn_vec sur le tas, taille arrondie a la ligne de cache
+		[[maybe_unused]] const allocation_stats one = count_allocations([] { dyn_vec<float> v(100); });
+		assert(one.allocations == 1 && one.bytes == 112 * sizeof(float) && "count_allocations");
+
+		// Allocation par increment, alignement et remise a zero
+		arena ws(1024);
+		const std::size_t first = ws.capacity();
+		[[maybe_unused]] float* p = ws.allocate<float>(10);
+		assert(reinterpret_cast<std::uintptr_t>(p) % 64 == 0 && p[9] == 0.f && "arena allocate");
+		const arena::marker m = ws.mark();
+		[[maybe_unused]] char* c = static_cast<char*>(ws.allocate_bytes(3, 1));
+		[[maybe_unused]] double* d = ws.allocate<double>(2);
+		assert(c == reinterpret_cast<char*>(p + 10) && reinterpret_cast<char*>(d) == reinterpret_cast<char*>(p) + 64
+		       && "arena bump");
+		ws.rewind(m);
+		assert(static_cast<char*>(ws.allocate_bytes(3, 1)) == c && "arena rewind");
+		{
+			const arena_scope scope(ws);
+			ws.allocate<double>(100);
+		}
+		assert(ws.used() == 43 && "arena_scope");
+
+		// Depassement : un second bloc (et la liste des blocs qui grandit), fusionne par reset()
+		[[maybe_unused]] const allocation_stats grow = count_allocations([&] { ws.allocate_bytes(first); });
+		assert(grow.allocations == 2 && ws.blocks() == 2 && "arena grows");
+		ws.reset();
+		assert(ws.blocks() == 1 && ws.capacity() >= 3 * first && ws.used() == 0 && "arena reset");
+		[[maybe_unused]] const allocation_stats again = count_allocations([&] {
+			ws.allocate<float>(10);
+			ws.allocate_bytes(first);
+		});
+		assert(again.allocations == 0 && "arena reused after reset");
+		ws.reset();
+
+		// dyn_vec / dyn_mat pris dans l'arene, copies sur le tas
+		dyn_mat<double> A(7, 5);
+		for (std::size_t i = 0; i < 7; ++i) {
+			for (std::size_t j = 0; j < 5; ++j) {
+				A(i, j) = static_cast<double>(i * 5 + j);
+			}
+		}
+		{
+			const arena_scope scope(ws);
+			dyn_mat<double> Aw(A, ws);
+			assert(Aw.ld() == A.ld() && Aw(6, 4) == 34.0 && Aw.row_data(1)[5] == 0.0 && "dyn_mat dans l'arene");
+			[[maybe_unused]] const allocation_stats copy = count_allocations([&] { dyn_mat<double> Ah(Aw); });
+			assert(copy.allocations == 1 && "copie sur le tas");
+		}
+
+		// Regime permanent : produits, factorisations et resolutions sans allocation
+		const std::size_t n = 80;
+		dyn_mat<double> M(n, n), S(n, n), B(n, n);
+		dyn_vec<double> b(n);
+		for (std::size_t i = 0; i < n; ++i) {
+			for (std::size_t j = 0; j < n; ++j) {
+				M(i, j) = static_cast<double>((i * 7 + j * 3) % 11) / 11.0 + (i == j ? 4.0 : 0.0);
+				B(i, j) = static_cast<double>((i + 2 * j) % 5);
+			}
+			b[i] = static_cast<double>(i % 9) - 4.0;
+		}
+		for (std::size_t i = 0; i < n; ++i) {
+			for (std::size_t j = 0; j < n; ++j) {
+				S(i, j) = M(i, j) + M(j, i);
+			}
+			S(i, i) += static_cast<double>(n);
+		}
+		const dyn_vec<double> x_ref = solve(M, b);
+		const dyn_mat<double> MB_ref = M * B;
+		double checksum = 0.0;
+		const auto step = [&] {
+			const arena_scope scope(ws);
+			const dyn_vec<double> y = multiply(M, b, ws);
+			const dyn_vec<double> z = multiply(b, M, ws);
+			const dyn_mat<double> MB = multiply(M, B, ws);
+			const dyn_vec<double> x = solve(M, b, ws);
+			const dyn_vec<double> xc = cholesky(S, ws).solve(dyn_vec<double>(b, ws));
+			const dyn_vec<double> xq = qr(M, ws).solve(dyn_vec<double>(b, ws), ws);
+			checksum += y[0] + z[0] + MB(3, 4) + x[0] + xc[0] + xq[0] + determinant(M);
+			assert(MB(n - 1, n - 2) == MB_ref(n - 1, n - 2) && "multiply dans l'arene");
+			for (std::size_t i = 0; i < n; ++i) {
+				assert(std::abs(x[i] - x_ref[i]) < 1e-12 && std::abs(xq[i] - x_ref[i]) < 1e-10 && "solve dans l'arene");
+			}
+		};
+		step();
+		ws.reset();
+		[[maybe_unused]] const allocation_stats steady = count_allocations([&] {
+			for (int it = 0; it < 5; ++it) {
+				step();
+			}
+		});
+		assert(steady.allocations == 0 && steady.bytes == 0 && "aucune allocation en regime permanent");
+		assert(checksum != 0.0 && ws.used() == 0);
+
+		// Tampons d'empaquetage du GEMM : comptes au premier produit d'un thread, reutilises ensuite
+		std::thread([] {
+			const dyn_mat<float> P(300, 300), Q(300, 300);
+			[[maybe_unused]] const allocation_stats first_product = count_allocations([&] { const dyn_mat<float> PQ = P * Q; });
+			[[maybe_unused]] const allocation_stats next_product = count_allocations([&] { const dyn_mat<float> PQ = P * Q; });
+			assert(next_product.allocations == 1 && first_product.allocations == 3 && "packing buffers counted");
+		}).join();
+	}
+
+	//--------------------------------------------------------------------------
+	// 28) Tests du point fixe et de l'arithmetique saturee
+	//--------------------------------------------------------------------------
+
+	{
+		// Entiers satures
+		static_assert(add_sat<std::int16_t>(30000, 10000) == 32767 && add_sat<std::int16_t>(-30000, -10000) == -32768);
+		static_assert(sub_sat<std::uint8_t>(3, 5) == 0 && sub_sat<std::int8_t>(-100, 100) == -128);
+		static_assert(mul_sat<std::int8_t>(-128, -1) == 127 && mul_sat<std::int32_t>(-65536, 65536) == INT32_MIN);
+		static_assert(add_sat<std::uint32_t>(4000000000u, 1000000000u) == UINT32_MAX);
+
+		// Q15 : arrondi au plus proche, saturation au lieu du debordement
+		static_assert(q15(0.5) * q15(0.5) == q15(0.25) && q15(-1.0) * q15(-1.0) == q15::max());
+		static_assert(q15(0.75) + q15(0.5) == q15::max() && q15(-0.75) - q15(0.5) == q15::lowest());
+		static_assert(-q15::lowest() == q15::max() && q15(2.0) == q15::max() && q15(-3.0) == q15::lowest());
+		static_assert(q15(0.25) / q15(0.5) == q15(0.5) && q15(0.5) / q15(0.25) == q15::max());
+		static_assert(q15::from_raw(3) * q15(0.5) == q15::from_raw(2) && q15::from_raw(-3) * q15(0.5) == q15::from_raw(-1));
+		static_assert(q7_8(1.5) * q7_8(-2.25) == q7_8(-3.375) && q7_8(100.0) * q7_8(2.0) == q7_8::max());
+		static_assert(q7_8(1.0) / q7_8(3.0) == q7_8::from_raw(85) && q7_8(-1.0) / q7_8(3.0) == q7_8::from_raw(-85));
+		static_assert(q15_16(-2.5) * q15_16(4.0) == q15_16(-10.0) && q31(0.5) * q31(-0.5) == q31(-0.25));
+		static_assert(double(q15(-0.25)) == -0.25 && q15(0.1) < q15(0.2));
+
+		// Produit scalaire en taille fixe : evaluable a la compilation, identique a l'execution
+		constexpr vec<q15, 40> half = [] {
+			vec<q15, 40> v;
+			for (std::size_t i = 0; i < 40; ++i) {
+				v[i] = q15((i % 2 == 0 ? 0.5 : -0.25) / 8.0);
+			}
+			return v;
+		}();
+		static_assert(dot(half, half) == q15(20.0 * (1.0 / 256.0 + 1.0 / 1024.0)));
+		assert(dot(half, half) == q15(20.0 * (1.0 / 256.0 + 1.0 / 1024.0)) && "dot q15");
+
+		// Un seul arrondi, une seule saturation : la somme ne sature pas a mi-parcours
+		vec<q15, 100> u, v;
+		for (std::size_t i = 0; i < 100; ++i) {
+			u[i] = q15(i < 50 ? 0.9 : -0.9);
+			v[i] = q15(0.9);
+		}
+		assert(dot(u, v) == q15(0.0) && "dot sans saturation intermediaire");
+		for (std::size_t i = 0; i < 100; ++i) {
+			u[i] = q15::lowest();
+			v[i] = q15::lowest();
+		}
+		assert(dot(u, v) == q15::max() && "dot sature");
+
+		// Reference exacte en int64 pour le mat-vec, tailles fixes et dynamiques
+		const auto reference = [](const q15* a, const q15* x, std::size_t n) {
+			std::int64_t acc = 0;
+			for (std::size_t j = 0; j < n; ++j) {
+				acc += std::int64_t{a[j].raw} * x[j].raw;
+			}
+			acc = (acc + (1 << 14)) >> 15;
+			return q15::from_raw(static_cast<std::int16_t>(std::clamp<std::int64_t>(acc, -32768, 32767)));
+		};
+		mat<q15, 13, 77> A;
+		vec<q15, 77> x;
+		dyn_mat<q15> Ad(13, 77);
+		dyn_vec<q15> xd(77);
+		for (std::size_t i = 0; i < 13; ++i) {
+			for (std::size_t j = 0; j < 77; ++j) {
+				std::uint64_t k = (i * 77 + j + 1) * 0x9E3779B97F4A7C15u;
+				k ^= k >> 29;
+				A(i, j) = Ad(i, j) = q15::from_raw(static_cast<std::int16_t>(k >> 48));
+			}
+		}
+		for (std::size_t j = 0; j < 77; ++j) {
+			x[j] = xd[j] = q15::from_raw(static_cast<std::int16_t>(j % 3 == 0 ? -32768 : 1000 * j));
+		}
+		[[maybe_unused]] const vec<q15, 13> y = A * x;
+		const dyn_vec<q15> yd = Ad * xd;
+		for (std::size_t i = 0; i < 13; ++i) {
+			[[maybe_unused]] const q15 ref = reference(A.data.data() + i * 77, x.data.data(), 77);
+			assert(y[i] == ref && yd[i] == ref && "mat-vec q15");
+		}
+		assert(dot(xd, xd) == reference(x.data.data(), x.data.data(), 77) && "dot dyn_vec q15");
+
+		// Format 32 bits
+		vec<q15_16, 9> w;
+		for (std::size_t i = 0; i < 9; ++i) {
+			w[i] = q15_16(static_cast<double>(i) - 4.5);
+		}
+		assert(dot(w, w) == q15_16(62.25) && "dot q15_16");
+	}
+
 	//--------------------------------------------------------------------------
 	// S'il n'y a eu aucune erreur, on affiche un message final
 	//--------------------------------------------------------------------------
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Work-stealing thread pool
+//
+// Each worker owns a task deque. Workers pop their own tasks LIFO and steal
+// from the other deques FIFO when they run dry. parallel_for() blocks the
+// caller until the whole batch is done, and the caller runs tasks while it
+// waits, so nested parallel_for() calls cannot deadlock.
+//------------------------------------------------------------------------------
+
+class thread_pool {
+	public:
+	// threads is the total parallelism, the calling thread included
+	explicit thread_pool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+		: queues(std::max<std::size_t>(threads, 1)) {
+		for (auto& q : queues) {
+			q = std::make_unique<task_queue>();
+		}
+		for (std::size_t i = 1; i < queues.size(); ++i) {
+			workers.emplace_back([this, i] { worker_loop(i); });
+		}
+	}
+
+	thread_pool(const thread_pool&) = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+
+	~thread_pool() {
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto& w : workers) {
+			w.join();
+		}
+	}
+
+	std::size_t size() const { return queues.size(); }
+
+	// Runs fn(i) for every i in [0, count) and waits for completion. The first
+	// exception thrown by a task is rethrown here once the batch has drained.
+	template <typename F> void parallel_for(std::size_t count, F&& fn) {
+		if (count == 0) {
+			return;
+		}
+		if (count == 1 || queues.size() == 1) {
+			for (std::size_t i = 0; i < count; ++i) {
+				fn(i);
+			}
+			return;
+		}
+
+		batch b;
+		b.remaining = count;
+		for (std::size_t i = 0; i < count; ++i) {
+			push(i % queues.size(), [&b, &fn, i] {
+				try {
+					fn(i);
+				} catch (...) {
+					std::lock_guard<std::mutex> lock(b.mutex);
+					if (!b.error) {
+						b.error = std::current_exception();
+					}
+				}
+				// Decrement under the lock: once the caller sees zero, no task
+				// touches the batch anymore
+				std::lock_guard<std::mutex> lock(b.mutex);
+				if (b.remaining.fetch_sub(1) == 1) {
+					b.done.notify_all();
+				}
+			});
+		}
+
+		// Help until the batch is empty, then wait for tasks still in flight
+		while (b.remaining.load() != 0 && run_one(0)) {
+		}
+		{
+			std::unique_lock<std::mutex> lock(b.mutex);
+			b.done.wait(lock, [&b] { return b.remaining.load() == 0; });
+		}
+		if (b.error) {
+			std::rethrow_exception(b.error);
+		}
+	}
+
+	// Process-wide pool sized to the machine
+	static thread_pool& global() {
+		static thread_pool pool;
+		return pool;
+	}
+
+	private:
+	struct task_queue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	struct batch {
+		std::atomic<std::size_t> remaining{0};
+		std::mutex mutex;
+		std::condition_variable done;
+		std::exception_ptr error;
+	};
+
+	void push(std::size_t index, std::function<void()> task) {
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+			++queued;
+		}
+		{
+			std::lock_guard<std::mutex> lock(queues[index]->mutex);
+			queues[index]->tasks.push_back(std::move(task));
+		}
+		wake.notify_one();
+	}
+
+	// Pops from our own deque, or steals from the others. Returns false when
+	// every deque is empty.
+	bool run_one(std::size_t self) {
+		std::function<void()> task;
+		for (std::size_t k = 0; k < queues.size() && !task; ++k) {
+			task_queue& q = *queues[(self + k) % queues.size()];
+			std::lock_guard<std::mutex> lock(q.mutex);
+			if (q.tasks.empty()) {
+				continue;
+			}
+			if (k == 0) {
+				task = std::move(q.tasks.back());
+				q.tasks.pop_back();
+			} else {
+				task = std::move(q.tasks.front());
+				q.tasks.pop_front();
+			}
+		}
+		if (!task) {
+			return false;
+		}
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+			--queued;
+		}
+		task();
+		return true;
+	}
+
+	void worker_loop(std::size_t self) {
+		for (;;) {
+			if (run_one(self)) {
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(sleep_mutex);
+			wake.wait(lock, [this] { return stopping || queued != 0; });
+			if (stopping) {
+				return;
+			}
+		}
+	}
+
+	std::vector<std::unique_ptr<task_queue>> queues;
+	std::vector<std::thread> workers;
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+	std::size_t queued = 0;
+	bool stopping = false;
+};
+
+//------------------------------------------------------------------------------
+// Execution policies
+//
+// seq runs on the calling thread. par runs on a thread pool, the global one
+// unless par.on(pool) is used.
+//------------------------------------------------------------------------------
+
+namespace execution {
+
+struct sequenced_policy {};
+
+struct parallel_policy {
+	thread_pool* pool = nullptr;
+
+	constexpr parallel_policy on(thread_pool& p) const { return parallel_policy{&p}; }
+
+	thread_pool& executor() const { return pool ? *pool : thread_pool::global(); }
+};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+
+} // namespace execution
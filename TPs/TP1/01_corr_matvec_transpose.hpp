@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "01_corr_matvec_impl.hpp"
+#include "01_corr_matvec_dyn.hpp"
+
+// Materialized transposes
+//
+// transpose() on mat is an O(1) view. When the transposed data is actually
+// needed in memory (e.g. before a batch of vec-mat products), transposed()
+// and transpose_in_place() move it with a cache-oblivious recursion: the
+// larger dimension is halved until a block fits in L1, and leaf blocks are
+// moved by SIMD W x W register tiles (simd::transpose_tile).
+
+namespace detail {
+
+// Leaf size of the recursion, in elements per side
+inline constexpr std::size_t transpose_leaf = 64;
+
+// Split point of n, rounded to a multiple of the tile width
+template <typename T> constexpr std::size_t transpose_split(std::size_t n) {
+	constexpr std::size_t W = simd::transpose_width<T>();
+	return std::max(W, n / 2 / W * W);
+}
+
+// dst[j * ldd + i] = src[i * lds + j] for a rows x cols block
+template <typename T>
+void transpose_copy(std::size_t rows, std::size_t cols, const T* src, std::size_t lds, T* dst, std::size_t ldd) {
+	constexpr std::size_t W = simd::transpose_width<T>();
+	if (rows > transpose_leaf || cols > transpose_leaf) {
+		if (rows >= cols) {
+			const std::size_t h = transpose_split<T>(rows);
+			transpose_copy(h, cols, src, lds, dst, ldd);
+			transpose_copy(rows - h, cols, src + h * lds, lds, dst + h, ldd);
+		} else {
+			const std::size_t h = transpose_split<T>(cols);
+			transpose_copy(rows, h, src, lds, dst, ldd);
+			transpose_copy(rows, cols - h, src + h, lds, dst + h * ldd, ldd);
+		}
+		return;
+	}
+
+	const std::size_t rows_w = rows / W * W;
+	const std::size_t cols_w = cols / W * W;
+	for (std::size_t i = 0; i < rows_w; i += W) {
+		for (std::size_t j = 0; j < cols_w; j += W) {
+			simd::transpose_tile(src + i * lds + j, lds, dst + j * ldd + i, ldd);
+		}
+	}
+	// Ragged right and bottom edges
+	for (std::size_t i = 0; i < rows; ++i) {
+		for (std::size_t j = (i < rows_w ? cols_w : 0); j < cols; ++j) {
+			dst[j * ldd + i] = src[i * lds + j];
+		}
+	}
+}
+
+// Exchanges the rows x cols block a with the transpose of the cols x rows
+// block b (the two off-diagonal blocks of a square in-place transpose)
+template <typename T>
+void transpose_swap(std::size_t rows, std::size_t cols, T* a, T* b, std::size_t ld) {
+	constexpr std::size_t W = simd::transpose_width<T>();
+	if (rows > transpose_leaf || cols > transpose_leaf) {
+		if (rows >= cols) {
+			const std::size_t h = transpose_split<T>(rows);
+			transpose_swap(h, cols, a, b, ld);
+			transpose_swap(rows - h, cols, a + h * ld, b + h, ld);
+		} else {
+			const std::size_t h = transpose_split<T>(cols);
+			transpose_swap(rows, h, a, b, ld);
+			transpose_swap(rows, cols - h, a + h, b + h * ld, ld);
+		}
+		return;
+	}
+
+	const std::size_t rows_w = rows / W * W;
+	const std::size_t cols_w = cols / W * W;
+	T tmp[W * W];
+	for (std::size_t i = 0; i < rows_w; i += W) {
+		for (std::size_t j = 0; j < cols_w; j += W) {
+			T* ta = a + i * ld + j;
+			T* tb = b + j * ld + i;
+			simd::transpose_tile(ta, ld, tmp, W);
+			simd::transpose_tile(tb, ld, ta, ld);
+			for (std::size_t r = 0; r < W; ++r) {
+				std::copy_n(tmp + r * W, W, tb + r * ld);
+			}
+		}
+	}
+	for (std::size_t i = 0; i < rows; ++i) {
+		for (std::size_t j = (i < rows_w ? cols_w : 0); j < cols; ++j) {
+			std::swap(a[i * ld + j], b[j * ld + i]);
+		}
+	}
+}
+
+// In-place transpose of the n x n block at a
+template <typename T>
+void transpose_square(std::size_t n, T* a, std::size_t ld) {
+	constexpr std::size_t W = simd::transpose_width<T>();
+	if (n > transpose_leaf) {
+		const std::size_t h = transpose_split<T>(n);
+		transpose_square(h, a, ld);
+		transpose_square(n - h, a + h * ld + h, ld);
+		transpose_swap(h, n - h, a + h, a + h * ld, ld);
+		return;
+	}
+
+	const std::size_t n_w = n / W * W;
+	T tmp[W * W];
+	for (std::size_t i = 0; i < n_w; i += W) {
+		// Diagonal tile through a temporary, off-diagonal tiles by pairs
+		T* d = a + i * ld + i;
+		simd::transpose_tile(d, ld, tmp, W);
+		for (std::size_t r = 0; r < W; ++r) {
+			std::copy_n(tmp + r * W, W, d + r * ld);
+		}
+		if (i + W < n_w) {
+			transpose_swap(W, n_w - i - W, d + W, d + W * ld, ld);
+		}
+	}
+	for (std::size_t i = 0; i < n; ++i) {
+		for (std::size_t j = std::max(i + 1, n_w); j < n; ++j) {
+			std::swap(a[i * ld + j], a[j * ld + i]);
+		}
+	}
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// mat
+//------------------------------------------------------------------------------
+
+// Out-of-place: returns A^T in the same layout as A
+template <typename T, std::size_t M, std::size_t N, typename L>
+constexpr mat<T, N, M, L> transposed(const mat<T, M, N, L>& A) {
+	mat<T, N, M, L> result;
+	if (!std::is_constant_evaluated()) {
+		// The storage of A^T in layout L is the storage of A read in the other
+		// layout, so both layouts reduce to a row-major copy
+		constexpr bool row = std::is_same_v<L, row_major>;
+		detail::transpose_copy(row ? M : N, row ? N : M, A.data.data(), row ? N : M,
+		                       result.data.data(), row ? M : N);
+		return result;
+	}
+	for (std::size_t i = 0; i < M; ++i) {
+		for (std::size_t j = 0; j < N; ++j) {
+			result(j, i) = A(i, j);
+		}
+	}
+	return result;
+}
+
+// In-place, square matrices only
+template <typename T, std::size_t N, typename L>
+constexpr void transpose_in_place(mat<T, N, N, L>& A) {
+	if (!std::is_constant_evaluated()) {
+		detail::transpose_square(N, A.data.data(), N);
+		return;
+	}
+	for (std::size_t i = 0; i < N; ++i) {
+		for (std::size_t j = i + 1; j < N; ++j) {
+			std::swap(A(i, j), A(j, i));
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// dyn_mat
+//------------------------------------------------------------------------------
+
+template <typename T> dyn_mat<T> transposed(const dyn_mat<T>& A) {
+	dyn_mat<T> result(A.n(), A.m());
+	detail::transpose_copy(A.m(), A.n(), A.data(), A.ld(), result.data(), result.ld());
+	return result;
+}
+
+// Square matrices are transposed in place; other shapes go through a new
+// buffer since the dimensions (and the padded leading dimension) change
+template <typename T> void transpose_in_place(dyn_mat<T>& A) {
+	if (A.m() == A.n()) {
+		detail::transpose_square(A.m(), A.data(), A.ld());
+	} else {
+		A = transposed(A);
+	}
+}
@@ -1,158 +1,532 @@
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
-#include <array>
+#include <stdexcept>
 #include <vector>
-#include <cstdint>
-#include <cassert>
-#include <concepts>
 
+#include "03_corr_concepts_impl.hpp"
+#include "03_corr_concepts_simd.hpp"
+#include "03_corr_concepts_image.hpp"
+#include "03_corr_concepts_packed.hpp"
+#include "03_corr_concepts_pipeline.hpp"
 
-/**
-  Exercice 2 - Manipulation de pixel
+// Pixels d'essai dont les composantes parcourent toute la plage [0, 255]
+static std::vector<rgb_pixel> test_rgb(std::size_t n, unsigned seed)
+{
+  std::vector<rgb_pixel> p(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    unsigned x = static_cast<unsigned>(i) * 2654435761u + seed;
+    p[i] = rgb_pixel{ std::uint8_t(x), std::uint8_t(x >> 8), std::uint8_t(x >> 16) };
+  }
+  return p;
+}
 
-  On souhaite ecrire une petite bibliothèque pour traiter des opérations 
-  colorimétriques sur des pixels.
+int main()
+{
+  //--------------------------------------------------------------------------
+  // 1) Pixels et color_mix pixel par pixel
+  //--------------------------------------------------------------------------
 
-  Q2.1  Implémentez le plus simplement possible: 
-      - une structure grey_pixel qui contient la représentation d'un pixel
-        en niveau de gris sur un entier 8 bits non signé
-      - une structure rgb_pixel qui contient les trois composantes Rouge, Vert
-        et Bleu d'un pixel sous la forme de trois entiers 8 bits non signés
-      - une classe rgba_pixel qui contient les trois composantes Rouge, Vert
-        et Bleu ainsi qu'un niveau de transparence Alpha sous forme de quatre
-        réels simple précision. Cette classe devra fournir un constrcuteur qui
-        vérifie (en utilisant assert) que les valeurs qui lui sont passées sont
-        comprises dans l'interval [0,1]. Elle fournit de plus 4 membres permettant
-        l'accés en lecture seul à ces composants : red(), green(), blue() et 
-        alpha()
+  {
+    rgba_pixel p{ 0.25f, 0.5f, 0.75f, 1.f };
+    assert(p.red() == 0.25f && p.green() == 0.5f && p.blue() == 0.75f && p.alpha() == 1.f);
 
-        Ecrivez de petits test pour vérifier leur comportements.
+    [[maybe_unused]] grey_pixel g = color_mix(grey_pixel{ 200 }, grey_pixel{ 100 }, 0.5f);
+    assert(g.level == 150 && "grey color_mix");
 
-  Q2.2  Pour chacun des types de pixels, implémentez une fonction  
-        color_mix qui prend deux pixels a et b du meme type et un
-        réel simple précision ratio.
+    [[maybe_unused]] rgb_pixel c = color_mix(rgb_pixel{ 255, 0, 10 }, rgb_pixel{ 0, 255, 20 }, 0.25f);
+    assert(c.r == 63 && c.g == 191 && c.b == 17 && "rgb color_mix");
 
-        color_mix calcul l'interpolation des deux pixels en entrée en calculant
-        pour chaque composant des pixels a et b, la somme pondéré par ratio:
-            a.composant * ratio + b.composant * (1-ratio)
+    [[maybe_unused]] rgba_pixel m = color_mix(p, rgba_pixel{ 0.f, 0.f, 0.f, 0.f }, 0.5f);
+    assert(m.red() == 0.125f && m.alpha() == 0.5f && "rgba color_mix");
+  }
 
-  Q2.3  Proposez une stratégie d'adaptation et un concept pixel permettant d'unifier 
-        toutes les implémentation de color_mix en une seule
+  //--------------------------------------------------------------------------
+  // 2) color_mix sur des buffers entiers
+  //--------------------------------------------------------------------------
 
-  Q2.4  Implémentez les fonctions nécessaires à cette unification.
+  // rgb : a 1 près du calcul pixel par pixel, arrondi au plus proche
+  // (tailles qui ne tombent pas sur la largeur des registres)
+  for (std::size_t n : { 0, 1, 5, 16, 33, 100, 1001 })
+  {
+    const std::vector<rgb_pixel> a = test_rgb(n, 1), b = test_rgb(n, 12345);
+    std::vector<rgb_pixel> dst(n);
+    for (float ratio : { 0.f, 0.1f, 0.5f, 0.77f, 1.f })
+    {
+      color_mix(a, b, dst, ratio);
+      [[maybe_unused]] const float w = std::round(ratio * 256.f) / 256.f;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        const rgb_pixel ref = color_mix(a[i], b[i], ratio);
+        [[maybe_unused]] const std::uint8_t got[] = { dst[i].r, dst[i].g, dst[i].b };
+        [[maybe_unused]] const std::uint8_t want[] = { ref.r, ref.g, ref.b };
+        [[maybe_unused]] const std::uint8_t ca[] = { a[i].r, a[i].g, a[i].b };
+        [[maybe_unused]] const std::uint8_t cb[] = { b[i].r, b[i].g, b[i].b };
+        for (int k = 0; k < 3; ++k)
+        {
+          assert(std::abs(got[k] - want[k]) <= 1 && "rgb color_mix buffer vs pixel");
+          assert(got[k] == std::uint8_t(std::floor(ca[k] * w + cb[k] * (1.f - w) + 0.5f))
+                 && "rgb color_mix buffer rounding");
+        }
+      }
+      if (ratio == 1.f)
+      {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          assert(dst[i].r == a[i].r && dst[i].g == a[i].g && dst[i].b == a[i].b && "ratio 1 gives a");
+        }
+      }
+    }
+  }
 
-  Q2.5  Implémentez une fonction color_mix2 qui utilise le concept pixel pour
-        factorisez le code de color_mix.
+  // grey, y compris en place
+  {
+    const std::size_t n = 77;
+    std::vector<grey_pixel> a(n), b(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      a[i].level = std::uint8_t(3 * i);
+      b[i].level = std::uint8_t(255 - 2 * i);
+    }
+    const std::vector<grey_pixel> a0 = a;
+    color_mix(a, b, a, 0.5f);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      assert(a[i].level == (a0[i].level + b[i].level + 1) / 2 && "grey color_mix in place");
+    }
+  }
 
-  Q2.6  En utilisant le concept pixel, implémenter une fonction to_grey qui convertit
-        n'importe quel pixel en grey_pixel. La conversion RGB vers niveau de gris
-        consiste à effectue la moyenne des composant R,G,B pondéré par le niveau 
-        de Alpha. Quelle remarque avez vous sur les performances de cette fonction ?
-**/
+  // rgba : meme expression que color_mix pixel par pixel
+  {
+    const std::size_t n = 37;
+    std::vector<rgba_pixel> a, b, dst(n, rgba_pixel{ 0.f, 0.f, 0.f, 0.f });
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const float t = float(i) / float(n);
+      a.push_back(rgba_pixel{ t, 1.f - t, t * t, 1.f });
+      b.push_back(rgba_pixel{ 1.f - t, t / 2, 0.5f, t });
+    }
+    color_mix(a, b, dst, 0.3f);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      [[maybe_unused]] const rgba_pixel ref = color_mix(a[i], b[i], 0.3f);
+      assert(std::abs(dst[i].red() - ref.red()) < 1e-6f && std::abs(dst[i].green() - ref.green()) < 1e-6f
+             && std::abs(dst[i].blue() - ref.blue()) < 1e-6f && std::abs(dst[i].alpha() - ref.alpha()) < 1e-6f
+             && "rgba color_mix buffer vs pixel");
+    }
+  }
 
-// Q2.1
-struct grey_pixel
-{
-  std::uint8_t level;
-};
+  //--------------------------------------------------------------------------
+  // 3) to_grey sur des buffers entiers
+  //--------------------------------------------------------------------------
 
-struct rgb_pixel
-{
-  std::uint8_t r,g,b;
-};
+  // grey : copie, ou rien en place
+  {
+    std::vector<grey_pixel> a(50), dst(50);
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+      a[i].level = std::uint8_t(5 * i);
+    }
+    to_grey(a, dst);
+    to_grey(a, a);
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+      assert(dst[i].level == 5 * i && a[i].level == 5 * i && "grey to_grey");
+      assert(to_grey(a[i]).level == a[i].level && "per-pixel grey to_grey");
+    }
+  }
 
-class rgba_pixel
-{
-  public:
-  rgba_pixel(float rr, float gg, float bb, float aa)
-            : r(rr), g(gg), b(bb), a(aa)
+  // rgb : arrondi de la somme pondérée exacte, pour chaque jeu de poids
+  for (std::size_t n : { 0, 3, 16, 17, 50, 1000 })
   {
-    assert(r >= 0.f && r<=1.f);
-    assert(g >= 0.f && g<=1.f);
-    assert(b >= 0.f && b<=1.f);
-    assert(a >= 0.f && b<=1.f);
+    const std::vector<rgb_pixel> a = test_rgb(n, 7);
+    std::vector<grey_pixel> dst(n);
+    for (luma_weights w : { luma_average, luma_rec601, luma_rec709 })
+    {
+      to_grey(a, dst, w);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        [[maybe_unused]] const float exact = a[i].r * w.r + a[i].g * w.g + a[i].b * w.b;
+        assert(std::abs(dst[i].level - exact) <= 0.53f && "rgb to_grey buffer");
+      }
+    }
+    to_grey(a, dst);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      assert(std::abs(dst[i].level - to_grey(a[i]).level) <= 1 && "rgb to_grey buffer vs pixel");
+    }
   }
 
-  float red()   const { return r; }
-  float green() const { return g; }
-  float blue()  const { return b; }
-  float alpha() const { return a; }
+  // Gris pur et extrêmes : exacts quels que soient les poids
+  {
+    const std::vector<rgb_pixel> a = { { 0, 0, 0 }, { 255, 255, 255 }, { 128, 128, 128 } };
+    std::vector<grey_pixel> dst(a.size());
+    to_grey(std::span<const rgb_pixel>(a), dst, luma_rec709);
+    assert(dst[0].level == 0 && dst[1].level == 255 && dst[2].level == 128 && "rgb to_grey of greys");
+  }
 
-  private:
-  float r,g,b,a;
-};
+  // rgba : composantes ramenées sur [0, 255] et pondérées par alpha
+  {
+    const std::size_t n = 23;
+    std::vector<rgba_pixel> a;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const float t = float(i) / float(n - 1);
+      a.push_back(rgba_pixel{ t, 1.f - t, 0.5f, i % 2 ? 1.f : 0.5f });
+    }
+    std::vector<grey_pixel> dst(n);
+    to_grey(a, dst, luma_rec601);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      [[maybe_unused]] const float exact = 255.f * a[i].alpha()
+                          * (a[i].red() * 0.299f + a[i].green() * 0.587f + a[i].blue() * 0.114f);
+      assert(std::abs(dst[i].level - exact) <= 0.5f + 1e-3f && "rgba to_grey buffer");
+    }
+  }
 
-// Q2.2
-grey_pixel color_mix(grey_pixel a, grey_pixel b, float ratio)
-{
-  std::uint8_t v = a.level*ratio + b.level*(1.f-ratio);
-  return grey_pixel{ v };
-}
+  //--------------------------------------------------------------------------
+  // 4) Images entrelacées et planaires
+  //--------------------------------------------------------------------------
 
-rgb_pixel color_mix(rgb_pixel a, rgb_pixel b, float ratio)
-{
-  std::uint8_t vr = a.r*ratio + b.r*(1.f-ratio);
-  std::uint8_t vg = a.g*ratio + b.g*(1.f-ratio);
-  std::uint8_t vb = a.b*ratio + b.b*(1.f-ratio);
-  return rgb_pixel{ vr, vg, vb };
-}
+  // Plans alignés et complétés par des zéros, accès aux pixels
+  {
+    const std::vector<rgb_pixel> p = test_rgb(7 * 5, 3);
+    const planar_image<rgb_pixel> img(7, 5, p);
+    assert(img.width() == 7 && img.height() == 5 && img.size() == 35);
+    assert(img.plane_stride() == 64 && img.raw().size() == 3 * 64 && "planar padding");
+    for (std::size_t c = 0; c < 3; ++c)
+    {
+      assert(reinterpret_cast<std::uintptr_t>(img.plane(c).data()) % 64 == 0 && "aligned planes");
+      for (std::size_t i = 35; i < 64; ++i)
+      {
+        assert(img.raw()[c * 64 + i] == 0 && "zero padding");
+      }
+    }
+    for (std::size_t y = 0; y < 5; ++y)
+    {
+      for (std::size_t x = 0; x < 7; ++x)
+      {
+        [[maybe_unused]] const rgb_pixel q = img.at(x, y), r = p[y * 7 + x];
+        assert(q.r == r.r && q.g == r.g && q.b == r.b && "planar at");
+        assert(img.plane(1)[y * 7 + x] == r.g && "planar plane");
+      }
+    }
 
-rgba_pixel color_mix(rgba_pixel a, rgba_pixel b, float ratio)
-{
-  float vr = a.red()*ratio + b.red()*(1.f-ratio);
-  float vg = a.green()*ratio + b.green()*(1.f-ratio);
-  float vb = a.blue()*ratio + b.blue()*(1.f-ratio);
-  float va = a.alpha()*ratio + b.alpha()*(1.f-ratio);
-  return rgba_pixel{ vr, vg, vb, va };
-}
+    image<rgb_pixel> copy(7, 5);
+    copy.set(6, 4, rgb_pixel{ 1, 2, 3 });
+    assert(copy.pixels()[34].g == 2 && copy.at(6, 4).b == 3 && "interleaved set");
+  }
 
-// Q2.3
-template<typename T>
-concept pixel = requires(T const& p, int i)
-{
-  { red(p)   };
-  { green(p) };
-  { blue(p)  };
-  { alpha(p) };
-};
-
-// Q2.4
-auto red(grey_pixel const& a)     { return a.level; }
-auto green(grey_pixel const& a)   { return a.level; }
-auto blue(grey_pixel const& a)    { return a.level; }
-auto alpha(grey_pixel const& a)   { return 1.f;     }
-
-auto red(rgb_pixel const& a)     { return a.r; }
-auto green(rgb_pixel const& a)   { return a.g; }
-auto blue(rgb_pixel const& a)    { return a.b; }
-auto alpha(rgb_pixel const& a)   { return 1.f; }
-
-auto red(rgba_pixel const& a)     { return a.red();   }
-auto green(rgba_pixel const& a)   { return a.green(); }
-auto blue(rgba_pixel const& a)    { return a.blue();  }
-auto alpha(rgba_pixel const& a)   { return a.alpha(); }
-
-// Q2.5
-template<pixel P1, pixel P2>
-rgba_pixel color_mix(P1 a, P2 b, float ratio)
-{
-  float vr = red(a)*ratio   + red(b)*(1.f-ratio);
-  float vg = green(a)*ratio + green(b)*(1.f-ratio);
-  float vb = blue(a)*ratio  + blue(b)*(1.f-ratio);
-  float va = alpha(a)*ratio + alpha(b)*(1.f-ratio);
-  return rgba_pixel{ vr, vg, vb, va };
-}
+  // Aller-retour entre les deux dispositions
+  for (std::size_t n : { 1, 15, 16, 47, 300 })
+  {
+    const std::vector<rgb_pixel> p = test_rgb(n, 11);
+    const image<rgb_pixel> a(n, 1, p);
+    const planar_image<rgb_pixel> b = to_planar(a);
+    const image<rgb_pixel> c = to_interleaved(b);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      assert(b.plane(0)[i] == p[i].r && b.plane(1)[i] == p[i].g && b.plane(2)[i] == p[i].b && "to_planar");
+      assert(c.pixels()[i].r == p[i].r && c.pixels()[i].g == p[i].g && c.pixels()[i].b == p[i].b
+             && "to_interleaved");
+    }
 
-// Q2.6
-// Reponse: Ca semble non-optimal pour P == grey_pixel
-template<pixel P> grey_pixel to_grey(P a)
-{
-  std::uint8_t v = (red(a) + green(a) + blue(a))*alpha(a)/3;
-  return grey_pixel{ v };
-}
+    // Réutilisation sans allocation
+    planar_image<rgb_pixel> reuse(n, 1);
+    reuse.assign(test_rgb(n, 99));
+    reuse.assign(p);
+    std::vector<rgb_pixel> back(n);
+    reuse.store(back);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      assert(back[i].r == p[i].r && back[i].g == p[i].g && back[i].b == p[i].b && "assign / store");
+    }
 
-int main()
-{
+    std::vector<rgba_pixel> f;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      f.push_back(rgba_pixel{ p[i].r / 255.f, p[i].g / 255.f, p[i].b / 255.f, (i % 5) / 4.f });
+    }
+    const planar_image<rgba_pixel> fb(n, 1, f);
+    const image<rgba_pixel> fc = to_interleaved(fb);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      assert(fb.plane(3)[i] == f[i].alpha() && fb.at(i, 0).blue() == f[i].blue() && "rgba to_planar");
+      assert(fc.pixels()[i].red() == f[i].red() && fc.pixels()[i].alpha() == f[i].alpha() && "rgba to_interleaved");
+    }
+  }
+
+  // color_mix et to_grey sur les plans : mêmes résultats qu'en entrelacé
+  {
+    const std::size_t w = 37, h = 9;
+    const image<rgb_pixel> a(w, h, test_rgb(w * h, 1)), b(w, h, test_rgb(w * h, 2));
+    image<rgb_pixel> mixed(w, h);
+    color_mix(a, b, mixed, 0.3f);
+    const planar_image<rgb_pixel> pa = to_planar(a), pb = to_planar(b);
+    planar_image<rgb_pixel> pmixed(w, h);
+    color_mix(pa, pb, pmixed, 0.3f);
+    image<grey_pixel> grey(w, h);
+    planar_image<grey_pixel> pgrey(w, h);
+    to_grey(mixed, grey, luma_rec709);
+    to_grey(pmixed, pgrey, luma_rec709);
+    for (std::size_t y = 0; y < h; ++y)
+    {
+      for (std::size_t x = 0; x < w; ++x)
+      {
+        [[maybe_unused]] const rgb_pixel m = mixed.at(x, y), pm = pmixed.at(x, y);
+        assert(m.r == pm.r && m.g == pm.g && m.b == pm.b && "planar color_mix");
+        assert(grey.at(x, y).level == pgrey.at(x, y).level && "planar rgb to_grey");
+      }
+    }
+    for (std::size_t i = w * h; i < pmixed.plane_stride(); ++i)
+    {
+      assert(pmixed.raw()[i] == 0 && "color_mix keeps the padding at zero");
+    }
+
+    std::vector<rgba_pixel> f;
+    for (std::size_t i = 0; i < w * h; ++i)
+    {
+      f.push_back(rgba_pixel{ (i % 7) / 6.f, (i % 11) / 10.f, (i % 13) / 12.f, (i % 3) / 2.f });
+    }
+    const image<rgba_pixel> fa(w, h, f);
+    const planar_image<rgba_pixel> pfa = to_planar(fa);
+    to_grey(fa, grey, luma_rec601);
+    to_grey(pfa, pgrey, luma_rec601);
+    for (std::size_t i = 0; i < w * h; ++i)
+    {
+      assert(grey.pixels()[i].level == pgrey.plane(0)[i] && "planar rgba to_grey");
+    }
+    planar_image<grey_pixel> pgrey2(w, h);
+    to_grey(pgrey, pgrey2);
+    assert(pgrey2.at(5, 3).level == pgrey.at(5, 3).level && "planar grey to_grey");
+  }
+
+  //--------------------------------------------------------------------------
+  // 5) Pixels rgba compacts
+  //--------------------------------------------------------------------------
+
+  // Demi-précision : aller-retour exact de tous les motifs (hors NaN), et
+  // arrondi au plus proche pair des flottants
+  {
+    for (std::uint32_t h = 0; h < 0x10000; ++h)
+    {
+      const float f = detail::half_to_float(std::uint16_t(h));
+      if (f == f)
+      {
+        assert(detail::float_to_half(f) == h && "half round trip");
+      }
+    }
+    static_assert(detail::float_to_half(1.f) == 0x3c00 && detail::float_to_half(-2.f) == 0xc000);
+    static_assert(detail::float_to_half(65504.f) == 0x7bff && detail::float_to_half(65520.f) == 0x7c00);
+    static_assert(detail::float_to_half(0x1p-24f) == 0x0001 && detail::float_to_half(0x1p-25f) == 0x0000);
+    static_assert(detail::float_to_half(1.f + 0x1p-11f) == 0x3c00 && detail::float_to_half(1.f + 0x3p-11f) == 0x3c02);
+    static_assert(detail::half_to_float(0x3555) == 0x1.554p-2f);
+
+    // Comparaison avec les conversions matérielles sur des flottants quelconques
+    std::vector<float> f;
+    for (std::uint32_t k = 0; k < 100000; ++k)
+    {
+      const float x = std::bit_cast<float>(k * 2654435761u);
+      f.push_back(x == x ? x : 0.f);
+    }
+    std::vector<std::uint16_t> h(f.size());
+    detail::float_to_half(f.data(), h.data(), f.size());
+    std::vector<float> back(f.size());
+    detail::half_to_unit(h.data(), back.data(), f.size());
+    for (std::size_t i = 0; i < f.size(); ++i)
+    {
+      assert(h[i] == detail::float_to_half(f[i]) && "bulk float_to_half");
+      assert(back[i] == detail::clamp_unit(detail::half_to_float(h[i])) && "bulk half_to_unit");
+    }
+  }
+
+  // Conversions des pixels, un par un et en bloc
+  for (std::size_t n : { 1, 3, 4, 17, 100 })
+  {
+    std::vector<rgba_pixel> f;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      f.push_back(rgba_pixel{ (i % 256) / 255.f, (i % 7) / 6.f, 0.2f, (i % 3) / 2.f });
+    }
+    std::vector<rgba8_pixel> p8(n);
+    std::vector<rgba16f_pixel> p16(n);
+    to_rgba8(f, p8);
+    to_rgba16f(f, p16);
+    std::vector<rgba_pixel> f8(n, rgba_pixel{ 0.f, 0.f, 0.f, 0.f }), f16 = f8;
+    to_rgba(p8, f8);
+    to_rgba(p16, f16);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      [[maybe_unused]] const rgba8_pixel q8 = to_rgba8(f[i]);
+      assert(p8[i].r == q8.r && p8[i].g == q8.g && p8[i].b == q8.b && p8[i].a == q8.a && "bulk to_rgba8");
+      assert(p8[i].r == i % 256 && p8[i].b == 51 && "to_rgba8 rounding");
+      [[maybe_unused]] const rgba16f_pixel q16 = to_rgba16f(f[i]);
+      assert(p16[i].r == q16.r && p16[i].g == q16.g && p16[i].a == q16.a && "bulk to_rgba16f");
+
+      assert(f8[i].red() == red(p8[i]) && f8[i].alpha() == to_rgba(p8[i]).alpha() && "bulk rgba8 to_rgba");
+      assert(std::abs(f8[i].green() - f[i].green()) <= 0.5f / 255 + 1e-6f && "rgba8 precision");
+      assert(f16[i].blue() == blue(p16[i]) && "bulk rgba16f to_rgba");
+      assert(std::abs(f16[i].green() - f[i].green()) <= 0x1p-12f && "rgba16f precision");
+    }
+  }
+
+  // color_mix et to_grey sur les pixels compacts
+  {
+    const std::size_t n = 600;
+    std::vector<rgba_pixel> fa, fb;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      fa.push_back(rgba_pixel{ (i % 11) / 10.f, (i % 5) / 4.f, 1.f, (i % 4) / 3.f });
+      fb.push_back(rgba_pixel{ 0.25f, (i % 9) / 8.f, (i % 2) * 1.f, 1.f });
+    }
+    std::vector<rgba_pixel> fmix(n, rgba_pixel{ 0.f, 0.f, 0.f, 0.f });
+    color_mix(fa, fb, fmix, 0.6f);
 
-// Il manque les tests unitaires, je mettrai peut-être à jour ce fichier plus tard, désolé !
+    std::vector<rgba8_pixel> a8(n), b8(n), mix8(n);
+    to_rgba8(fa, a8);
+    to_rgba8(fb, b8);
+    color_mix(a8, b8, mix8, 0.6f);
+    std::vector<rgba16f_pixel> a16(n), b16(n), mix16(n);
+    to_rgba16f(fa, a16);
+    to_rgba16f(fb, b16);
+    color_mix(a16, b16, mix16, 0.6f);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      assert(std::abs(red(mix8[i]) - fmix[i].red()) <= 1.5f / 255 && "rgba8 color_mix");
+      assert(std::abs(alpha(mix16[i]) - fmix[i].alpha()) <= 0x1p-10f && "rgba16f color_mix");
+    }
 
-}
\ No newline at end of file
+    std::vector<grey_pixel> g(n), g8(n), g16(n);
+    std::vector<rgba_pixel> back(n, rgba_pixel{ 0.f, 0.f, 0.f, 0.f });
+    to_grey(fa, g, luma_rec709);
+    to_grey(a8, g8, luma_rec709);
+    to_grey(a16, g16, luma_rec709);
+    to_rgba(a8, back);
+    std::vector<grey_pixel> gback(n);
+    to_grey(back, gback, luma_rec709);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      assert(g8[i].level == gback[i].level && "rgba8 to_grey goes through rgba_pixel");
+      assert(std::abs(g8[i].level - g[i].level) <= 1 && std::abs(g16[i].level - g[i].level) <= 1
+             && "compact to_grey");
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  // 6) Pipelines fusionnés
+  //--------------------------------------------------------------------------
+
+  // Mélange, lambda puis niveaux de gris : même résultat que les trois
+  // passes séparées, en séquentiel comme en parallèle, sur des tailles qui
+  // ne sont multiples ni des tuiles ni des tâches
+  {
+    thread_pool pool(4);
+    const auto drop_blue = [](rgb_pixel p) { return rgb_pixel{ p.r, p.g, std::uint8_t(p.b / 4) }; };
+    for (std::size_t n : { 0, 1, 100, 5441, 100003 })
+    {
+      const std::vector<rgb_pixel> src = test_rgb(n, 7), other = test_rgb(n, 99);
+      std::vector<rgb_pixel> tmp(n);
+      std::vector<grey_pixel> expected(n);
+      color_mix(src, other, tmp, 0.3f);
+      for (auto& p : tmp)
+      {
+        p = drop_blue(p);
+      }
+      to_grey(tmp, expected, luma_rec601);
+
+      const auto p = pipeline<rgb_pixel>{}.color_mix(other, 0.3f).map(drop_blue).to_grey(luma_rec601);
+      static_assert(std::is_same_v<decltype(p)::output_type, grey_pixel>);
+      std::vector<grey_pixel> seq(n), par(n), def(n);
+      p.run(execution::seq, src, seq);
+      p.run(execution::par.on(pool), src, par);
+      p.run(src, def);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        assert(seq[i].level == expected[i].level && "sequential pipeline");
+        assert(par[i].level == expected[i].level && def[i].level == expected[i].level && "parallel pipeline");
+      }
+
+      // Sur place, quand l'entrée et la sortie ont le même type
+      std::vector<rgb_pixel> inplace = src;
+      pipeline<rgb_pixel>{}.color_mix(other, 0.3f).map(drop_blue).run(execution::par.on(pool), inplace, inplace);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        assert(inplace[i].r == tmp[i].r && inplace[i].g == tmp[i].g && inplace[i].b == tmp[i].b
+               && "in-place pipeline");
+      }
+    }
+  }
+
+  // Changements de type par les lambdas, pixels compacts et images
+  {
+    const std::size_t w = 211, h = 67;
+    const std::vector<rgb_pixel> rgb = test_rgb(w * h, 3);
+    std::vector<rgba8_pixel> veil(w * h);
+    for (std::size_t i = 0; i < veil.size(); ++i)
+    {
+      veil[i] = rgba8_pixel{ 255, 255, 255, std::uint8_t(i) };
+    }
+    const auto opaque = [](rgb_pixel p) { return rgba8_pixel{ p.r, p.g, p.b, 255 }; };
+    const auto unpack = [](rgba8_pixel p) { return to_rgba(p); };
+
+    std::vector<rgba8_pixel> a(w * h);
+    std::vector<rgba_pixel> f(w * h, rgba_pixel{ 0.f, 0.f, 0.f, 0.f });
+    std::vector<grey_pixel> expected(w * h);
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+      a[i] = opaque(rgb[i]);
+    }
+    color_mix(a, veil, a, 0.5f);
+    to_rgba(a, f);
+    to_grey(f, expected);
+
+    const image<rgb_pixel> src(w, h, rgb);
+    image<grey_pixel> dst(w, h);
+    pipeline<rgb_pixel>{}.map(opaque).color_mix(veil, 0.5f).map(unpack).to_grey().run(src, dst);
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+      assert(dst.pixels()[i].level == expected[i].level && "pipeline with type changes");
+    }
+
+    // Sans étape, le pipeline copie
+    image<rgb_pixel> copy(w, h);
+    pipeline<rgb_pixel>{}.run(execution::seq, src, copy);
+    assert(copy.at(w - 1, h - 1).r == rgb.back().r && copy.at(3, 2).b == rgb[2 * w + 3].b && "empty pipeline");
+  }
+
+  // Les exceptions des lambdas remontent à l'appelant
+  {
+    thread_pool pool(3);
+    const std::vector<rgb_pixel> src = test_rgb(50000, 1);
+    std::vector<rgb_pixel> dst(src.size());
+    const auto p = pipeline<rgb_pixel>{}.map([](rgb_pixel p) {
+      if (p.r == 0)
+      {
+        throw std::runtime_error("no red");
+      }
+      return p;
+    });
+    [[maybe_unused]] bool thrown = false;
+    try
+    {
+      p.run(execution::par.on(pool), src, dst);
+    }
+    catch (const std::runtime_error&)
+    {
+      thrown = true;
+    }
+    assert(thrown && "pipeline should rethrow stage exceptions");
+  }
+
+  //--------------------------------------------------------------------------
+  // S'il n'y a eu aucune erreur
+  //--------------------------------------------------------------------------
+
+  std::cout << "Tous les tests se sont déroulés avec succès !" << std::endl;
+  return 0;
+}
@@ -0,0 +1,558 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "03_corr_concepts_impl.hpp"
+#include "03_corr_concepts_simd.hpp"
+
+// Images of pixels, interleaved or planar
+//
+// image<P, image_layout::interleaved> stores width * height pixels P one
+// after the other (an array of structs, what a std::vector<P> holds), and
+// image<P, image_layout::planar> one plane per channel (a struct of arrays):
+// the r, g and b planes of an rgb image hold width * height bytes each. Every
+// plane starts on a 64-byte boundary and is padded with zeros up to the next
+// one, so that channel-wise loops run on whole aligned vectors with no
+// shuffles.
+//
+// to_planar and to_interleaved convert between the layouts with SIMD
+// (de)interleaving; assign() and store() do the same into existing images or
+// buffers, without allocating. color_mix and to_grey take images of either layout and
+// run on the raw channels: planar rgb and rgba images need no deinterleaving,
+// and give the same results as the interleaved ones.
+
+enum class image_layout { interleaved, planar };
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+// Storage
+//------------------------------------------------------------------------------
+
+inline constexpr std::size_t image_alignment = 64;
+
+// Zero-initialized channels, 64-byte aligned
+template <typename C> class channel_buffer {
+	public:
+	channel_buffer() = default;
+
+	explicit channel_buffer(std::size_t count) : channel_buffer(count, std::false_type{}) {
+		if (count != 0) {
+			std::memset(data_, 0, count * sizeof(C));
+		}
+	}
+
+	// Left uninitialized, for callers that write every channel
+	channel_buffer(std::size_t count, std::false_type) : size_(count) {
+		if (count != 0) {
+			data_ = static_cast<C*>(::operator new(count * sizeof(C), std::align_val_t{image_alignment}));
+		}
+	}
+
+	channel_buffer(const channel_buffer& other) : channel_buffer(other.size_, std::false_type{}) {
+		if (size_ != 0) {
+			std::memcpy(data_, other.data_, size_ * sizeof(C));
+		}
+	}
+
+	channel_buffer(channel_buffer&& other) noexcept
+		: data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+	channel_buffer& operator=(channel_buffer other) noexcept {
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+		return *this;
+	}
+
+	~channel_buffer() {
+		if (data_) {
+			::operator delete(data_, std::align_val_t{image_alignment});
+		}
+	}
+
+	C* data() { return data_; }
+	const C* data() const { return data_; }
+	std::size_t size() const { return size_; }
+
+	private:
+	C* data_ = nullptr;
+	std::size_t size_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// Splitting interleaved pixels into planes and merging them back
+//------------------------------------------------------------------------------
+
+// pshufb masks: merge[m][c] places channel c of 16 planar rgb pixels in the
+// m-th 16-byte store of the interleaved pixels (-128 zeroes a byte)
+struct rgb_merge_masks {
+	alignas(16) std::int8_t merge[3][3][16];
+};
+
+constexpr rgb_merge_masks make_rgb_merge_masks() {
+	rgb_merge_masks result{};
+	for (int m = 0; m < 3; ++m) {
+		for (int c = 0; c < 3; ++c) {
+			for (int k = 0; k < 16; ++k) {
+				const int byte = 16 * m + k;
+				result.merge[m][c][k] = static_cast<std::int8_t>(byte % 3 == c ? byte / 3 : -128);
+			}
+		}
+	}
+	return result;
+}
+
+inline constexpr rgb_merge_masks rgb_merge = make_rgb_merge_masks();
+
+// planes[c][i] = src[3 * i + c]
+inline void split_u8x3(const std::uint8_t* src, std::uint8_t* const planes[3], std::size_t n) {
+	std::size_t i = 0;
+#if defined(__SSSE3__)
+	for (; i + 16 <= n; i += 16) {
+		__m128i x[3];
+		for (int k = 0; k < 3; ++k) {
+			x[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i + 16 * k));
+		}
+		for (int c = 0; c < 3; ++c) {
+			const auto* m = reinterpret_cast<const __m128i*>(deinterleave.rgb_ssse3[c]);
+			const __m128i y = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x[0], _mm_load_si128(m)),
+			                                            _mm_shuffle_epi8(x[1], _mm_load_si128(m + 1))),
+			                               _mm_shuffle_epi8(x[2], _mm_load_si128(m + 2)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(planes[c] + i), y);
+		}
+	}
+#endif
+	for (; i < n; ++i) {
+		const std::uint8_t* p = src + 3 * i;
+		for (int c = 0; c < 3; ++c) {
+			planes[c][i] = p[c];
+		}
+	}
+}
+
+// dst[3 * i + c] = planes[c][i]
+inline void merge_u8x3(const std::uint8_t* const planes[3], std::uint8_t* dst, std::size_t n) {
+	std::size_t i = 0;
+#if defined(__SSSE3__)
+	for (; i + 16 <= n; i += 16) {
+		__m128i x[3];
+		for (int c = 0; c < 3; ++c) {
+			x[c] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[c] + i));
+		}
+		for (int k = 0; k < 3; ++k) {
+			const auto* m = reinterpret_cast<const __m128i*>(rgb_merge.merge[k]);
+			const __m128i y = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x[0], _mm_load_si128(m)),
+			                                            _mm_shuffle_epi8(x[1], _mm_load_si128(m + 1))),
+			                               _mm_shuffle_epi8(x[2], _mm_load_si128(m + 2)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * i + 16 * k), y);
+		}
+	}
+#endif
+	for (; i < n; ++i) {
+		std::uint8_t* p = dst + 3 * i;
+		for (int c = 0; c < 3; ++c) {
+			p[c] = planes[c][i];
+		}
+	}
+}
+
+// 4x4 transposes between 4 interleaved float pixels and 4 lanes of 4 planes
+// (the transpose is its own inverse)
+inline void split_f32x4(const float* src, float* const planes[4], std::size_t n) {
+	std::size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+	for (; i + 4 <= n; i += 4) {
+		__m128 x[4];
+		for (int k = 0; k < 4; ++k) {
+			x[k] = _mm_loadu_ps(src + 4 * (i + k));
+		}
+		_MM_TRANSPOSE4_PS(x[0], x[1], x[2], x[3]);
+		for (int c = 0; c < 4; ++c) {
+			_mm_storeu_ps(planes[c] + i, x[c]);
+		}
+	}
+#endif
+	for (; i < n; ++i) {
+		const float* p = src + 4 * i;
+		for (int c = 0; c < 4; ++c) {
+			planes[c][i] = p[c];
+		}
+	}
+}
+
+inline void merge_f32x4(const float* const planes[4], float* dst, std::size_t n) {
+	std::size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+	for (; i + 4 <= n; i += 4) {
+		__m128 x[4];
+		for (int c = 0; c < 4; ++c) {
+			x[c] = _mm_loadu_ps(planes[c] + i);
+		}
+		_MM_TRANSPOSE4_PS(x[0], x[1], x[2], x[3]);
+		for (int k = 0; k < 4; ++k) {
+			_mm_storeu_ps(dst + 4 * (i + k), x[k]);
+		}
+	}
+#endif
+	for (; i < n; ++i) {
+		float* p = dst + 4 * i;
+		for (int c = 0; c < 4; ++c) {
+			p[c] = planes[c][i];
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Grey levels from planes
+//------------------------------------------------------------------------------
+
+// Same weights and rounding as luma_u8, without the deinterleaving
+inline void luma_planes_u8(const std::uint8_t* r, const std::uint8_t* g, const std::uint8_t* b, std::uint8_t* dst,
+                           std::size_t n, luma_weights w) {
+	constexpr int one = luma_fixed_one;
+	const auto [wr, wg, wb] = luma_fixed_weights(w);
+	const std::int32_t wrg = static_cast<std::uint16_t>(wr) | (static_cast<std::int32_t>(wg) << 16);
+	const std::int32_t wbh = static_cast<std::uint16_t>(wb) | ((one / 2) << 16);
+	std::size_t i = 0;
+	// The unpacks and packs work within 128-bit lanes and undo each other, so
+	// the grey levels come out in pixel order
+#if defined(__AVX512BW__)
+	const __m512i vrg = _mm512_set1_epi32(wrg), vbh = _mm512_set1_epi32(wbh);
+	const __m512i ones = _mm512_set1_epi16(1), zero = _mm512_setzero_si512();
+	const auto weigh = [&](__m512i r16, __m512i g16, __m512i b16) {
+		// Zero-masked shift: GCC 12 flags the undefined passthrough of the
+		// unmasked one as maybe-uninitialized
+		const auto half = [&](__m512i rg, __m512i bh) {
+			const __m512i y = _mm512_add_epi32(_mm512_madd_epi16(rg, vrg), _mm512_madd_epi16(bh, vbh));
+			return _mm512_maskz_srli_epi32(0xFFFF, y, 14);
+		};
+		return _mm512_packs_epi32(half(_mm512_unpacklo_epi16(r16, g16), _mm512_unpacklo_epi16(b16, ones)),
+		                          half(_mm512_unpackhi_epi16(r16, g16), _mm512_unpackhi_epi16(b16, ones)));
+	};
+	for (; i + 64 <= n; i += 64) {
+		const __m512i x = _mm512_loadu_si512(r + i), y = _mm512_loadu_si512(g + i), z = _mm512_loadu_si512(b + i);
+		const __m512i lo = weigh(_mm512_unpacklo_epi8(x, zero), _mm512_unpacklo_epi8(y, zero),
+		                         _mm512_unpacklo_epi8(z, zero));
+		const __m512i hi = weigh(_mm512_unpackhi_epi8(x, zero), _mm512_unpackhi_epi8(y, zero),
+		                         _mm512_unpackhi_epi8(z, zero));
+		_mm512_storeu_si512(dst + i, _mm512_packus_epi16(lo, hi));
+	}
+#elif defined(__AVX2__)
+	const __m256i vrg = _mm256_set1_epi32(wrg), vbh = _mm256_set1_epi32(wbh);
+	const __m256i ones = _mm256_set1_epi16(1), zero = _mm256_setzero_si256();
+	const auto weigh = [&](__m256i r16, __m256i g16, __m256i b16) {
+		const auto half = [&](__m256i rg, __m256i bh) {
+			return _mm256_srli_epi32(_mm256_add_epi32(_mm256_madd_epi16(rg, vrg), _mm256_madd_epi16(bh, vbh)), 14);
+		};
+		return _mm256_packs_epi32(half(_mm256_unpacklo_epi16(r16, g16), _mm256_unpacklo_epi16(b16, ones)),
+		                          half(_mm256_unpackhi_epi16(r16, g16), _mm256_unpackhi_epi16(b16, ones)));
+	};
+	for (; i + 32 <= n; i += 32) {
+		const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + i));
+		const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(g + i));
+		const __m256i z = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+		const __m256i lo = weigh(_mm256_unpacklo_epi8(x, zero), _mm256_unpacklo_epi8(y, zero),
+		                         _mm256_unpacklo_epi8(z, zero));
+		const __m256i hi = weigh(_mm256_unpackhi_epi8(x, zero), _mm256_unpackhi_epi8(y, zero),
+		                         _mm256_unpackhi_epi8(z, zero));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	const __m128i vrg = _mm_set1_epi32(wrg), vbh = _mm_set1_epi32(wbh);
+	const __m128i ones = _mm_set1_epi16(1), zero = _mm_setzero_si128();
+	const auto weigh = [&](__m128i r16, __m128i g16, __m128i b16) {
+		const auto half = [&](__m128i rg, __m128i bh) {
+			return _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(rg, vrg), _mm_madd_epi16(bh, vbh)), 14);
+		};
+		return _mm_packs_epi32(half(_mm_unpacklo_epi16(r16, g16), _mm_unpacklo_epi16(b16, ones)),
+		                       half(_mm_unpackhi_epi16(r16, g16), _mm_unpackhi_epi16(b16, ones)));
+	};
+	for (; i + 16 <= n; i += 16) {
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + i));
+		const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g + i));
+		const __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+		const __m128i lo = weigh(_mm_unpacklo_epi8(x, zero), _mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi8(z, zero));
+		const __m128i hi = weigh(_mm_unpackhi_epi8(x, zero), _mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi8(z, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; i < n; ++i) {
+		dst[i] = static_cast<std::uint8_t>((r[i] * wr + g[i] * wg + b[i] * wb + one / 2) >> 14);
+	}
+}
+
+// Same expression as luma_f32, without the deinterleaving
+inline void luma_planes_f32(const float* r, const float* g, const float* b, const float* a, std::uint8_t* dst,
+                            std::size_t n, luma_weights w) {
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	const __m512 vr = _mm512_set1_ps(w.r), vg = _mm512_set1_ps(w.g), vb = _mm512_set1_ps(w.b);
+	const __m512 scale = _mm512_set1_ps(255.f);
+	for (; i + 16 <= n; i += 16) {
+		__m512 y = _mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(r + i), vr), _mm512_mul_ps(_mm512_loadu_ps(g + i), vg));
+		y = _mm512_add_ps(y, _mm512_mul_ps(_mm512_loadu_ps(b + i), vb));
+		y = _mm512_mul_ps(_mm512_mul_ps(y, _mm512_loadu_ps(a + i)), scale);
+		// Zero-masked conversions, as in luma_f32
+		const __m512i q = _mm512_maskz_cvtps_epu32(0xFFFF, y);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm512_maskz_cvtusepi32_epi8(0xFFFF, q));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	const __m128 vr = _mm_set1_ps(w.r), vg = _mm_set1_ps(w.g), vb = _mm_set1_ps(w.b);
+	const __m128 scale = _mm_set1_ps(255.f);
+	const auto grey4 = [&](std::size_t k) {
+		__m128 y = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(r + k), vr), _mm_mul_ps(_mm_loadu_ps(g + k), vg));
+		y = _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(b + k), vb));
+		return _mm_cvtps_epi32(_mm_mul_ps(_mm_mul_ps(y, _mm_loadu_ps(a + k)), scale));
+	};
+	for (; i + 16 <= n; i += 16) {
+		const __m128i lo = _mm_packs_epi32(grey4(i), grey4(i + 4));
+		const __m128i hi = _mm_packs_epi32(grey4(i + 8), grey4(i + 12));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; i < n; ++i) {
+		const float y = (r[i] * w.r + g[i] * w.g + b[i] * w.b) * a[i] * 255.f;
+		dst[i] = static_cast<std::uint8_t>(std::clamp(std::lrint(y), 0l, 255l));
+	}
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// image
+//------------------------------------------------------------------------------
+
+template <typename P, image_layout Layout = image_layout::interleaved> class image {
+	public:
+	using pixel_type = P;
+	using channel_type = typename detail::pixel_layout<P>::channel;
+	static constexpr std::size_t channels = detail::pixel_layout<P>::channels;
+	static constexpr image_layout layout = Layout;
+
+	//--------------------------------------------------------------------------
+	// Constructors
+	//--------------------------------------------------------------------------
+
+	image() = default;
+
+	// width * height pixels with all channels at 0
+	image(std::size_t width, std::size_t height)
+		: width_(width), height_(height), stride_(padded(width * height)),
+		  data_(Layout == image_layout::planar ? channels * stride_ : channels * width * height) {}
+
+	// Copy of pixels, given row by row
+	image(std::size_t width, std::size_t height, std::span<const P> pixels)
+		: width_(width), height_(height), stride_(padded(width * height)),
+		  data_(Layout == image_layout::planar ? channels * stride_ : channels * width * height, std::false_type{}) {
+		assign(pixels);
+	}
+
+	//--------------------------------------------------------------------------
+	// Dimensions
+	//--------------------------------------------------------------------------
+
+	std::size_t width() const { return width_; }
+	std::size_t height() const { return height_; }
+	std::size_t size() const { return width_ * height_; }
+
+	// Elements from the start of a plane to the start of the next one
+	std::size_t plane_stride() const
+		requires(Layout == image_layout::planar)
+	{
+		return stride_;
+	}
+
+	//--------------------------------------------------------------------------
+	// Pixel access
+	//--------------------------------------------------------------------------
+
+	P at(std::size_t x, std::size_t y) const {
+		assert(x < width_ && y < height_ && "image index out of range");
+		std::array<channel_type, channels> c;
+		for (std::size_t k = 0; k < channels; ++k) {
+			c[k] = data_.data()[offset(x, y, k)];
+		}
+		return std::bit_cast<P>(c);
+	}
+
+	void set(std::size_t x, std::size_t y, const P& p) {
+		assert(x < width_ && y < height_ && "image index out of range");
+		const auto c = std::bit_cast<std::array<channel_type, channels>>(p);
+		for (std::size_t k = 0; k < channels; ++k) {
+			data_.data()[offset(x, y, k)] = c[k];
+		}
+	}
+
+	// The pixels, row by row
+	std::span<P> pixels()
+		requires(Layout == image_layout::interleaved)
+	{
+		return {reinterpret_cast<P*>(data_.data()), size()};
+	}
+
+	std::span<const P> pixels() const
+		requires(Layout == image_layout::interleaved)
+	{
+		return {reinterpret_cast<const P*>(data_.data()), size()};
+	}
+
+	// Channel c of every pixel, row by row (64-byte aligned)
+	std::span<channel_type> plane(std::size_t c)
+		requires(Layout == image_layout::planar)
+	{
+		assert(c < channels && "image plane out of range");
+		return {data_.data() + c * stride_, size()};
+	}
+
+	std::span<const channel_type> plane(std::size_t c) const
+		requires(Layout == image_layout::planar)
+	{
+		assert(c < channels && "image plane out of range");
+		return {data_.data() + c * stride_, size()};
+	}
+
+	// Every channel in storage order, plane padding included
+	std::span<channel_type> raw() { return {data_.data(), data_.size()}; }
+	std::span<const channel_type> raw() const { return {data_.data(), data_.size()}; }
+
+	//--------------------------------------------------------------------------
+	// Layout conversion
+	//--------------------------------------------------------------------------
+
+	// Overwrites the image with pixels, given row by row, without allocating
+	void assign(std::span<const P> pixels) {
+		assert(pixels.size() == size() && "image size mismatch");
+		const channel_type* src = detail::channel_data(pixels.data());
+		channel_type* out = data_.data();
+		if constexpr (Layout == image_layout::interleaved || channels == 1) {
+			if (!pixels.empty()) {
+				std::memcpy(out, src, pixels.size_bytes());
+			}
+		} else {
+			channel_type* planes[channels];
+			for (std::size_t c = 0; c < channels; ++c) {
+				planes[c] = out + c * stride_;
+			}
+			if constexpr (channels == 3) {
+				detail::split_u8x3(src, planes, size());
+			} else {
+				detail::split_f32x4(src, planes, size());
+			}
+		}
+		if constexpr (Layout == image_layout::planar) {
+			for (std::size_t c = 0; c < channels; ++c) {
+				std::fill(out + c * stride_ + size(), out + (c + 1) * stride_, channel_type{});
+			}
+		}
+	}
+
+	// Writes the interleaved pixels to dst
+	void store(std::span<P> dst) const
+		requires(Layout == image_layout::planar)
+	{
+		assert(dst.size() == size() && "image size mismatch");
+		auto* out = detail::channel_data(dst.data());
+		if constexpr (channels == 1) {
+			if (!dst.empty()) {
+				std::memcpy(out, data_.data(), dst.size_bytes());
+			}
+		} else {
+			const channel_type* planes[channels];
+			for (std::size_t c = 0; c < channels; ++c) {
+				planes[c] = data_.data() + c * stride_;
+			}
+			if constexpr (channels == 3) {
+				detail::merge_u8x3(planes, out, size());
+			} else {
+				detail::merge_f32x4(planes, out, size());
+			}
+		}
+	}
+
+	private:
+	// count channels rounded up to a multiple of 64 bytes
+	static std::size_t padded(std::size_t count) {
+		return (count * sizeof(channel_type) + detail::image_alignment - 1) / detail::image_alignment
+		       * detail::image_alignment / sizeof(channel_type);
+	}
+
+	std::size_t offset(std::size_t x, std::size_t y, std::size_t c) const {
+		if constexpr (Layout == image_layout::interleaved) {
+			return (y * width_ + x) * channels + c;
+		} else {
+			return c * stride_ + y * width_ + x;
+		}
+	}
+
+	std::size_t width_ = 0;
+	std::size_t height_ = 0;
+	std::size_t stride_ = 0;
+	detail::channel_buffer<channel_type> data_;
+};
+
+template <typename P> using planar_image = image<P, image_layout::planar>;
+
+//------------------------------------------------------------------------------
+// Layout conversion
+//------------------------------------------------------------------------------
+
+template <typename P> planar_image<P> to_planar(const image<P>& src) {
+	return planar_image<P>(src.width(), src.height(), src.pixels());
+}
+
+template <typename P> image<P> to_interleaved(const planar_image<P>& src) {
+	image<P> result(src.width(), src.height());
+	src.store(result.pixels());
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// Pixel operations on whole images
+//------------------------------------------------------------------------------
+
+// dst = a * ratio + b * (1 - ratio), channel by channel; dst may be a or b
+template <typename P, image_layout Layout>
+void color_mix(const image<P, Layout>& a, const image<P, Layout>& b, image<P, Layout>& dst, float ratio) {
+	assert(a.width() == b.width() && a.height() == b.height() && a.width() == dst.width()
+	       && a.height() == dst.height() && "color_mix size mismatch");
+	// The plane padding is zero in a and b, and stays so in dst
+	if constexpr (std::is_same_v<typename image<P, Layout>::channel_type, float>) {
+		assert(ratio >= 0.f && ratio <= 1.f && "color_mix ratio out of [0, 1]");
+		detail::mix_f32(a.raw().data(), b.raw().data(), dst.raw().data(), dst.raw().size(), ratio);
+	} else {
+		detail::mix_u8(a.raw().data(), b.raw().data(), dst.raw().data(), dst.raw().size(), detail::mix_weight(ratio));
+	}
+}
+
+// Grey levels of src, in an image of the same layout
+template <typename P, image_layout Layout>
+void to_grey(const image<P, Layout>& src, image<grey_pixel, Layout>& dst, luma_weights w = luma_average) {
+	assert(src.width() == dst.width() && src.height() == dst.height() && "to_grey size mismatch");
+	if constexpr (Layout == image_layout::interleaved) {
+		to_grey(src.pixels(), dst.pixels(), w);
+	} else if constexpr (std::is_same_v<P, grey_pixel>) {
+		if (&src != &dst) {
+			dst = src;
+		}
+	} else if constexpr (std::is_same_v<P, rgb_pixel>) {
+		detail::luma_planes_u8(src.plane(0).data(), src.plane(1).data(), src.plane(2).data(),
+		                       dst.raw().data(), src.size(), w);
+	} else {
+		detail::luma_planes_f32(src.plane(0).data(), src.plane(1).data(), src.plane(2).data(), src.plane(3).data(),
+		                        dst.raw().data(), src.size(), w);
+	}
+}
@@ -0,0 +1,334 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "03_corr_concepts_impl.hpp"
+#include "03_corr_concepts_simd.hpp"
+
+// Compact rgba pixels
+//
+// rgba8_pixel stores the four channels of an rgba_pixel on 8 bits each
+// (4 bytes instead of 16, the level k stands for k / 255) and rgba16f_pixel
+// as IEEE half-precision floats (8 bytes). Both satisfy the pixel concept
+// with the same red() / green() / blue() / alpha() values in [0, 1] as
+// rgba_pixel, and neither checks its channels on construction: every value
+// of rgba8_pixel is valid, and the conversions from float clamp to [0, 1]
+// (NaN gives 0).
+//
+// to_rgba8, to_rgba16f and to_rgba convert single pixels or whole buffers
+// (SIMD: F16C or AVX-512F vcvtps2ph / vcvtph2ps for halves, with a software
+// fallback that rounds to nearest even like them). color_mix and to_grey
+// also take buffers of compact pixels: rgba8_pixel is blended with the
+// 8-bit lerp of grey and rgb pixels, the other operations go through
+// rgba_pixel in small blocks that stay in L1.
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+// Half-precision floats
+//------------------------------------------------------------------------------
+
+// Nearest binary16 (ties to even), overflowing to infinity
+constexpr std::uint16_t float_to_half(float f) {
+	std::uint32_t x = std::bit_cast<std::uint32_t>(f);
+	const auto sign = static_cast<std::uint16_t>((x >> 16) & 0x8000);
+	x &= 0x7fffffff;
+	if (x >= 0x7f800000) {
+		return sign | (x > 0x7f800000 ? 0x7e00 : 0x7c00);
+	}
+	if (x >= 0x477ff000) { // 65520 and above round to infinity
+		return sign | 0x7c00;
+	}
+	if (x < 0x38800000) { // below 2^-14: subnormal, in units of 2^-24
+		// Adding 0.5 (whose ulp is 2^-24) leaves the rounded units in the mantissa
+		const float y = std::bit_cast<float>(x) + 0.5f;
+		return sign | static_cast<std::uint16_t>(std::bit_cast<std::uint32_t>(y) - 0x3f000000);
+	}
+	const std::uint32_t odd = (x >> 13) & 1;
+	x += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfff + odd;
+	return sign | static_cast<std::uint16_t>(x >> 13);
+}
+
+constexpr float half_to_float(std::uint16_t h) {
+	const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000) << 16;
+	const std::uint32_t exponent = (h >> 10) & 0x1f;
+	const std::uint32_t mantissa = h & 0x3ff;
+	if (exponent == 0) {
+		const float v = static_cast<float>(mantissa) * 0x1p-24f;
+		return sign ? -v : v;
+	}
+	if (exponent == 31) {
+		return std::bit_cast<float>(sign | 0x7f800000 | (mantissa << 13));
+	}
+	return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+// x clamped to [0, 1], NaN to 0 (like maxps then minps)
+constexpr float clamp_unit(float x) {
+	return x > 0.f ? (x < 1.f ? x : 1.f) : 0.f;
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// Pixel types
+//------------------------------------------------------------------------------
+
+struct rgba8_pixel {
+	std::uint8_t r, g, b, a;
+};
+
+// Channels as binary16 bit patterns
+struct rgba16f_pixel {
+	std::uint16_t r, g, b, a;
+};
+
+inline float red(rgba8_pixel const& p)   { return p.r / 255.f; }
+inline float green(rgba8_pixel const& p) { return p.g / 255.f; }
+inline float blue(rgba8_pixel const& p)  { return p.b / 255.f; }
+inline float alpha(rgba8_pixel const& p) { return p.a / 255.f; }
+
+inline float red(rgba16f_pixel const& p)   { return detail::clamp_unit(detail::half_to_float(p.r)); }
+inline float green(rgba16f_pixel const& p) { return detail::clamp_unit(detail::half_to_float(p.g)); }
+inline float blue(rgba16f_pixel const& p)  { return detail::clamp_unit(detail::half_to_float(p.b)); }
+inline float alpha(rgba16f_pixel const& p) { return detail::clamp_unit(detail::half_to_float(p.a)); }
+
+static_assert(pixel<rgba8_pixel> && sizeof(rgba8_pixel) == 4);
+static_assert(pixel<rgba16f_pixel> && sizeof(rgba16f_pixel) == 8);
+
+//------------------------------------------------------------------------------
+// Conversions of single pixels
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+inline std::uint8_t unit_to_u8(float x) {
+	return static_cast<std::uint8_t>(std::lrint(clamp_unit(x) * 255.f));
+}
+
+} // namespace detail
+
+inline rgba8_pixel to_rgba8(rgba_pixel p) {
+	return {detail::unit_to_u8(p.red()), detail::unit_to_u8(p.green()), detail::unit_to_u8(p.blue()),
+	        detail::unit_to_u8(p.alpha())};
+}
+
+inline rgba16f_pixel to_rgba16f(rgba_pixel p) {
+	return {detail::float_to_half(p.red()), detail::float_to_half(p.green()), detail::float_to_half(p.blue()),
+	        detail::float_to_half(p.alpha())};
+}
+
+template <typename P>
+	requires(std::is_same_v<P, rgba8_pixel> || std::is_same_v<P, rgba16f_pixel>)
+rgba_pixel to_rgba(P p) {
+	return rgba_pixel{red(p), green(p), blue(p), alpha(p)};
+}
+
+//------------------------------------------------------------------------------
+// Conversion kernels
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+// The AVX-512 paths below use the zero-masked forms of the conversions and of
+// min/max with every lane selected: GCC 12 flags the undefined passthrough of
+// the unmasked forms as maybe-uninitialized wherever they are inlined.
+#if defined(__AVX512F__)
+inline constexpr __mmask16 lanes16 = 0xFFFF;
+#endif
+
+// dst[i] = round(clamp(src[i], 0, 1) * 255)
+inline void unit_to_u8(const float* src, std::uint8_t* dst, std::size_t n) {
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1.f), scale = _mm512_set1_ps(255.f);
+	for (; i + 16 <= n; i += 16) {
+		const __m512 x = _mm512_loadu_ps(src + i);
+		const __m512 c = _mm512_maskz_min_ps(lanes16, _mm512_maskz_max_ps(lanes16, x, zero), one);
+		const __m512i q = _mm512_maskz_cvtps_epi32(lanes16, _mm512_mul_ps(c, scale));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm512_maskz_cvtepi32_epi8(lanes16, q));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.f), scale = _mm_set1_ps(255.f);
+	const auto levels = [&](const float* p) {
+		return _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(p), zero), one), scale));
+	};
+	for (; i + 16 <= n; i += 16) {
+		const __m128i lo = _mm_packs_epi32(levels(src + i), levels(src + i + 4));
+		const __m128i hi = _mm_packs_epi32(levels(src + i + 8), levels(src + i + 12));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; i < n; ++i) {
+		dst[i] = unit_to_u8(src[i]);
+	}
+}
+
+// dst[i] = src[i] / 255
+inline void u8_to_unit(const std::uint8_t* src, float* dst, std::size_t n) {
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	const __m512 scale = _mm512_set1_ps(255.f);
+	for (; i + 16 <= n; i += 16) {
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		const __m512i q = _mm512_maskz_cvtepu8_epi32(lanes16, x);
+		_mm512_storeu_ps(dst + i, _mm512_maskz_div_ps(lanes16, _mm512_maskz_cvtepi32_ps(lanes16, q), scale));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	const __m128 scale = _mm_set1_ps(255.f);
+	const __m128i zero = _mm_setzero_si128();
+	const auto store = [&](float* p, __m128i q) { _mm_storeu_ps(p, _mm_div_ps(_mm_cvtepi32_ps(q), scale)); };
+	for (; i + 16 <= n; i += 16) {
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		const __m128i lo = _mm_unpacklo_epi8(x, zero), hi = _mm_unpackhi_epi8(x, zero);
+		store(dst + i, _mm_unpacklo_epi16(lo, zero));
+		store(dst + i + 4, _mm_unpackhi_epi16(lo, zero));
+		store(dst + i + 8, _mm_unpacklo_epi16(hi, zero));
+		store(dst + i + 12, _mm_unpackhi_epi16(hi, zero));
+	}
+#endif
+	for (; i < n; ++i) {
+		dst[i] = src[i] / 255.f;
+	}
+}
+
+// dst[i] = binary16(src[i])
+inline void float_to_half(const float* src, std::uint16_t* dst, std::size_t n) {
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	for (; i + 16 <= n; i += 16) {
+		const __m256i h =
+			_mm512_maskz_cvtps_ph(lanes16, _mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), h);
+	}
+#elif defined(__F16C__)
+	for (; i + 8 <= n; i += 8) {
+		const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+	}
+#endif
+	for (; i < n; ++i) {
+		dst[i] = float_to_half(src[i]);
+	}
+}
+
+// dst[i] = clamp(float(src[i]), 0, 1)
+inline void half_to_unit(const std::uint16_t* src, float* dst, std::size_t n) {
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1.f);
+	for (; i + 16 <= n; i += 16) {
+		const __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		const __m512 x = _mm512_maskz_cvtph_ps(lanes16, h);
+		_mm512_storeu_ps(dst + i, _mm512_maskz_min_ps(lanes16, _mm512_maskz_max_ps(lanes16, x, zero), one));
+	}
+#elif defined(__F16C__)
+	const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.f);
+	for (; i + 8 <= n; i += 8) {
+		const __m256 x = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+		_mm256_storeu_ps(dst + i, _mm256_min_ps(_mm256_max_ps(x, zero), one));
+	}
+#endif
+	for (; i < n; ++i) {
+		dst[i] = clamp_unit(half_to_float(src[i]));
+	}
+}
+
+template <typename P> auto packed_data(P* p) {
+	using T = std::remove_const_t<P>;
+	using channel = std::conditional_t<std::is_same_v<T, rgba8_pixel>, std::uint8_t, std::uint16_t>;
+	static_assert(std::is_standard_layout_v<T> && sizeof(T) == 4 * sizeof(channel));
+	return reinterpret_cast<std::conditional_t<std::is_const_v<P>, const channel, channel>*>(p);
+}
+
+// Pixels converted through rgba_pixel by blocks of this many
+inline constexpr std::size_t packed_block = 256;
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// Conversions of buffers
+//------------------------------------------------------------------------------
+
+inline void to_rgba8(std::span<const rgba_pixel> src, std::span<rgba8_pixel> dst) {
+	assert(src.size() == dst.size() && "to_rgba8 size mismatch");
+	detail::unit_to_u8(detail::channel_data(src.data()), detail::packed_data(dst.data()), 4 * src.size());
+}
+
+inline void to_rgba16f(std::span<const rgba_pixel> src, std::span<rgba16f_pixel> dst) {
+	assert(src.size() == dst.size() && "to_rgba16f size mismatch");
+	detail::float_to_half(detail::channel_data(src.data()), detail::packed_data(dst.data()), 4 * src.size());
+}
+
+inline void to_rgba(std::span<const rgba8_pixel> src, std::span<rgba_pixel> dst) {
+	assert(src.size() == dst.size() && "to_rgba size mismatch");
+	detail::u8_to_unit(detail::packed_data(src.data()), detail::channel_data(dst.data()), 4 * src.size());
+}
+
+inline void to_rgba(std::span<const rgba16f_pixel> src, std::span<rgba_pixel> dst) {
+	assert(src.size() == dst.size() && "to_rgba size mismatch");
+	detail::half_to_unit(detail::packed_data(src.data()), detail::channel_data(dst.data()), 4 * src.size());
+}
+
+//------------------------------------------------------------------------------
+// Pixel operations on buffers
+//------------------------------------------------------------------------------
+
+inline void color_mix(std::span<const rgba8_pixel> a, std::span<const rgba8_pixel> b, std::span<rgba8_pixel> dst,
+                      float ratio) {
+	assert(a.size() == b.size() && a.size() == dst.size() && "color_mix size mismatch");
+	detail::mix_u8(detail::packed_data(a.data()), detail::packed_data(b.data()), detail::packed_data(dst.data()),
+	               4 * a.size(), detail::mix_weight(ratio));
+}
+
+inline void color_mix(std::span<const rgba16f_pixel> a, std::span<const rgba16f_pixel> b,
+                      std::span<rgba16f_pixel> dst, float ratio) {
+	assert(a.size() == b.size() && a.size() == dst.size() && "color_mix size mismatch");
+	assert(ratio >= 0.f && ratio <= 1.f && "color_mix ratio out of [0, 1]");
+	alignas(64) float x[4 * detail::packed_block], y[4 * detail::packed_block];
+	for (std::size_t i = 0; i < a.size(); i += detail::packed_block) {
+		const std::size_t n = 4 * std::min(detail::packed_block, a.size() - i);
+		detail::half_to_unit(detail::packed_data(a.data() + i), x, n);
+		detail::half_to_unit(detail::packed_data(b.data() + i), y, n);
+		detail::mix_f32(x, y, x, n, ratio);
+		detail::float_to_half(x, detail::packed_data(dst.data() + i), n);
+	}
+}
+
+namespace detail {
+
+// Grey levels of compact rgba pixels, through rgba_pixel by blocks
+template <typename P> void packed_to_grey(std::span<const P> src, std::span<grey_pixel> dst, luma_weights w) {
+	assert(src.size() == dst.size() && "to_grey size mismatch");
+	alignas(64) float x[4 * packed_block];
+	for (std::size_t i = 0; i < src.size(); i += packed_block) {
+		const std::size_t n = std::min(packed_block, src.size() - i);
+		if constexpr (std::is_same_v<P, rgba8_pixel>) {
+			u8_to_unit(packed_data(src.data() + i), x, 4 * n);
+		} else {
+			half_to_unit(packed_data(src.data() + i), x, 4 * n);
+		}
+		luma_f32(x, channel_data(dst.data() + i), n, w);
+	}
+}
+
+} // namespace detail
+
+inline void to_grey(std::span<const rgba8_pixel> src, std::span<grey_pixel> dst, luma_weights w = luma_average) {
+	detail::packed_to_grey(src, dst, w);
+}
+
+inline void to_grey(std::span<const rgba16f_pixel> src, std::span<grey_pixel> dst, luma_weights w = luma_average) {
+	detail::packed_to_grey(src, dst, w);
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "03_corr_concepts_impl.hpp"
+#include "03_corr_concepts_simd.hpp"
+#include "03_corr_concepts_image.hpp"
+#include "03_corr_concepts_packed.hpp"
+#include "01_corr_matvec_thread_pool.hpp"
+
+// Fused pixel pipelines
+//
+// A pipeline chains per-pixel stages and runs them in a single pass over the
+// image:
+//
+//     auto p = pipeline<rgb_pixel>{}
+//                  .color_mix(background.pixels(), 0.75f)
+//                  .map([](rgb_pixel p) { return rgb_pixel{p.r, p.g, 0}; })
+//                  .to_grey(luma_rec709);
+//     p.run(src.pixels(), dst.pixels());
+//
+// color_mix(other, ratio) blends with the pixels of other (which must outlive
+// the pipeline) using the bulk color_mix of the current pixel type, to_grey(w)
+// uses the bulk to_grey, and map(f) applies f to every pixel: f takes the
+// current pixel type and returns any type satisfying pixel, which becomes the
+// input of the next stage.
+//
+// The image is cut into tiles of consecutive pixels whose intermediate results
+// fit in pipeline_tile_bytes. Each tile goes through every stage before the
+// next one starts, the intermediate pixels staying in two buffers on the stack
+// that are reused from tile to tile, so src and dst are read and written once
+// whatever the number of stages. Groups of pipeline_tiles_per_task tiles run as
+// tasks on a thread_pool (run(par, ...), the default) or in order on the
+// calling thread (run(seq, ...)). Every stage works pixel by pixel, so the
+// result does not depend on the policy or on the number of threads, and dst
+// may be src when they have the same type.
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+// Stages
+//------------------------------------------------------------------------------
+
+// Callables turning one pixel P into another pixel
+template <typename F, typename P>
+concept pixel_function = std::regular_invocable<const F&, const P&>
+                         && pixel<std::remove_cvref_t<std::invoke_result_t<const F&, const P&>>>;
+
+// Pixel types with a bulk color_mix
+template <typename P>
+concept bulk_mixable = requires(std::span<const P> a, std::span<P> dst, float ratio) { color_mix(a, a, dst, ratio); };
+
+struct grey_stage {
+	luma_weights weights;
+
+	template <typename In> using output = grey_pixel;
+
+	bool accepts(std::size_t) const { return true; }
+
+	template <typename In> void operator()(std::span<const In> in, std::span<grey_pixel> out, std::size_t) const {
+		to_grey(in, out, weights);
+	}
+};
+
+template <typename P> struct mix_stage {
+	std::span<const P> other;
+	float ratio;
+
+	template <typename In> using output = P;
+
+	bool accepts(std::size_t n) const { return other.size() == n; }
+
+	// in and out are pixels [first, first + in.size()) of the image
+	void operator()(std::span<const P> in, std::span<P> out, std::size_t first) const {
+		color_mix(in, other.subspan(first, in.size()), out, ratio);
+	}
+};
+
+template <typename F> struct map_stage {
+	F fn;
+
+	template <typename In> using output = std::remove_cvref_t<std::invoke_result_t<const F&, const In&>>;
+
+	bool accepts(std::size_t) const { return true; }
+
+	template <typename In, typename Out> void operator()(std::span<const In> in, std::span<Out> out, std::size_t) const {
+		for (std::size_t i = 0; i < in.size(); ++i) {
+			out[i] = std::invoke(fn, in[i]);
+		}
+	}
+};
+
+//------------------------------------------------------------------------------
+// Pixel types along the stages
+//------------------------------------------------------------------------------
+
+// Pixels coming out of the last stage
+template <typename P, typename... Stages> struct stage_output {
+	using type = P;
+};
+
+template <typename P, typename S, typename... Rest>
+struct stage_output<P, S, Rest...> : stage_output<typename S::template output<P>, Rest...> {};
+
+// Largest pixel passed from one stage to the next (1 when there are none)
+template <typename P, typename... Stages> struct intermediate_size : std::integral_constant<std::size_t, 1> {};
+
+template <typename P, typename S, typename T, typename... Rest> struct intermediate_size<P, S, T, Rest...> {
+	using mid = typename S::template output<P>;
+	// Intermediate pixels live in raw stack buffers
+	static_assert(std::is_trivially_copyable_v<mid> && std::is_trivially_destructible_v<mid>,
+	              "pipeline stages must produce trivially copyable pixels");
+	static_assert(alignof(mid) <= image_alignment, "pipeline pixel over-aligned");
+
+	static constexpr std::size_t value = std::max(sizeof(mid), intermediate_size<mid, T, Rest...>::value);
+};
+
+//------------------------------------------------------------------------------
+// Tiling
+//------------------------------------------------------------------------------
+
+// Bytes of one intermediate tile, and tiles run by one task
+inline constexpr std::size_t pipeline_tile_bytes = 16384;
+inline constexpr std::size_t pipeline_tiles_per_task = 16;
+
+// Pixels of a tile: a multiple of 64 so that the bulk kernels run on whole
+// vectors, with the largest pixel of the pipeline filling pipeline_tile_bytes
+template <std::size_t PixelSize> constexpr std::size_t tile_pixels() {
+	return std::max<std::size_t>(pipeline_tile_bytes / PixelSize / 64 * 64, 64);
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// pipeline
+//------------------------------------------------------------------------------
+
+template <pixel P, typename... Stages> class pipeline {
+	public:
+	using input_type = P;
+	using output_type = typename detail::stage_output<P, Stages...>::type;
+
+	pipeline()
+		requires(sizeof...(Stages) == 0)
+	= default;
+
+	explicit pipeline(std::tuple<Stages...> stages) : stages_(std::move(stages)) {}
+
+	//--------------------------------------------------------------------------
+	// Stages
+	//--------------------------------------------------------------------------
+
+	// output = output * ratio + other * (1 - ratio), pixel by pixel
+	auto color_mix(std::span<const output_type> other, float ratio) const
+		requires detail::bulk_mixable<output_type>
+	{
+		return then(detail::mix_stage<output_type>{other, ratio});
+	}
+
+	auto to_grey(luma_weights w = luma_average) const { return then(detail::grey_stage{w}); }
+
+	template <detail::pixel_function<output_type> F> auto map(F fn) const {
+		return then(detail::map_stage<F>{std::move(fn)});
+	}
+
+	//--------------------------------------------------------------------------
+	// Execution
+	//--------------------------------------------------------------------------
+
+	// dst must be src or not overlap it
+	void run(execution::sequenced_policy, std::span<const P> src, std::span<output_type> dst) const {
+		check(src, dst);
+		run_range(src, dst, 0, src.size());
+	}
+
+	void run(execution::parallel_policy policy, std::span<const P> src, std::span<output_type> dst) const {
+		check(src, dst);
+		const std::size_t tasks = (src.size() + task_pixels - 1) / task_pixels;
+		policy.executor().parallel_for(tasks, [&](std::size_t t) {
+			const std::size_t first = t * task_pixels;
+			run_range(src, dst, first, std::min(task_pixels, src.size() - first));
+		});
+	}
+
+	void run(std::span<const P> src, std::span<output_type> dst) const { run(execution::par, src, dst); }
+
+	// Interleaved images of the same size
+	template <typename Policy, image_layout Layout>
+		requires(Layout == image_layout::interleaved)
+	void run(Policy policy, const image<P, Layout>& src, image<output_type, Layout>& dst) const {
+		assert(src.width() == dst.width() && src.height() == dst.height() && "pipeline image size mismatch");
+		run(policy, src.pixels(), dst.pixels());
+	}
+
+	template <image_layout Layout>
+		requires(Layout == image_layout::interleaved)
+	void run(const image<P, Layout>& src, image<output_type, Layout>& dst) const {
+		run(execution::par, src, dst);
+	}
+
+	private:
+	static constexpr std::size_t stage_count = sizeof...(Stages);
+	static constexpr std::size_t scratch_pixel = detail::intermediate_size<P, Stages...>::value;
+	static constexpr std::size_t tile_pixels =
+		detail::tile_pixels<std::max({scratch_pixel, sizeof(P), sizeof(output_type)})>();
+	static constexpr std::size_t task_pixels = tile_pixels * detail::pipeline_tiles_per_task;
+	static constexpr std::size_t scratch_bytes = tile_pixels * scratch_pixel;
+
+	template <typename S> pipeline<P, Stages..., S> then(S stage) const {
+		return pipeline<P, Stages..., S>(std::tuple_cat(stages_, std::tuple<S>(std::move(stage))));
+	}
+
+	void check(std::span<const P> src, std::span<output_type> dst) const {
+		assert(src.size() == dst.size() && "pipeline size mismatch");
+		assert(std::apply([&](const auto&... s) { return (s.accepts(src.size()) && ...); }, stages_)
+		       && "pipeline stage size mismatch");
+		(void)src;
+		(void)dst;
+	}
+
+	// Pixels [first, first + count) tile by tile
+	void run_range(std::span<const P> src, std::span<output_type> dst, std::size_t first, std::size_t count) const {
+		if constexpr (stage_count == 0) {
+			if (src.data() != dst.data()) {
+				std::copy_n(src.data() + first, count, dst.data() + first);
+			}
+		} else {
+			// Two intermediate tiles, unused with a single stage
+			alignas(detail::image_alignment) std::byte scratch[stage_count > 1 ? 2 * scratch_bytes : 1];
+			for (std::size_t i = first; i < first + count; i += tile_pixels) {
+				const std::size_t n = std::min(tile_pixels, first + count - i);
+				run_stages<0>(src.subspan(i, n), dst.subspan(i, n), i, scratch);
+			}
+		}
+	}
+
+	// Stage I on the tile in, then the next ones into out
+	template <std::size_t I, typename In>
+	void run_stages(std::span<const In> in, std::span<output_type> out, std::size_t first, std::byte* scratch) const {
+		using stage_type = std::tuple_element_t<I, std::tuple<Stages...>>;
+		const stage_type& stage = std::get<I>(stages_);
+		if constexpr (I + 1 == stage_count) {
+			stage(in, out, first);
+		} else {
+			using mid_type = typename stage_type::template output<In>;
+			const std::span<mid_type> mid(reinterpret_cast<mid_type*>(scratch + I % 2 * scratch_bytes), in.size());
+			stage(in, mid, first);
+			run_stages<I + 1>(std::span<const mid_type>(mid), out, first, scratch);
+		}
+	}
+
+	std::tuple<Stages...> stages_;
+};
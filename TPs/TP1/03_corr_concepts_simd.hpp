@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "03_corr_concepts_impl.hpp"
+
+// Bulk pixel kernels over whole buffers
+//
+// color_mix(a, b, dst, ratio) blends two images pixel by pixel, like the
+// per-pixel color_mix: dst[i] = a[i] * ratio + b[i] * (1 - ratio). dst may be
+// a or b.
+//
+// grey_pixel and rgb_pixel images are blended as flat byte streams with 8-bit
+// fixed-point weights: w = round(ratio * 256) and
+//     dst = (a * w + b * (256 - w) + 128) >> 8
+// computed exactly in unsigned 16-bit lanes (the sum is at most 255 * 256 +
+// 128). The result is rounded to nearest, so it is within 1 of the per-pixel
+// version, which truncates. rgba_pixel images are blended in float with the
+// same expression as the per-pixel version.
+//
+// to_grey(src, dst, weights) converts a whole image to grey_pixel with the
+// luma weights of luma_average (the per-pixel to_grey), luma_rec601 or
+// luma_rec709. The conversion is chosen at compile time from the pixel type:
+// grey_pixel is copied, rgb_pixel goes through a fixed-point weighted sum
+// (weights rounded to multiples of 2^-14: the result is within 0.53 of the
+// exact weighted sum), and rgba_pixel through a float weighted sum scaled to
+// [0, 255] and multiplied by alpha (the per-pixel to_grey truncates these
+// [0, 1] channels to 0). Other pixel types fall back to the per-pixel to_grey.
+//
+// The instruction set is selected at compile time (AVX-512BW, AVX2 then SSE2;
+// AVX-512 VBMI or SSSE3 for the rgb deinterleaving) from the target flags,
+// with a scalar loop for the tail and other targets.
+
+// Weights of red, green and blue in a grey level, summing to 1
+struct luma_weights {
+	float r, g, b;
+};
+
+inline constexpr luma_weights luma_average{1.f / 3, 1.f / 3, 1.f / 3};
+inline constexpr luma_weights luma_rec601{0.299f, 0.587f, 0.114f};
+inline constexpr luma_weights luma_rec709{0.2126f, 0.7152f, 0.0722f};
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+// Raw channel access
+//------------------------------------------------------------------------------
+
+// Channel type and count of the pixels stored as plain channel arrays
+template <typename P> struct pixel_layout;
+
+template <> struct pixel_layout<grey_pixel> {
+	using channel = std::uint8_t;
+	static constexpr std::size_t channels = 1;
+};
+
+template <> struct pixel_layout<rgb_pixel> {
+	using channel = std::uint8_t;
+	static constexpr std::size_t channels = 3;
+};
+
+template <> struct pixel_layout<rgba_pixel> {
+	using channel = float;
+	static constexpr std::size_t channels = 4;
+};
+
+// Channels of contiguous pixels, in memory order
+template <typename P> auto channel_data(P* p) {
+	using layout = pixel_layout<std::remove_const_t<P>>;
+	using channel = std::conditional_t<std::is_const_v<P>, const typename layout::channel, typename layout::channel>;
+	static_assert(std::is_standard_layout_v<std::remove_const_t<P>>
+	              && sizeof(P) == layout::channels * sizeof(typename layout::channel));
+	return reinterpret_cast<channel*>(p);
+}
+
+//------------------------------------------------------------------------------
+// 8-bit lerp
+//------------------------------------------------------------------------------
+
+// ratio in [0, 1] as a weight out of 256
+inline std::uint16_t mix_weight(float ratio) {
+	assert(ratio >= 0.f && ratio <= 1.f && "color_mix ratio out of [0, 1]");
+	return static_cast<std::uint16_t>(std::lround(ratio * 256.f));
+}
+
+// dst[i] = (a[i] * w + b[i] * (256 - w) + 128) >> 8
+inline void mix_u8(const std::uint8_t* a, const std::uint8_t* b, std::uint8_t* dst, std::size_t n, std::uint16_t w) {
+	const std::uint16_t v = 256 - w;
+	std::size_t i = 0;
+#if defined(__AVX512BW__)
+	const __m512i wa = _mm512_set1_epi16(static_cast<short>(w));
+	const __m512i wb = _mm512_set1_epi16(static_cast<short>(v));
+	const __m512i half = _mm512_set1_epi16(128);
+	for (; i + 32 <= n; i += 32) {
+		const __m512i x = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+		const __m512i y = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+		__m512i r = _mm512_add_epi16(_mm512_mullo_epi16(x, wa), _mm512_mullo_epi16(y, wb));
+		r = _mm512_srli_epi16(_mm512_add_epi16(r, half), 8);
+		// Zero-masked: GCC 12 flags the undefined passthrough of the unmasked
+		// narrowing as maybe-uninitialized
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm512_maskz_cvtepi16_epi8(0xFFFFFFFF, r));
+	}
+#elif defined(__AVX2__)
+	const __m256i wa = _mm256_set1_epi16(static_cast<short>(w));
+	const __m256i wb = _mm256_set1_epi16(static_cast<short>(v));
+	const __m256i half = _mm256_set1_epi16(128);
+	for (; i + 16 <= n; i += 16) {
+		const __m256i x = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+		const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+		__m256i r = _mm256_add_epi16(_mm256_mullo_epi16(x, wa), _mm256_mullo_epi16(y, wb));
+		r = _mm256_srli_epi16(_mm256_add_epi16(r, half), 8);
+		const __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	const __m128i wa = _mm_set1_epi16(static_cast<short>(w));
+	const __m128i wb = _mm_set1_epi16(static_cast<short>(v));
+	const __m128i half = _mm_set1_epi16(128);
+	const __m128i zero = _mm_setzero_si128();
+	const auto lerp = [&](__m128i x, __m128i y) {
+		const __m128i r = _mm_add_epi16(_mm_mullo_epi16(x, wa), _mm_mullo_epi16(y, wb));
+		return _mm_srli_epi16(_mm_add_epi16(r, half), 8);
+	};
+	for (; i + 16 <= n; i += 16) {
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+		const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+		const __m128i lo = lerp(_mm_unpacklo_epi8(x, zero), _mm_unpacklo_epi8(y, zero));
+		const __m128i hi = lerp(_mm_unpackhi_epi8(x, zero), _mm_unpackhi_epi8(y, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; i < n; ++i) {
+		dst[i] = static_cast<std::uint8_t>((a[i] * w + b[i] * v + 128) >> 8);
+	}
+}
+
+//------------------------------------------------------------------------------
+// float lerp
+//------------------------------------------------------------------------------
+
+// dst[i] = a[i] * ratio + b[i] * (1 - ratio)
+inline void mix_f32(const float* a, const float* b, float* dst, std::size_t n, float ratio) {
+	const float complement = 1.f - ratio;
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	const __m512 r = _mm512_set1_ps(ratio);
+	const __m512 c = _mm512_set1_ps(complement);
+	for (; i + 16 <= n; i += 16) {
+		const __m512 x = _mm512_mul_ps(_mm512_loadu_ps(a + i), r);
+		const __m512 y = _mm512_mul_ps(_mm512_loadu_ps(b + i), c);
+		_mm512_storeu_ps(dst + i, _mm512_add_ps(x, y));
+	}
+#elif defined(__AVX__)
+	const __m256 r = _mm256_set1_ps(ratio);
+	const __m256 c = _mm256_set1_ps(complement);
+	for (; i + 8 <= n; i += 8) {
+		const __m256 x = _mm256_mul_ps(_mm256_loadu_ps(a + i), r);
+		const __m256 y = _mm256_mul_ps(_mm256_loadu_ps(b + i), c);
+		_mm256_storeu_ps(dst + i, _mm256_add_ps(x, y));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	const __m128 r = _mm_set1_ps(ratio);
+	const __m128 c = _mm_set1_ps(complement);
+	for (; i + 4 <= n; i += 4) {
+		const __m128 x = _mm_mul_ps(_mm_loadu_ps(a + i), r);
+		const __m128 y = _mm_mul_ps(_mm_loadu_ps(b + i), c);
+		_mm_storeu_ps(dst + i, _mm_add_ps(x, y));
+	}
+#endif
+	for (; i < n; ++i) {
+		dst[i] = a[i] * ratio + b[i] * complement;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Weighted sums of channels
+//------------------------------------------------------------------------------
+
+// Byte and lane indices for the deinterleaving shuffles
+struct deinterleave_indices {
+	// pshufb masks: rgb_ssse3[c][k] gathers channel c of 16 rgb pixels from the
+	// k-th of the three 16-byte loads covering them (-128 zeroes a byte)
+	alignas(16) std::int8_t rgb_ssse3[3][3][16];
+	// vpermb indices: rgb_vbmi[h] spreads rgb pixels 8h to 8h + 7 of a 48-byte
+	// load to the low byte of int16 lanes, 4 lanes (r, g, b, 0) per pixel
+	alignas(64) std::uint8_t rgb_vbmi[2][64];
+	// vpermt2ps indices: rgba_pairs[p] takes channels 2p and 2p + 1 of 8
+	// rgba pixels, rgba_halves[q] the low (q = 0) or high halves of two such
+	// registers
+	alignas(64) std::int32_t rgba_pairs[2][16];
+	alignas(64) std::int32_t rgba_halves[2][16];
+};
+
+constexpr deinterleave_indices make_deinterleave_indices() {
+	deinterleave_indices result{};
+	for (int c = 0; c < 3; ++c) {
+		for (int k = 0; k < 3; ++k) {
+			for (int j = 0; j < 16; ++j) {
+				const int byte = 3 * j + c - 16 * k;
+				result.rgb_ssse3[c][k][j] = static_cast<std::int8_t>(byte >= 0 && byte < 16 ? byte : -128);
+			}
+		}
+	}
+	for (int h = 0; h < 2; ++h) {
+		for (int j = 0; j < 8; ++j) {
+			for (int c = 0; c < 4; ++c) {
+				result.rgb_vbmi[h][8 * j + 2 * c] = static_cast<std::uint8_t>(c < 3 ? 24 * h + 3 * j + c : 0);
+			}
+		}
+	}
+	for (int j = 0; j < 16; ++j) {
+		result.rgba_pairs[0][j] = 4 * (j % 8) + j / 8;
+		result.rgba_pairs[1][j] = 4 * (j % 8) + j / 8 + 2;
+		result.rgba_halves[0][j] = j < 8 ? j : j + 8;
+		result.rgba_halves[1][j] = j < 8 ? j + 8 : j + 16;
+	}
+	return result;
+}
+
+inline constexpr deinterleave_indices deinterleave = make_deinterleave_indices();
+
+// Luma weights in multiples of 2^-14, wg taking the rounding error so that
+// they still sum to 1 and white stays white
+inline constexpr int luma_fixed_one = 1 << 14;
+
+struct luma_fixed {
+	std::int16_t r, g, b;
+};
+
+inline luma_fixed luma_fixed_weights(luma_weights w) {
+	assert(w.r >= 0.f && w.g >= 0.f && w.b >= 0.f && std::abs(w.r + w.g + w.b - 1.f) < 1e-3f
+	       && "luma weights must be non-negative and sum to 1");
+	const auto r = static_cast<std::int16_t>(std::lround(w.r * luma_fixed_one));
+	const auto b = static_cast<std::int16_t>(std::lround(w.b * luma_fixed_one));
+	return {r, static_cast<std::int16_t>(luma_fixed_one - r - b), b};
+}
+
+// dst[i] = (r * wr + g * wg + b * wb + 2^13) >> 14 for the n rgb triples of
+// src, with the weights of luma_fixed_weights
+inline void luma_u8(const std::uint8_t* src, std::uint8_t* dst, std::size_t n, luma_weights w) {
+	constexpr int one = luma_fixed_one;
+	const auto [wr, wg, wb] = luma_fixed_weights(w);
+	std::size_t i = 0;
+#if defined(__AVX512VBMI__) && defined(__AVX512BW__)
+	// Each pixel becomes 4 int16 lanes (r, g, b, 0): pmaddwd with (wr, wg, wb,
+	// 0) leaves r * wr + g * wg and b * wb in its two int32 halves
+	const __m512i weights = _mm512_set1_epi64(static_cast<std::uint16_t>(wr)
+	                                          | (static_cast<std::int64_t>(static_cast<std::uint16_t>(wg)) << 16)
+	                                          | (static_cast<std::int64_t>(static_cast<std::uint16_t>(wb)) << 32));
+	const __m512i half = _mm512_set1_epi32(one / 2);
+	const __m512i spread[2] = {_mm512_load_si512(deinterleave.rgb_vbmi[0]), _mm512_load_si512(deinterleave.rgb_vbmi[1])};
+	constexpr __mmask64 channel_bytes = 0x1515151515151515;
+	// 8 grey levels in the low bytes of int64 lanes. The shifts and the
+	// narrowing are zero-masked: GCC 12 flags the undefined passthrough of
+	// the unmasked forms as maybe-uninitialized.
+	const auto weigh = [&](__m512i x, __m512i idx) {
+		const __m512i y = _mm512_madd_epi16(_mm512_maskz_permutexvar_epi8(channel_bytes, idx, x), weights);
+		const __m512i t = _mm512_add_epi32(y, _mm512_maskz_srli_epi64(0xFF, y, 32));
+		return _mm512_maskz_cvtepi64_epi8(0xFF, _mm512_maskz_srli_epi32(0xFFFF, _mm512_add_epi32(t, half), 14));
+	};
+	for (; i + 16 <= n; i += 16) {
+		const __m512i x = _mm512_maskz_loadu_epi8((__mmask64{1} << 48) - 1, src + 3 * i);
+		const __m128i y = _mm_unpacklo_epi64(weigh(x, spread[0]), weigh(x, spread[1]));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), y);
+	}
+#elif defined(__SSSE3__)
+	// pmaddwd on (r, g) pairs and on (b, 1) pairs, the second weight of which
+	// adds the rounding term
+	const __m128i wrg = _mm_set1_epi32(static_cast<std::uint16_t>(wr) | (static_cast<std::int32_t>(wg) << 16));
+	const __m128i wbh = _mm_set1_epi32(static_cast<std::uint16_t>(wb) | ((one / 2) << 16));
+	const __m128i ones = _mm_set1_epi16(1);
+	const __m128i zero = _mm_setzero_si128();
+	// 4 grey levels in int32 lanes from 4 pixels of int16 channels (low halves)
+	// or the next 4 (high halves)
+	const auto weigh = [&]<bool high>(__m128i r, __m128i g, __m128i b, std::bool_constant<high>) {
+		__m128i rg, bh;
+		if constexpr (high) {
+			rg = _mm_unpackhi_epi16(r, g);
+			bh = _mm_unpackhi_epi16(b, ones);
+		} else {
+			rg = _mm_unpacklo_epi16(r, g);
+			bh = _mm_unpacklo_epi16(b, ones);
+		}
+		return _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(rg, wrg), _mm_madd_epi16(bh, wbh)), 14);
+	};
+	// 8 grey levels in int16 lanes from 8 pixels of int16 channels
+	const auto weigh8 = [&](__m128i r, __m128i g, __m128i b) {
+		return _mm_packs_epi32(weigh(r, g, b, std::false_type{}), weigh(r, g, b, std::true_type{}));
+	};
+	for (; i + 16 <= n; i += 16) {
+		__m128i x[3];
+		for (int k = 0; k < 3; ++k) {
+			x[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i + 16 * k));
+		}
+		__m128i c[3];
+		for (int ch = 0; ch < 3; ++ch) {
+			const auto* m = reinterpret_cast<const __m128i*>(deinterleave.rgb_ssse3[ch]);
+			c[ch] = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x[0], _mm_load_si128(m)),
+			                                  _mm_shuffle_epi8(x[1], _mm_load_si128(m + 1))),
+			                     _mm_shuffle_epi8(x[2], _mm_load_si128(m + 2)));
+		}
+		const __m128i lo = weigh8(_mm_unpacklo_epi8(c[0], zero), _mm_unpacklo_epi8(c[1], zero),
+		                          _mm_unpacklo_epi8(c[2], zero));
+		const __m128i hi = weigh8(_mm_unpackhi_epi8(c[0], zero), _mm_unpackhi_epi8(c[1], zero),
+		                          _mm_unpackhi_epi8(c[2], zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; i < n; ++i) {
+		const std::uint8_t* p = src + 3 * i;
+		dst[i] = static_cast<std::uint8_t>((p[0] * wr + p[1] * wg + p[2] * wb + one / 2) >> 14);
+	}
+}
+
+// dst[i] = round(255 * a * (r * wr + g * wg + b * wb)) for the n rgba
+// quadruples of src
+inline void luma_f32(const float* src, std::uint8_t* dst, std::size_t n, luma_weights w) {
+	std::size_t i = 0;
+#if defined(__AVX512F__)
+	const __m512 vr = _mm512_set1_ps(w.r);
+	const __m512 vg = _mm512_set1_ps(w.g);
+	const __m512 vb = _mm512_set1_ps(w.b);
+	const __m512 scale = _mm512_set1_ps(255.f);
+	const __m512i pairs[2] = {_mm512_load_si512(deinterleave.rgba_pairs[0]),
+	                          _mm512_load_si512(deinterleave.rgba_pairs[1])};
+	const __m512i halves[2] = {_mm512_load_si512(deinterleave.rgba_halves[0]),
+	                           _mm512_load_si512(deinterleave.rgba_halves[1])};
+	for (; i + 16 <= n; i += 16) {
+		const float* p = src + 4 * i;
+		const __m512 x0 = _mm512_loadu_ps(p), x1 = _mm512_loadu_ps(p + 16);
+		const __m512 x2 = _mm512_loadu_ps(p + 32), x3 = _mm512_loadu_ps(p + 48);
+		// (r, g) and (b, a) of pixels 0 to 7, then of pixels 8 to 15
+		const __m512 rg0 = _mm512_permutex2var_ps(x0, pairs[0], x1), ba0 = _mm512_permutex2var_ps(x0, pairs[1], x1);
+		const __m512 rg1 = _mm512_permutex2var_ps(x2, pairs[0], x3), ba1 = _mm512_permutex2var_ps(x2, pairs[1], x3);
+		const __m512 r = _mm512_permutex2var_ps(rg0, halves[0], rg1), g = _mm512_permutex2var_ps(rg0, halves[1], rg1);
+		const __m512 b = _mm512_permutex2var_ps(ba0, halves[0], ba1), a = _mm512_permutex2var_ps(ba0, halves[1], ba1);
+		__m512 y = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(r, vr), _mm512_mul_ps(g, vg)), _mm512_mul_ps(b, vb));
+		y = _mm512_mul_ps(_mm512_mul_ps(y, a), scale);
+		// Zero-masked conversions, for the same reason as in luma_u8
+		const __m512i q = _mm512_maskz_cvtps_epu32(0xFFFF, y);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm512_maskz_cvtusepi32_epi8(0xFFFF, q));
+	}
+#elif defined(__AVX__)
+	const __m256 vr = _mm256_set1_ps(w.r);
+	const __m256 vg = _mm256_set1_ps(w.g);
+	const __m256 vb = _mm256_set1_ps(w.b);
+	const __m256 scale = _mm256_set1_ps(255.f);
+	for (; i + 8 <= n; i += 8) {
+		// Pixels k and k + 4 in the two lanes of x[k], transposed lane by lane
+		__m256 x[4];
+		for (int k = 0; k < 4; ++k) {
+			x[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 4 * (i + k))),
+			                            _mm_loadu_ps(src + 4 * (i + k + 4)), 1);
+		}
+		const __m256 t0 = _mm256_unpacklo_ps(x[0], x[1]), t1 = _mm256_unpacklo_ps(x[2], x[3]);
+		const __m256 t2 = _mm256_unpackhi_ps(x[0], x[1]), t3 = _mm256_unpackhi_ps(x[2], x[3]);
+		const __m256 r = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 g = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 b = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 a = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r, vr), _mm256_mul_ps(g, vg)), _mm256_mul_ps(b, vb));
+		y = _mm256_mul_ps(_mm256_mul_ps(y, a), scale);
+		const __m256i q = _mm256_cvtps_epi32(y);
+		const __m128i q16 = _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extractf128_si256(q, 1));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(q16, q16));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	const __m128 vr = _mm_set1_ps(w.r);
+	const __m128 vg = _mm_set1_ps(w.g);
+	const __m128 vb = _mm_set1_ps(w.b);
+	const __m128 scale = _mm_set1_ps(255.f);
+	for (; i + 4 <= n; i += 4) {
+		__m128 r = _mm_loadu_ps(src + 4 * i);
+		__m128 g = _mm_loadu_ps(src + 4 * i + 4);
+		__m128 b = _mm_loadu_ps(src + 4 * i + 8);
+		__m128 a = _mm_loadu_ps(src + 4 * i + 12);
+		_MM_TRANSPOSE4_PS(r, g, b, a);
+		__m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r, vr), _mm_mul_ps(g, vg)), _mm_mul_ps(b, vb));
+		y = _mm_mul_ps(_mm_mul_ps(y, a), scale);
+		__m128i q = _mm_cvtps_epi32(y);
+		q = _mm_packus_epi16(_mm_packs_epi32(q, q), q);
+		const std::int32_t bytes = _mm_cvtsi128_si32(q);
+		std::memcpy(dst + i, &bytes, sizeof(bytes));
+	}
+#endif
+	for (; i < n; ++i) {
+		const float* p = src + 4 * i;
+		const float y = (p[0] * w.r + p[1] * w.g + p[2] * w.b) * p[3] * 255.f;
+		dst[i] = static_cast<std::uint8_t>(std::clamp(std::lrint(y), 0l, 255l));
+	}
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// color_mix over buffers
+//------------------------------------------------------------------------------
+
+inline void color_mix(std::span<const grey_pixel> a, std::span<const grey_pixel> b, std::span<grey_pixel> dst,
+                      float ratio) {
+	assert(a.size() == b.size() && a.size() == dst.size() && "color_mix size mismatch");
+	detail::mix_u8(detail::channel_data(a.data()), detail::channel_data(b.data()), detail::channel_data(dst.data()),
+	               a.size(), detail::mix_weight(ratio));
+}
+
+inline void color_mix(std::span<const rgb_pixel> a, std::span<const rgb_pixel> b, std::span<rgb_pixel> dst,
+                      float ratio) {
+	assert(a.size() == b.size() && a.size() == dst.size() && "color_mix size mismatch");
+	detail::mix_u8(detail::channel_data(a.data()), detail::channel_data(b.data()), detail::channel_data(dst.data()),
+	               detail::pixel_layout<rgb_pixel>::channels * a.size(), detail::mix_weight(ratio));
+}
+
+inline void color_mix(std::span<const rgba_pixel> a, std::span<const rgba_pixel> b, std::span<rgba_pixel> dst,
+                      float ratio) {
+	assert(a.size() == b.size() && a.size() == dst.size() && "color_mix size mismatch");
+	assert(ratio >= 0.f && ratio <= 1.f && "color_mix ratio out of [0, 1]");
+	detail::mix_f32(detail::channel_data(a.data()), detail::channel_data(b.data()), detail::channel_data(dst.data()),
+	                detail::pixel_layout<rgba_pixel>::channels * a.size(), ratio);
+}
+
+//------------------------------------------------------------------------------
+// to_grey over buffers
+//------------------------------------------------------------------------------
+
+// dst must be src (grey_pixel images) or not overlap it
+template <pixel P> void to_grey(std::span<const P> src, std::span<grey_pixel> dst, luma_weights w = luma_average) {
+	assert(src.size() == dst.size() && "to_grey size mismatch");
+	if constexpr (std::is_same_v<P, grey_pixel>) {
+		if (!src.empty() && src.data() != dst.data()) {
+			std::memcpy(dst.data(), src.data(), src.size_bytes());
+		}
+	} else if constexpr (std::is_same_v<P, rgb_pixel>) {
+		detail::luma_u8(detail::channel_data(src.data()), detail::channel_data(dst.data()), src.size(), w);
+	} else if constexpr (std::is_same_v<P, rgba_pixel>) {
+		detail::luma_f32(detail::channel_data(src.data()), detail::channel_data(dst.data()), src.size(), w);
+	} else {
+		for (std::size_t i = 0; i < src.size(); ++i) {
+			dst[i] = to_grey(src[i]);
+		}
+	}
+}
+
+// Any contiguous range of pixels, e.g. a std::vector
+template <std::ranges::contiguous_range R>
+	requires pixel<std::ranges::range_value_t<R>>
+void to_grey(const R& src, std::span<grey_pixel> dst, luma_weights w = luma_average) {
+	to_grey(std::span<const std::ranges::range_value_t<R>>(std::ranges::data(src), std::ranges::size(src)), dst, w);
+}